@@ -16,8 +16,7 @@ bool AccessControlDescriptor::unpack(Common::ReadStream& stream)
             return false;
         }
 
-        privateData.resize(nstream.leftBytes());
-        nstream.read(privateData.data(), nstream.leftBytes());
+        privateData = nstream.getSpan(nstream.leftBytes());
 
         stream.skip(descriptorLength);
     }
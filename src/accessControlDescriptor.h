@@ -1,5 +1,6 @@
 #pragma once
 #include "mmtDescriptorBase.h"
+#include <span>
 #include "mmtGeneralLocationInfo.h"
 #include <list>
 
@@ -12,7 +13,7 @@ public:
     
     uint16_t caSystemId;
     MmtGeneralLocationInfo locationInfo;
-    std::vector<uint8_t> privateData;
+    std::span<const uint8_t> privateData;
 };
 
 }
\ No newline at end of file
@@ -1,5 +1,8 @@
 #include "adtsConverter.h"
-#include "stream.h"
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include "swap.h"
 
 static inline int convertAdtsAudioObjectType(int aot)
 {
@@ -11,7 +14,90 @@ static inline int convertAdtsAudioObjectType(int aot)
     }
 }
 
-bool ADTSConverter::convert(uint8_t* input, size_t size, std::vector<uint8_t>& output)
+namespace {
+
+    // Copies size bytes of a payload that starts 5 bits into source:
+    // destination[k] = source[k] << 5 | source[k + 1] >> 3, reading source up to source[size].
+    // Eight bytes are shifted at a time as one big-endian word.
+    void shiftPayload(uint8_t* destination, const uint8_t* source, size_t size)
+    {
+        while (size >= 8) {
+            uint64_t word;
+            memcpy(&word, source, sizeof(word));
+            word = MmtTlv::Common::swapEndian64(word) << 5 | source[8] >> 3;
+            word = MmtTlv::Common::swapEndian64(word);
+            memcpy(destination, &word, sizeof(word));
+
+            source += 8;
+            destination += 8;
+            size -= 8;
+        }
+
+        for (size_t k = 0; k < size; k++) {
+            destination[k] = static_cast<uint8_t>(source[k] << 5 | source[k + 1] >> 3);
+        }
+    }
+
+    // Writes fields MSB first into a zeroed buffer
+    class BitWriter {
+    public:
+        explicit BitWriter(uint8_t* buffer)
+            : buffer(buffer) {
+        }
+
+        void put(uint32_t value, int bits) {
+            while (bits--) {
+                if ((value >> bits) & 1) {
+                    buffer[position >> 3] |= 0x80 >> (position & 7);
+                }
+                position++;
+            }
+        }
+
+        void byteAlign() {
+            position = (position + 7) & ~size_t{ 7 };
+        }
+
+        size_t getSize() const { return (position + 7) >> 3; }
+
+    private:
+        uint8_t* buffer;
+        size_t position{ 0 };
+    };
+
+    struct SyntacticElement {
+        bool isCpe;
+        uint8_t tag;
+    };
+
+    // Syntactic elements of the 22.2ch channel configuration (ISO/IEC 14496-3 channelConfiguration 13),
+    // grouped by position for the program_config_element. The elements appear in the raw_data_block
+    // as SCE CPE CPE CPE CPE SCE LFE LFE SCE CPE CPE SCE CPE SCE SCE CPE, numbered per element type.
+    constexpr SyntacticElement k22_2chFrontElements[] = {
+        { false, 0 },   // FC
+        { true, 0 },    // FLc, FRc
+        { true, 1 },    // FL, FR
+        { false, 2 },   // TpFC
+        { true, 4 },    // TpFL, TpFR
+        { false, 5 },   // BtFC
+        { true, 7 },    // BtFL, BtFR
+    };
+    constexpr SyntacticElement k22_2chSideElements[] = {
+        { true, 2 },    // SiL, SiR
+        { true, 5 },    // TpSiL, TpSiR
+        { false, 3 },   // TpC
+    };
+    constexpr SyntacticElement k22_2chBackElements[] = {
+        { true, 3 },    // BL, BR
+        { false, 1 },   // BC
+        { true, 6 },    // TpBL, TpBR
+        { false, 4 },   // TpBC
+    };
+    constexpr uint8_t k22_2chLfeTags[] = { 0, 1 };
+
+}
+
+bool ADTSConverter::unpack(const uint8_t* input, size_t size)
 {
     if (size < 3) {
         return false;
@@ -27,54 +113,181 @@ bool ADTSConverter::convert(uint8_t* input, size_t size, std::vector<uint8_t>& o
         return false;
     }
 
-    if (!unpackStreamMuxConfig(input + 3, size - 3)) {
+    // StreamMuxConfig takes bytes 3 to 9, up to the 3 low bits of byte 9 where PayloadLengthInfo starts
+    if (size < 3 + 7) {
         return false;
     }
 
-    int tmp;
-    int slotLength = 0;
-    int i = 3 + 6;
-    do {
-        tmp = (input[i] & 0b00000111) << 5 | (input[i + 1] & 0b11111000) >> 3;
-        slotLength += tmp;
-        i++;
-    } while (tmp == 255);
+    uint8_t keyBytes[8] = {};
+    memcpy(keyBytes, input + 3, 7);
+    keyBytes[6] &= 0b11111000;
+    uint64_t key;
+    memcpy(&key, keyBytes, sizeof(key));
+
+    if (!hasMuxConfig || key != muxConfigKey) {
+        hasMuxConfig = true;
+        muxConfigKey = key;
+        muxConfigSupported = unpackStreamMuxConfig(input + 3, size - 3);
+        if (!muxConfigSupported) {
+            return false;
+        }
+
+        // Channel configurations beyond 7 are described by a program_config_element instead
+        const int adtsChannelConfiguration = pceSize ? 0 : channelConfiguration;
+
+        // ADTS Header, frame_length and buffer fullness are filled in per frame
+        headerPrefix[0] = (0xFFF >> 4) & 0xFF;
+        headerPrefix[1] = ((0xFFF & 0b111100000000) >> 8) << 4 |
+            0 << 3 | // mpeg version
+            0 << 1 | // layer
+            1; // protection absent
+        headerPrefix[2] = (convertAdtsAudioObjectType(audioObjectType) & 0b11) << 6 |
+            sampleRate << 2 |
+            1 << 1 | // private bit
+            (adtsChannelConfiguration & 0b100) >> 2;
+        headerPrefix[3] = (adtsChannelConfiguration & 0b011) << 6 |
+            1 << 5 | // original
+            1 << 4 | // copy
+            1 << 3 | // cib
+            1 << 2; // cis
+    }
+    else if (!muxConfigSupported) {
+        return false;
+    }
 
-    int frameLength = slotLength + 7;
     int bufferFullness = 0x7FF;
 
-    output.resize(frameLength);
-
-    // ADTS Header
-    output.data()[0] = (0xFFF >> 4) & 0xFF;
-    output.data()[1] = ((0xFFF & 0b111100000000) >> 8) << 4 |
-        0 << 3 | // mpeg version
-        0 << 1 | // layer
-        1; // protection absent
-    output.data()[2] = (convertAdtsAudioObjectType(audioObjectType) & 0b11) << 6 |
-        sampleRate << 2 |
-        1 << 1 | // private bit
-        (channelConfiguration & 0b100) >> 2;
-    output.data()[3] = (channelConfiguration & 0b011) << 6 |
-        1 << 5 | // original
-        1 << 4 | // copy
-        1 << 3 | // cib
-        1 << 2 | // cis
-        (frameLength & 0b1100000000000) >> 11;
-    output.data()[4] = (frameLength & 0b0011111111000) >> 3;
-    output.data()[5] = (frameLength & 0b0000000000111) << 5 |
-        (bufferFullness & 0b11111000000) >> 6;
-    output.data()[6] = (bufferFullness & 0b00000111111) << 2 |
-        0/* rdb in frame */;
-
-    for (int i2 = 0; i2 < slotLength; i2++) {
-        output.data()[7 + i2] = (input[i + i2] & 0b00000111) << 5 | (input[i + i2 + 1] & 0b11111000) >> 3;
+    // Each subframe is a PayloadLengthInfo followed by its PayloadMux, both whole bytes,
+    // so every payload starts at the same bit position within its first byte
+    frameCount = 0;
+    outputSize = 0;
+    size_t i = 3 + 6;
+    for (int subFrame = 0; subFrame <= numSubFrames; subFrame++) {
+        int tmp;
+        size_t slotLength = 0;
+        do {
+            if (i + 1 >= size) {
+                return false;
+            }
+            tmp = (input[i] & 0b00000111) << 5 | (input[i + 1] & 0b11111000) >> 3;
+            slotLength += tmp;
+            i++;
+        } while (tmp == 255);
+
+        // The last 3 bits of the payload are in byte i + slotLength
+        if (i + slotLength >= size) {
+            return false;
+        }
+
+        size_t frameLength = kHeaderSize + pceSize + slotLength;
+        if (frameLength > 0x1FFF) {
+            return false;
+        }
+
+        Frame& frame = frames[frameCount++];
+        memcpy(frame.header.data(), headerPrefix.data(), headerPrefix.size());
+        frame.header[3] = (headerPrefix[3] & 0b11111100) | (frameLength & 0b1100000000000) >> 11;
+        frame.header[4] = (frameLength & 0b0011111111000) >> 3;
+        frame.header[5] = (frameLength & 0b0000000000111) << 5 |
+            (bufferFullness & 0b11111000000) >> 6;
+        frame.header[6] = (bufferFullness & 0b00000111111) << 2 |
+            0/* rdb in frame */;
+
+        frame.payload = input + i;
+        frame.payloadSize = slotLength;
+        outputSize += frameLength;
+
+        i += slotLength;
     }
 
     return true;
 }
 
-bool ADTSConverter::unpackStreamMuxConfig(uint8_t* input, size_t size)
+void ADTSConverter::write(uint8_t* destination, size_t offset, size_t size) const
+{
+    for (size_t k = 0; k < frameCount && size; k++) {
+        const Frame& frame = frames[k];
+        const size_t frameSize = kHeaderSize + pceSize + frame.payloadSize;
+        if (offset >= frameSize) {
+            offset -= frameSize;
+            continue;
+        }
+
+        const size_t chunk = std::min(frameSize - offset, size);
+        writeFrame(frame, destination, offset, chunk);
+        destination += chunk;
+        size -= chunk;
+        offset = 0;
+    }
+}
+
+void ADTSConverter::writeFrame(const Frame& frame, uint8_t* destination, size_t offset, size_t size) const
+{
+    if (offset < kHeaderSize) {
+        const size_t headerChunk = std::min(kHeaderSize - offset, size);
+        memcpy(destination, frame.header.data() + offset, headerChunk);
+        destination += headerChunk;
+        offset += headerChunk;
+        size -= headerChunk;
+    }
+
+    if (size && offset < kHeaderSize + pceSize) {
+        const size_t pceChunk = std::min(kHeaderSize + pceSize - offset, size);
+        memcpy(destination, pce.data() + (offset - kHeaderSize), pceChunk);
+        destination += pceChunk;
+        offset += pceChunk;
+        size -= pceChunk;
+    }
+
+    if (size) {
+        shiftPayload(destination, frame.payload + (offset - kHeaderSize - pceSize), size);
+    }
+}
+
+void ADTSConverter::buildProgramConfigElement()
+{
+    pce.fill(0);
+    BitWriter writer(pce.data());
+
+    writer.put(5, 3); // id_syn_ele: ID_PCE
+    writer.put(0, 4); // element_instance_tag
+    writer.put(convertAdtsAudioObjectType(audioObjectType), 2); // object_type
+    writer.put(sampleRate, 4); // sampling_frequency_index
+    writer.put(static_cast<uint32_t>(std::size(k22_2chFrontElements)), 4);
+    writer.put(static_cast<uint32_t>(std::size(k22_2chSideElements)), 4);
+    writer.put(static_cast<uint32_t>(std::size(k22_2chBackElements)), 4);
+    writer.put(static_cast<uint32_t>(std::size(k22_2chLfeTags)), 2);
+    writer.put(0, 3); // num_assoc_data_elements
+    writer.put(0, 4); // num_valid_cc_elements
+    writer.put(0, 1); // mono_mixdown_present
+    writer.put(0, 1); // stereo_mixdown_present
+    writer.put(0, 1); // matrix_mixdown_idx_present
+
+    for (const SyntacticElement& element : k22_2chFrontElements) {
+        writer.put(element.isCpe, 1);
+        writer.put(element.tag, 4);
+    }
+    for (const SyntacticElement& element : k22_2chSideElements) {
+        writer.put(element.isCpe, 1);
+        writer.put(element.tag, 4);
+    }
+    for (const SyntacticElement& element : k22_2chBackElements) {
+        writer.put(element.isCpe, 1);
+        writer.put(element.tag, 4);
+    }
+    for (uint8_t tag : k22_2chLfeTags) {
+        writer.put(tag, 4);
+    }
+
+    // Aligned to the start of the raw_data_block, which follows the byte-aligned ADTS header.
+    // The heights of the top and bottom layers are not signalled, so they play at ear level.
+    writer.byteAlign();
+    writer.put(0, 8); // comment_field_bytes
+
+    pceSize = writer.getSize();
+}
+
+bool ADTSConverter::unpackStreamMuxConfig(const uint8_t* input, size_t size)
 {
     int audioMuxVersion = (input[0] & 0b10000000) >> 7;
 
@@ -83,15 +296,19 @@ bool ADTSConverter::unpackStreamMuxConfig(uint8_t* input, size_t size)
         return false;
     }
 
-    //int allStreamSameTimeFraming = (input[0] & 0b01000000) >> 5;
-    // restricted to 0
-    int numSubFrames = (input[0] & 0b00011111) << 1 | (input[1] & 0b10000000);
+    int allStreamsSameTimeFraming = (input[0] & 0b00100000) >> 5;
+    numSubFrames = (input[0] & 0b00011111) << 1 | (input[1] & 0b10000000) >> 7;
     // restricted to 0
     int numPrograms = input[1] & 0b01111000;
     // restricted to 0
     int numLayer = input[1] & 0b00000111;
 
-    if (numSubFrames != 0 || numPrograms != 0 || numLayer != 0) {
+    if (numPrograms != 0 || numLayer != 0) {
+        return false;
+    }
+
+    // Subframes are only laid out one after another when they share the time framing
+    if (numSubFrames != 0 && !allStreamsSameTimeFraming) {
         return false;
     }
 
@@ -118,10 +335,15 @@ bool ADTSConverter::unpackStreamMuxConfig(uint8_t* input, size_t size)
 
     //int crc = (input[5] & 0b00000111) << 3 | (input[6] & 0b11111000) >> 3;
 
+    pceSize = 0;
+    if (channelConfiguration == 13) {
+        buildProgramConfigElement();
+    }
+
     return true;
 }
 
-bool ADTSConverter::unpackAudioSpecificConfig(uint8_t* input, size_t size)
+bool ADTSConverter::unpackAudioSpecificConfig(const uint8_t* input, size_t size)
 {
     audioObjectType = (input[2] & 0b11111000) >> 3;
     if (audioObjectType == 28) {
@@ -134,6 +356,11 @@ bool ADTSConverter::unpackAudioSpecificConfig(uint8_t* input, size_t size)
     }
 
     channelConfiguration = (input[3] & 0b01111000) >> 3;
+    // A program_config_element in the AudioSpecificConfig is not read; of the configurations that do
+    // not fit in ADTS, only 22.2ch is supported, with a program_config_element of its own
+    if (channelConfiguration == 0 || (channelConfiguration > 7 && channelConfiguration != 13)) {
+        return false;
+    }
 
     bool framelenFlag = (input[3] & 0b00000100) >> 2;
     bool dependsOnCoder = (input[3] & 0b00000010) >> 1;
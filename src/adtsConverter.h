@@ -1,15 +1,63 @@
 #pragma once
-#include <vector>
+#include <array>
+#include <cstddef>
 #include <cstdint>
 
+// Converts the AAC frames of one audio stream from LOAS/LATM to ADTS.
+// The StreamMuxConfig is parsed again only when its bytes change, and the ADTS frames are not built
+// in a buffer of their own: write() produces any range of them, straight into the TS packets.
+// Each subframe of a LOAS frame becomes one ADTS frame. 22.2ch (channelConfiguration 13) has no ADTS
+// channel_configuration, so its frames start with a program_config_element describing the layout.
 class ADTSConverter {
 public:
-	bool convert(uint8_t* input, size_t size, std::vector<uint8_t>& output);
+	// Reads one LOAS frame; false if it cannot be converted.
+	// input must stay valid until the frames have been written.
+	bool unpack(const uint8_t* input, size_t size);
+
+	// False after a StreamMuxConfig that ADTS cannot carry, e.g. a channelConfiguration other than 1-7 and 13,
+	// until a supported one follows. unpack() refuses the frames in between, which can be kept as LOAS/LATM.
+	bool isMuxConfigSupported() const { return muxConfigSupported; }
+
+	// Size of the ADTS frames of the last unpacked LOAS frame
+	size_t getOutputSize() const { return outputSize; }
+
+	// Writes bytes [offset, offset + size) of the ADTS frames to destination.
+	void write(uint8_t* destination, size_t offset, size_t size) const;
 
 private:
-	bool unpackStreamMuxConfig(uint8_t* input, size_t size);
-	bool unpackAudioSpecificConfig(uint8_t* input, size_t size);
+	static constexpr size_t kHeaderSize = 7;
+	static constexpr size_t kMaxPceSize = 16;
+	static constexpr size_t kMaxSubFrames = 64;
+
+	struct Frame {
+		std::array<uint8_t, kHeaderSize> header;
+		// The payload starts 5 bits into its first byte, behind PayloadLengthInfo
+		const uint8_t* payload;
+		size_t payloadSize;
+	};
+
+	bool unpackStreamMuxConfig(const uint8_t* input, size_t size);
+	bool unpackAudioSpecificConfig(const uint8_t* input, size_t size);
+	void buildProgramConfigElement();
+	void writeFrame(const Frame& frame, uint8_t* destination, size_t offset, size_t size) const;
+
 	int audioObjectType{ 0 };
 	int sampleRate{ 0 };
 	int channelConfiguration{ 0 };
-};
\ No newline at end of file
+	int numSubFrames{ 0 };
+
+	// StreamMuxConfig bytes the fields above were read from, and whether they were accepted
+	bool hasMuxConfig{ false };
+	uint64_t muxConfigKey{ 0 };
+	bool muxConfigSupported{ true };
+
+	// ADTS header bytes up to channel_configuration, common to every frame
+	std::array<uint8_t, 4> headerPrefix{};
+	// ID_PCE and program_config_element written at the start of each raw_data_block, if any
+	std::array<uint8_t, kMaxPceSize> pce{};
+	size_t pceSize{ 0 };
+
+	std::array<Frame, kMaxSubFrames> frames{};
+	size_t frameCount{ 0 };
+	size_t outputSize{ 0 };
+};
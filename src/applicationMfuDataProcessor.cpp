@@ -11,6 +11,7 @@ std::optional<MfuData> ApplicationMfuDataProcessor::process(const std::shared_pt
     }
 
     MfuData mfuData;
+    mfuData.data = mmtStream->getFrameBufferPool().acquire();
     mfuData.data.resize(size);
     stream.read(mfuData.data.data(), size);
 
@@ -0,0 +1,36 @@
+#pragma once
+#include <cstddef>
+#include <memory_resource>
+#include <type_traits>
+
+namespace MmtTlv {
+
+namespace Common {
+
+// Monotonic allocator for the objects unpacked from one section.
+// Memory is taken from a few growing blocks and only released with the arena,
+// so it holds the storage of pmr containers and trivially destructible objects only.
+class Arena {
+public:
+	explicit Arena(size_t initialSize = 4096)
+		: memory(initialSize) {}
+
+	Arena(const Arena&) = delete;
+	Arena& operator=(const Arena&) = delete;
+
+	// Uninitialized storage for count objects of a trivially destructible type.
+	template<typename T>
+	T* allocate(size_t count) {
+		static_assert(std::is_trivially_destructible_v<T>);
+		return static_cast<T*>(memory.allocate(sizeof(T) * count, alignof(T)));
+	}
+
+	std::pmr::memory_resource* getResource() { return &memory; }
+
+private:
+	std::pmr::monotonic_buffer_resource memory;
+};
+
+}
+
+}
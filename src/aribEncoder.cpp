@@ -0,0 +1,537 @@
+#include "aribEncoder.h"
+#include "tsARIBCharset.h"
+#include <array>
+#include <string>
+#include <vector>
+
+namespace {
+
+    struct Gaiji {
+        char32_t codePoint;
+        std::u32string_view replacement;
+    };
+
+    // Escaped, since the CJK compatibility ideographs would not survive Unicode normalization of the source
+    constexpr Gaiji gaijiTable[] = {
+        // ARIB STD-B62
+        {U'\U0001F19B', U"[3D]"},
+        {U'\U0001F19C', U"[2nd Scr]"},
+        {U'\U0001F19D', U"[2K]"},
+        {U'\U0001F19E', U"[4K]"},
+        {U'\U0001F19F', U"[8K]"},
+        {U'\U0001F1A0', U"[5.1]"},
+        {U'\U0001F1A1', U"[7.1]"},
+        {U'\U0001F1A2', U"[22.2]"},
+        {U'\U0001F1A3', U"[60P]"},
+        {U'\U0001F1A4', U"[120P]"},
+        {U'\U0001F1A5', U"[\U0000FF44]"},
+        {U'\U0001F1A6', U"[HC]"},
+        {U'\U0001F1A7', U"[HDR]"},
+        {U'\U0001F1A8', U"[Hi-Res]"},
+        {U'\U0001F1A9', U"[Lossless]"},
+        {U'\U0001F1AA', U"[SHV]"},
+        {U'\U0001F1AB', U"[UHD]"},
+        {U'\U0001F1AC', U"[VOD]"},
+        {U'\U0001F23B', U"[\U0000914D]"},
+        {U'\U000032FF', U"\U00004EE4\U0000548C"},
+
+        // ARIB STD-B24 (Table 7-11 Addtional Kanji Characters)
+        {U'\U00004EFF', U"\U00005F77"},
+        {U'\U0000509C', U"\U00005FAD"},
+        {U'\U0000FA6B', U"\U00006075"},
+        {U'\U00006CE0', U"\U000051B7"},
+        {U'\U0000FA4A', U"\U00007422"},
+        {U'\U00007575', U"\U0000756B"},
+        {U'\U0000FA6D', U"\U00008218"},
+        {U'\U000087EC', U"\U00008749"},
+        {U'\U00009DD7', U"\U00009D0E"},
+        {U'\U00009EB4', U"\U00009EB9"},
+        {U'\U00009EB5', U"\U00009EBA"},
+        {U'\U00009AD9', U"\U00009AD8"},
+        {U'\U0000FA10', U"\U0000585A"},
+        {U'\U0000FA11', U"\U000057FC"},
+        {U'\U0000FA45', U"\U00006D77"},
+        {U'\U0000FA46', U"\U00006E1A"},
+        {U'\U0000F9B6', U"\U000079AE"},
+        {U'\U00002F93', U"\U000089D2"},
+    };
+
+    static_assert(std::size(gaijiTable) < 0x100, "gaiji index must fit in the code field of a table entry");
+
+    // Control codes, ARIB STD-B24, part 2, table 7-14
+    constexpr uint8_t LS0 = 0x0F;
+    constexpr uint8_t LS1 = 0x0E;
+    constexpr uint8_t ESC = 0x1B;
+    constexpr uint8_t SP = 0x20;
+    constexpr uint8_t MSZ = 0x89;
+    constexpr uint8_t NSZ = 0x8A;
+
+    // Final bytes of the graphic sets the encoder designates by default or for spaces
+    constexpr uint8_t KANJI = 0x39;
+    constexpr uint8_t ALPHANUMERIC = 0x4A;
+    constexpr uint8_t PROPORTIONAL_ALPHANUMERIC = 0x36;
+    constexpr uint8_t HIRAGANA = 0x30;
+    constexpr uint8_t JIS_X0201_KATAKANA = 0x49;
+
+    enum EntryKind : uint8_t {
+        None = 0,
+        Character = 1,
+        GaijiIndex = 2,
+    };
+
+    // Entry of the code point table: shared flag (8 bits), kind (8 bits), index (16 bits).
+    // The index is the ts::ARIBCharset2 encoding table slice, or the gaiji table entry.
+    // Shared code points lie in several slices, and tsduck picks one depending on the previous character.
+    constexpr uint32_t kShared = 0x01000000;
+
+    constexpr uint32_t makeTableEntry(EntryKind kind, size_t index, bool shared) {
+        return (shared ? kShared : 0) | static_cast<uint32_t>(kind) << 16 | static_cast<uint32_t>(index);
+    }
+    constexpr EntryKind getTableKind(uint32_t entry) { return static_cast<EntryKind>((entry >> 16) & 0xFF); }
+    constexpr size_t getTableIndex(uint32_t entry) { return entry & 0xFFFF; }
+
+    // Character resolved against its slice, laid out like ts::ARIBCharset2::EncoderEntry:
+    // 2-byte set (1 bit), final byte F (7 bits), row (8 bits), code (8 bits), kind (8 bits)
+    constexpr EntryKind getKind(uint32_t character) { return static_cast<EntryKind>(character & 0xFF); }
+    constexpr bool isByte2(uint32_t character) { return (character & 0x80000000) != 0; }
+    constexpr uint8_t getSelector(uint32_t character) { return (character >> 24) & 0x7F; }
+    constexpr uint8_t getRow(uint32_t character) { return (character >> 16) & 0x7F; }
+    constexpr uint8_t getCode(uint32_t character) { return (character >> 8) & 0xFF; }
+
+    // Port of ts::ARIBCharset2::Encoder writing one code point at a time.
+    // Any change here must keep the output identical to the tsduck encoder.
+    class Writer {
+    public:
+        Writer(uint8_t* out, size_t outSize)
+            : out(out), outSize(outSize) {
+        }
+
+        // Returns false when the character does not fit and encoding must stop.
+        bool put(char32_t codePoint, uint32_t character) {
+            if (outSize == 0) {
+                return false;
+            }
+
+            if (codePoint == 0) {
+                *out++ = 0;
+                --outSize;
+                return true;
+            }
+
+            if (getKind(character) == Character) {
+                const uint8_t selector = getSelector(character);
+                const bool byte2 = isByte2(character);
+                if (!selectCharSet(selector, byte2)) {
+                    return false;
+                }
+
+                const uint8_t mask = selector == G[GR] ? 0x80 : 0x00;
+                if (byte2) {
+                    *out++ = getRow(character) | mask;
+                    --outSize;
+                }
+                *out++ = getCode(character) | mask;
+                --outSize;
+                return true;
+            }
+
+            if (codePoint == SP || codePoint == 0x3000) {
+                return encodeSpace(codePoint == 0x3000);
+            }
+
+            // Not encodable, skipped
+            return true;
+        }
+
+        size_t getSize(const uint8_t* begin) const { return out - begin; }
+
+    private:
+        bool isAlphaNumeric(uint8_t index) const {
+            return G[index] == ALPHANUMERIC || G[index] == PROPORTIONAL_ALPHANUMERIC;
+        }
+
+        bool encodeSpace(bool ideographic) {
+            uint8_t code = 0;
+            size_t count = 0;
+
+            if (ideographic) {
+                if (!byte2[GL] && !isAlphaNumeric(GL)) {
+                    code = SP;
+                    count = 1;
+                }
+                else if (!byte2[GR] && !isAlphaNumeric(GR)) {
+                    code = SP | 0x80;
+                    count = 1;
+                }
+                else if (!isAlphaNumeric(GL)) {
+                    code = SP;
+                    count = 2;
+                }
+                else {
+                    code = SP | 0x80;
+                    count = 2;
+                }
+            }
+            else {
+                if (isAlphaNumeric(GL)) {
+                    code = SP;
+                    count = 1;
+                }
+                else if (isAlphaNumeric(GR)) {
+                    code = SP | 0x80;
+                    count = 1;
+                }
+                else if (selectCharSet(ALPHANUMERIC, false)) {
+                    code = ALPHANUMERIC == G[GR] ? (SP | 0x80) : SP;
+                    count = 1;
+                }
+                else {
+                    return false;
+                }
+            }
+
+            if (count > outSize) {
+                return false;
+            }
+            while (count-- > 0) {
+                *out++ = code;
+                --outSize;
+            }
+            return true;
+        }
+
+        bool selectCharSet(uint8_t selector, bool isByte2) {
+            const size_t charSize = isByte2 ? 2 : 1;
+
+            uint8_t seq[7];
+            size_t seqSize = 0;
+
+            const uint8_t size = selector == ALPHANUMERIC ? MSZ : NSZ;
+            if (characterSize != size) {
+                seq[seqSize++] = size;
+                characterSize = size;
+            }
+
+            if (selector != G[GL] && selector != G[GR]) {
+                if (selector != G[0] && selector != G[1] && selector != G[2] && selector != G[3]) {
+                    seqSize += selectG0(seq + seqSize, selector, isByte2);
+                }
+                seqSize += selectGLR(seq + seqSize, selector);
+            }
+
+            if (seqSize + charSize > outSize) {
+                return false;
+            }
+            for (size_t i = 0; i < seqSize; i++) {
+                *out++ = seq[i];
+            }
+            outSize -= seqSize;
+
+            GLLast = G[GL] == selector;
+            return true;
+        }
+
+        size_t selectGLR(uint8_t* seq, uint8_t selector) {
+            if (selector == G[0]) {
+                GL = 0;
+                seq[0] = LS0;
+                return 1;
+            }
+
+            // Invoke into GR when GL was used last and vice versa
+            static constexpr uint8_t lockingShiftGR[] = {0, 0x7E, 0x7D, 0x7C};
+            static constexpr uint8_t lockingShiftGL[] = {0, 0, 0x6E, 0x6F};
+            const uint8_t index = selector == G[1] ? 1 : selector == G[2] ? 2 : 3;
+            if (GLLast) {
+                GR = index;
+                seq[0] = ESC;
+                seq[1] = lockingShiftGR[index];
+                return 2;
+            }
+
+            GL = index;
+            if (index == 1) {
+                seq[0] = LS1;
+                return 1;
+            }
+            seq[0] = ESC;
+            seq[1] = lockingShiftGL[index];
+            return 2;
+        }
+
+        // New sets are always designated to G0, as the tsduck encoder does
+        size_t selectG0(uint8_t* seq, uint8_t selector, bool isByte2) {
+            G[0] = selector;
+            byte2[0] = isByte2;
+
+            seq[0] = ESC;
+            seq[1] = isByte2 ? 0x24 : 0x28;
+            seq[2] = selector;
+            return 3;
+        }
+
+        uint8_t* out;
+        size_t outSize;
+
+        // Same initial state as the decoder: Kanji, alphanumeric, hiragana and JIS X0201 katakana
+        // in G0-G3, G0 invoked into GL and G2 into GR
+        uint8_t G[4]{KANJI, ALPHANUMERIC, HIRAGANA, JIS_X0201_KATAKANA};
+        bool byte2[4]{true, false, false, false};
+        uint8_t GL{0};
+        uint8_t GR{2};
+        bool GLLast{false};
+        uint8_t characterSize{NSZ};
+    };
+
+    size_t getUtf16Length(char32_t codePoint) {
+        return codePoint >= 0x10000 ? 2 : 1;
+    }
+
+    size_t getUtf8Length(char32_t codePoint) {
+        return codePoint < 0x80 ? 1 : codePoint < 0x800 ? 2 : codePoint < 0x10000 ? 3 : 4;
+    }
+
+    void appendUtf8(std::string& output, char32_t codePoint) {
+        if (codePoint < 0x80) {
+            output += static_cast<char>(codePoint);
+        }
+        else if (codePoint < 0x800) {
+            output += static_cast<char>(0xC0 | codePoint >> 6);
+            output += static_cast<char>(0x80 | (codePoint & 0x3F));
+        }
+        else if (codePoint < 0x10000) {
+            output += static_cast<char>(0xE0 | codePoint >> 12);
+            output += static_cast<char>(0x80 | (codePoint >> 6 & 0x3F));
+            output += static_cast<char>(0x80 | (codePoint & 0x3F));
+        }
+        else {
+            output += static_cast<char>(0xF0 | codePoint >> 18);
+            output += static_cast<char>(0x80 | (codePoint >> 12 & 0x3F));
+            output += static_cast<char>(0x80 | (codePoint >> 6 & 0x3F));
+            output += static_cast<char>(0x80 | (codePoint & 0x3F));
+        }
+    }
+
+    // Byte-wise substitution of the gaiji sequences, one table entry after another.
+    // Only used for malformed input, where a sequence may not start on a decoded character.
+    std::string substituteGaiji(std::string_view input) {
+        std::string output(input);
+        for (const auto& gaiji : gaijiTable) {
+            std::string sequence;
+            appendUtf8(sequence, gaiji.codePoint);
+            std::string replacement;
+            for (char32_t codePoint : gaiji.replacement) {
+                appendUtf8(replacement, codePoint);
+            }
+
+            size_t pos = 0;
+            while ((pos = output.find(sequence, pos)) != std::string::npos) {
+                output.replace(pos, sequence.size(), replacement);
+                pos += replacement.size();
+            }
+        }
+        return output;
+    }
+
+}
+
+// Two-level table over the code points: a page index per 256 code points, pointing to
+// shared pages. Page 0 is left empty for code points without an encoding.
+class AribEncoder::CodePointTable {
+public:
+    CodePointTable() : pages(1) {}
+
+    uint32_t operator[](char32_t codePoint) const {
+        const size_t page = codePoint >> 8;
+        if (page >= pageIndex.size()) {
+            return None;
+        }
+        return pages[pageIndex[page]][codePoint & 0xFF];
+    }
+
+    void set(char32_t codePoint, uint32_t entry) {
+        const size_t page = codePoint >> 8;
+        if (page >= pageIndex.size()) {
+            pageIndex.resize(page + 1, 0);
+        }
+        if (pageIndex[page] == 0) {
+            pageIndex[page] = static_cast<uint16_t>(pages.size());
+            pages.emplace_back();
+        }
+        pages[pageIndex[page]][codePoint & 0xFF] = entry;
+    }
+
+private:
+    std::vector<uint16_t> pageIndex;
+    std::vector<std::array<uint32_t, 256>> pages;
+};
+
+const AribEncoder::CodePointTable& AribEncoder::getCodePointTable()
+{
+    static const CodePointTable table = [] {
+        CodePointTable table;
+
+        for (size_t i = 0; i < ts::ARIBCharset2::ENCODING_COUNT; i++) {
+            const auto& slice = ts::ARIBCharset2::ENCODING_TABLE[i];
+            for (char32_t codePoint = slice.code_point; codePoint < slice.code_point + slice.count(); codePoint++) {
+                // Without a previous character, tsduck takes the slice its binary search lands on
+                const bool shared = getTableKind(table[codePoint]) == Character;
+                const size_t index = ts::ARIBCharset2::FindEncoderEntry(codePoint);
+                table.set(codePoint, makeTableEntry(Character, index, shared));
+            }
+        }
+
+        // Substituted before the lookup, so they take precedence over their own encoding
+        for (size_t i = 0; i < std::size(gaijiTable); i++) {
+            table.set(gaijiTable[i].codePoint, makeTableEntry(GaijiIndex, i, false));
+        }
+
+        return table;
+    }();
+
+    return table;
+}
+
+size_t AribEncoder::encode(std::string_view input, uint8_t* output, size_t outputSize)
+{
+    size_t utf16Length;
+    return encode(input, output, outputSize, utf16Length, false);
+}
+
+ts::ByteBlock AribEncoder::encode(std::string_view input)
+{
+    ts::ByteBlock output(getMaxEncodedSize(input.size()));
+
+    size_t utf16Length;
+    size_t size = encode(input, output.data(), output.size(), utf16Length, false);
+
+    // ts::Charset::encoded() gives the encoder 4 bytes per UTF-16 unit. A longer result
+    // is encoded again within that limit, so truncation happens at the same character.
+    const size_t limit = utf16Length * 4;
+    if (size > limit) {
+        size = encode(input, output.data(), limit, utf16Length, false);
+    }
+
+    output.resize(size);
+    return output;
+}
+
+size_t AribEncoder::encode(std::string_view input, uint8_t* output, size_t outputSize, size_t& utf16Length, bool substituted)
+{
+    const CodePointTable& table = getCodePointTable();
+    Writer writer(output, outputSize);
+    utf16Length = 0;
+
+    // Same slice choice as ts::ARIBCharset2::FindEncoderEntry() with the previous slice as hint
+    size_t previousSlice = ts::NPOS;
+    auto resolve = [&](char32_t codePoint, uint32_t entry) -> uint32_t {
+        // A gaiji code point that was not substituted is encoded as is
+        if (getTableKind(entry) == GaijiIndex) {
+            const size_t slice = ts::ARIBCharset2::FindEncoderEntry(codePoint, previousSlice);
+            if (slice == ts::NPOS) {
+                return None;
+            }
+            entry = makeTableEntry(Character, slice, false);
+        }
+        if (getTableKind(entry) != Character) {
+            return None;
+        }
+
+        size_t slice = getTableIndex(entry);
+        if ((entry & kShared) && previousSlice != ts::NPOS) {
+            const auto* encodingTable = ts::ARIBCharset2::ENCODING_TABLE;
+            if (encodingTable[previousSlice].contains(codePoint)) {
+                slice = previousSlice;
+            }
+            else if (previousSlice + 1 < ts::ARIBCharset2::ENCODING_COUNT && encodingTable[previousSlice + 1].contains(codePoint)) {
+                slice = previousSlice + 1;
+            }
+            else if (previousSlice > 0 && encodingTable[previousSlice - 1].contains(codePoint)) {
+                slice = previousSlice - 1;
+            }
+        }
+        previousSlice = slice;
+
+        const auto& encoding = ts::ARIBCharset2::ENCODING_TABLE[slice];
+        const uint32_t code = codePoint - encoding.code_point + encoding.index();
+        return (encoding.entry & 0xFFFF0000) | code << 8 | Character;
+    };
+
+    // Once the output is full, the rest is only decoded to count its UTF-16 length
+    bool full = false;
+
+    // tsduck encodes UTF-16, where a lone leading surrogate pairs up with whatever unit follows it
+    char32_t leadingSurrogate = 0;
+    auto put = [&](char32_t codePoint, uint32_t entry) {
+        utf16Length += getUtf16Length(codePoint);
+        if (full) {
+            return;
+        }
+
+        if (leadingSurrogate != 0) {
+            // The trailing unit of a supplementary code point is then left on its own and skipped
+            const char32_t unit = codePoint >= 0x10000 ? 0xD800 + ((codePoint - 0x10000) >> 10) : codePoint;
+            codePoint = 0x10000 + ((leadingSurrogate & 0x03FF) << 10 | (unit & 0x03FF));
+            entry = table[codePoint];
+            leadingSurrogate = 0;
+        }
+        else if (codePoint >= 0xD800 && codePoint < 0xDC00) {
+            leadingSurrogate = codePoint;
+            return;
+        }
+
+        full = !writer.put(codePoint, resolve(codePoint, entry));
+    };
+
+    const uint8_t* p = reinterpret_cast<const uint8_t*>(input.data());
+    const uint8_t* end = p + input.size();
+    while (p < end) {
+        // Decoded like ts::UString::FromUTF8: invalid lead bytes are dropped,
+        // continuation bytes are not checked and a truncated sequence ends the input
+        const uint8_t* sequence = p;
+        char32_t codePoint = *p++;
+        if (codePoint >= 0x80) {
+            size_t count;
+            if ((codePoint & 0xE0) == 0xC0) {
+                count = 1;
+                codePoint &= 0x1F;
+            }
+            else if ((codePoint & 0xF0) == 0xE0) {
+                count = 2;
+                codePoint &= 0x0F;
+            }
+            else if ((codePoint & 0xF8) == 0xF0) {
+                count = 3;
+                codePoint &= 0x07;
+            }
+            else {
+                continue;
+            }
+
+            if (static_cast<size_t>(end - p) < count) {
+                break;
+            }
+            while (count-- > 0) {
+                if ((*p & 0xC0) != 0x80 && !substituted) {
+                    // The malformed sequence swallows the start of the next one, which the
+                    // byte-wise gaiji substitution may still match: start over on its result
+                    return encode(substituteGaiji(input), output, outputSize, utf16Length, true);
+                }
+                codePoint = codePoint << 6 | (*p++ & 0x3F);
+            }
+        }
+
+        // Overlong sequences do not match the gaiji sequences either
+        const uint32_t entry = table[codePoint];
+        if (getTableKind(entry) == GaijiIndex && !substituted && static_cast<size_t>(p - sequence) == getUtf8Length(codePoint)) {
+            for (char32_t replacement : gaijiTable[getTableIndex(entry)].replacement) {
+                put(replacement, table[replacement]);
+            }
+            continue;
+        }
+
+        put(codePoint, entry);
+    }
+
+    return writer.getSize(output);
+}
@@ -0,0 +1,32 @@
+#pragma once
+#include <tsduck.h>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+// UTF-8 to ARIB STD-B24 8-unit code encoder.
+// The input is decoded once, gaiji are substituted inline and every code point is looked up in a
+// direct-indexed table. The output is the same as ts::ARIBCharset2::B24 on the substituted string.
+class AribEncoder {
+public:
+    // Upper bound of the encoded size of inputSize bytes of UTF-8.
+    static constexpr size_t getMaxEncodedSize(size_t inputSize) { return inputSize * kMaxBytesPerInputByte; }
+
+    // Encodes into a caller-supplied buffer and returns the number of bytes written.
+    // Like ts::ARIBCharset2, encoding stops at the first character that does not fit.
+    static size_t encode(std::string_view input, uint8_t* output, size_t outputSize);
+
+    // Encodes with the same output size limit as ts::Charset::encoded().
+    static ts::ByteBlock encode(std::string_view input);
+
+private:
+    // A character takes at most a size control, a designation, a shift and 2 bytes of code (8 bytes),
+    // and gaiji substitutions never expand by more than that per input byte.
+    static constexpr size_t kMaxBytesPerInputByte = 8;
+
+    class CodePointTable;
+    static const CodePointTable& getCodePointTable();
+
+    // Once substituted, gaiji are no longer expanded (used for malformed UTF-8).
+    static size_t encode(std::string_view input, uint8_t* output, size_t outputSize, size_t& utf16Length, bool substituted);
+};
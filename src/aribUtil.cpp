@@ -1,83 +1,99 @@
 ﻿#include "aribUtil.h"
-#include "tsARIBCharset.h"
+#include "aribEncoder.h"
+#include <list>
+#include <mutex>
+#include <string_view>
+#include <unordered_map>
 
-struct Gaiji {
-    const char8_t* find;
-    const char8_t* replacement;
-};
+namespace {
 
-constexpr Gaiji GaijiTable[] = {
-    // ARIB STD-B62
-    {u8"\U0001F19B", u8"[3D]"},
-    {u8"\U0001F19C", u8"[2nd Scr]"},
-    {u8"\U0001F19D", u8"[2K]"},
-    {u8"\U0001F19E", u8"[4K]"},
-    {u8"\U0001F19F", u8"[8K]"},
-    {u8"\U0001F1A0", u8"[5.1]"},
-    {u8"\U0001F1A1", u8"[7.1]"},
-    {u8"\U0001F1A2", u8"[22.2]"},
-    {u8"\U0001F1A3", u8"[60P]"},
-    {u8"\U0001F1A4", u8"[120P]"},
-    {u8"\U0001F1A5", u8"[ｄ]"},
-    {u8"\U0001F1A6", u8"[HC]"},
-    {u8"\U0001F1A7", u8"[HDR]"},
-    {u8"\U0001F1A8", u8"[Hi-Res]"},
-    {u8"\U0001F1A9", u8"[Lossless]"},
-    {u8"\U0001F1AA", u8"[SHV]"},
-    {u8"\U0001F1AB", u8"[UHD]"},
-    {u8"\U0001F1AC", u8"[VOD]"},
-    {u8"\U0001F23B", u8"[配]"},
-    {u8"\U000032FF", u8"令和"},
-
-    // ARIB STD-B24 (Table 7-11 Addtional Kanji Characters)
-    {u8"仿", u8"彷"},
-    {u8"傜", u8"徭"},
-    {u8"恵", u8"恵"},
-    {u8"泠", u8"冷"},
-    {u8"琢", u8"琢"},
-    {u8"畵", u8"畫"},
-    {u8"舘", u8"舘"},
-    {u8"蟬", u8"蝉"},
-    {u8"鷗", u8"鴎"},
-    {u8"麴", u8"麹"},
-    {u8"麵", u8"麺"},
-    {u8"髙", u8"高"},
-    {u8"塚", u8"塚"},
-    {u8"﨑", u8"埼"},
-    {u8"海", u8"海"},
-    {u8"渚", u8"渚"},
-    {u8"禮", u8"禮"},
-    {u8"⾓", u8"角"},
-};
+ts::ByteBlock encode(std::string_view input) {
+    return AribEncoder::encode(input);
+}
 
-namespace {
+// LRU of recently encoded strings. EIT schedule sections repeat the same event names and
+// descriptions all the time, so most lookups are hits.
+class AribEncodeCache {
+public:
+    static constexpr size_t kCapacity = 4096;
+    // Longer texts are rare and would crowd out the short ones
+    static constexpr size_t kMaxInputSize = 2048;
+
+    bool find(std::string_view input, ts::ByteBlock& output) {
+        std::lock_guard<std::mutex> lock(mutex);
 
-void replaceSequence(std::string& str, const std::string& sequence, const char* replacement) {
-    std::size_t pos = 0;
+        auto it = index.find(input);
+        if (it == index.end()) {
+            ++missCount;
+            return false;
+        }
 
-    while ((pos = str.find(sequence, pos)) != std::string::npos) {
-        str.replace(pos, sequence.size(), replacement);
-        pos += 1;
+        entries.splice(entries.begin(), entries, it->second);
+        output = it->second->output;
+        ++hitCount;
+        return true;
     }
-}
 
-void convertGaiji(std::string& str) {
-    for (const auto& gaiji : GaijiTable) {
-        replaceSequence(str, reinterpret_cast<const char*>(gaiji.find), reinterpret_cast<const char*>(gaiji.replacement));
+    void insert(std::string_view input, const ts::ByteBlock& output) {
+        if (input.size() > kMaxInputSize) {
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (index.find(input) != index.end()) {
+            return;
+        }
+
+        entries.push_front(Entry{ std::string{ input }, output });
+        // The key views the string owned by the list node, which does not move
+        index.emplace(entries.front().input, entries.begin());
+
+        if (entries.size() > kCapacity) {
+            index.erase(entries.back().input);
+            entries.pop_back();
+        }
     }
-}
 
-}
+    AribEncodeCacheStatistics getStatistics() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return AribEncodeCacheStatistics{ hitCount, missCount, entries.size() };
+    }
+
+private:
+    struct Entry {
+        std::string input;
+        ts::ByteBlock output;
+    };
+
+    std::mutex mutex;
+    std::list<Entry> entries;
+    std::unordered_map<std::string_view, std::list<Entry>::iterator> index;
+    uint64_t hitCount{};
+    uint64_t missCount{};
+};
+
+AribEncodeCache aribEncodeCache;
 
-const ts::ByteBlock aribEncode(const std::string& input) {
-    std::string converted = input;
-    convertGaiji(converted);
+}
 
-    ts::UString text = ts::UString::FromUTF8(converted.data(), converted.size());
-    return ts::ARIBCharset2::B24.encoded(text);
+const ts::ByteBlock aribEncode(std::string_view input) {
+    return aribEncode(input.data(), input.size());
 }
 
 
 const ts::ByteBlock aribEncode(const char* input, size_t size) {
-    return aribEncode(std::string{ input, size });
+    std::string_view key{ input, size };
+
+    ts::ByteBlock output;
+    if (aribEncodeCache.find(key, output)) {
+        return output;
+    }
+
+    output = encode(key);
+    aribEncodeCache.insert(key, output);
+    return output;
+}
+
+AribEncodeCacheStatistics getAribEncodeCacheStatistics() {
+    return aribEncodeCache.getStatistics();
 }
@@ -1,6 +1,22 @@
 #pragma once
 #include <tsduck.h>
+#include <cstdint>
+#include <string_view>
 
-const ts::ByteBlock aribEncode(const std::string& input);
+const ts::ByteBlock aribEncode(std::string_view input);
 
 const ts::ByteBlock aribEncode(const char* input, size_t size);
+
+struct AribEncodeCacheStatistics {
+    uint64_t hitCount;
+    uint64_t missCount;
+    size_t size;
+
+    double getHitRate() const {
+        uint64_t lookupCount = hitCount + missCount;
+        return lookupCount ? static_cast<double>(hitCount) / lookupCount : 0;
+    }
+};
+
+// Lookups and entries of the memoized aribEncode
+AribEncodeCacheStatistics getAribEncodeCacheStatistics();
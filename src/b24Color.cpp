@@ -1,4 +1,5 @@
 #include "b24Color.h"
+#include <cstddef>
 
 namespace {
     constexpr ColorRGBA kB24ColorCLUT[][16] = {
@@ -147,25 +148,61 @@ namespace {
             ColorRGBA(255, 255,  85, 128)
         }
     };
+    // Exact search by squared distance over all CLUT entries; the first of equally close entries wins
+    std::pair<uint8_t, uint8_t> searchClosestColor(const ColorRGBA& color) {
+        uint8_t palette = 0;
+        uint8_t index = 0;
+        uint32_t distance = 0xFFFFFFFF;
+        for (uint8_t p = 0; p < 8; p++) {
+            for (uint8_t i = 0; i < 16; i++) {
+                int r = color.r - kB24ColorCLUT[p][i].r;
+                int g = color.g - kB24ColorCLUT[p][i].g;
+                int b = color.b - kB24ColorCLUT[p][i].b;
+                int a = color.a - kB24ColorCLUT[p][i].a;
+                uint32_t d = static_cast<uint32_t>(r * r + g * g + b * b + a * a);
+                if (d < distance) {
+                    distance = d;
+                    palette = p;
+                    index = i;
+                    if (d == 0) {
+                        return { palette, index };
+                    }
+                }
+            }
+        }
+        return { palette, index };
+    }
+
+    // Direct-mapped memo of resolved colors; a subtitle stream only uses a handful of them
+    struct ClosestColorCache {
+        static constexpr size_t kSize = 64;
+
+        struct Entry {
+            uint32_t color = 0;
+            uint8_t palette = 0;
+            uint8_t index = 0;
+            bool used = false;
+        };
+
+        Entry entries[kSize];
+    };
+
+    thread_local ClosestColorCache closestColorCache;
 }
 
 std::pair<uint8_t, uint8_t> findClosestColor(const ColorRGBA& color) {
-    uint8_t palette = 0;
-    uint8_t index = 0;
-	uint32_t distance = 0xFFFFFFFF;
-    for (uint8_t p = 0; p < 8; p++) {
-        for (uint8_t i = 0; i < 16; i++) {
-            uint8_t r = color.r - kB24ColorCLUT[p][i].r;
-            uint8_t g = color.g - kB24ColorCLUT[p][i].g;
-            uint8_t b = color.b - kB24ColorCLUT[p][i].b;
-            uint8_t a = color.a - kB24ColorCLUT[p][i].a;
-            uint32_t d = r * r + g * g + b * b + a * a;
-            if (d < distance) {
-                distance = d;
-                palette = p;
-                index = i;
-            }
-        }
+    uint32_t key = static_cast<uint32_t>(color.r) << 24 | static_cast<uint32_t>(color.g) << 16 |
+        static_cast<uint32_t>(color.b) << 8 | color.a;
+    ClosestColorCache::Entry& entry = closestColorCache.entries[(key * 0x9E3779B1u) >> 26];
+    if (entry.used && entry.color == key) {
+        return { entry.palette, entry.index };
     }
+
+    auto [palette, index] = searchClosestColor(color);
+    entry = { key, palette, index, true };
 	return { palette, index };
 }
+
+const ColorRGBA& getB24Color(uint8_t palette, uint8_t index) {
+    return kB24ColorCLUT[palette][index];
+}
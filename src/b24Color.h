@@ -11,4 +11,7 @@ struct ColorRGBA {
 	uint8_t a;
 };
 
+// Palette and index of the CLUT entry closest to color; the first of equally close entries wins
 std::pair<uint8_t, uint8_t> findClosestColor(const ColorRGBA& color);
+// Color of a CLUT entry
+const ColorRGBA& getB24Color(uint8_t palette, uint8_t index);
@@ -1,4 +1,5 @@
 ﻿#include "b24SubtitleConvertor.h"
+#include <algorithm>
 #include <vector>
 #include "aribUtil.h"
 #include "b24Color.h"
@@ -124,7 +124,9 @@ const bool CBonTuner::GetTsStream(uint8_t** ppDst, uint32_t* pdwSize, uint32_t*
 		return false;
 	}
 
-	outputBuffer = std::move(output);
+	// Swap instead of move so both buffers keep their capacity across calls.
+	outputBuffer.swap(output);
+	output.clear();
 
 	*ppDst = outputBuffer.data();
 	*pdwSize = static_cast<uint32_t>(outputBuffer.size());
@@ -140,6 +142,7 @@ void CBonTuner::PurgeTsStream(void)
 	output.clear();
 	
 	demuxer.clear();
+	handler.clear();
 
 	return pBonDriver2->PurgeTsStream();
 }
@@ -180,6 +183,7 @@ const bool CBonTuner::SetChannel(const uint32_t dwSpace, const uint32_t dwChanne
 	}
 
 	demuxer.clear();
+	handler.clear();
 
 	return pBonDriver2->SetChannel(dwSpace, dwChannel);
 }
@@ -197,5 +201,6 @@ const uint32_t CBonTuner::GetCurChannel(void)
 void CBonTuner::Release(void)
 {
 	demuxer.release();
+	handler.release();
 	return pBonDriver2->Release();
 }
@@ -10,6 +10,15 @@ static std::string trim(const std::string& str) {
     return str.substr(first, last - first + 1);
 }
 
+static void parseInterval(const std::string& value, uint32_t& interval) {
+    try {
+        interval = static_cast<uint32_t>(std::stoul(value));
+    }
+    catch (const std::logic_error&) {
+        std::cerr << "Invalid repetition interval: " << value << std::endl;
+    }
+}
+
 Config loadConfig(const std::string& filename)
 {
      Config config;
@@ -72,6 +81,64 @@ Config loadConfig(const std::string& filename)
                  }
              }
          }
+         if (currentSection == "buffer") {
+             size_t equalPos = line.find('=');
+             if (equalPos != std::string::npos) {
+                 std::string key = trim(line.substr(0, equalPos));
+                 std::string value = trim(line.substr(equalPos + 1));
+
+                 if (key == "useHugePages") {
+                     if (value == "true") {
+                         config.useHugePages = true;
+                     }
+                 }
+             }
+         }
+         if (currentSection == "si") {
+             size_t equalPos = line.find('=');
+             if (equalPos != std::string::npos) {
+                 std::string key = trim(line.substr(0, equalPos));
+                 std::string value = trim(line.substr(equalPos + 1));
+
+                 if (key == "useSiWorker") {
+                     if (value == "true") {
+                         config.useSiWorker = true;
+                     }
+                 }
+             }
+         }
+         if (currentSection == "repetition") {
+             size_t equalPos = line.find('=');
+             if (equalPos != std::string::npos) {
+                 std::string key = trim(line.substr(0, equalPos));
+                 std::string value = trim(line.substr(equalPos + 1));
+
+                 if (key == "pat") {
+                     parseInterval(value, config.patInterval);
+                 }
+                 if (key == "pmt") {
+                     parseInterval(value, config.pmtInterval);
+                 }
+                 if (key == "nit") {
+                     parseInterval(value, config.nitInterval);
+                 }
+                 if (key == "sdt") {
+                     parseInterval(value, config.sdtInterval);
+                 }
+                 if (key == "eitPf") {
+                     parseInterval(value, config.eitPfInterval);
+                 }
+                 if (key == "eitSchedule") {
+                     parseInterval(value, config.eitScheduleInterval);
+                 }
+                 if (key == "bit") {
+                     parseInterval(value, config.bitInterval);
+                 }
+                 if (key == "cdt") {
+                     parseInterval(value, config.cdtInterval);
+                 }
+             }
+         }
      }
 
      file.close();
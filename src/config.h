@@ -1,4 +1,5 @@
 #pragma once
+#include <cstdint>
 #include <string>
 #include <fstream>
 
@@ -8,6 +9,19 @@ public:
     std::string mmtsDumpPath{};
     std::string smartCardReaderName{};
     bool disableADTSConversion{false};
+    bool useHugePages{false};
+    // Converts SI tables on a background thread instead of the demuxer thread
+    bool useSiWorker{false};
+
+    // PSI/SI repetition intervals in milliseconds, 0 repeats each section as often as it arrives
+    uint32_t patInterval{100};
+    uint32_t pmtInterval{100};
+    uint32_t nitInterval{0};
+    uint32_t sdtInterval{0};
+    uint32_t eitPfInterval{0};
+    uint32_t eitScheduleInterval{0};
+    uint32_t bitInterval{0};
+    uint32_t cdtInterval{0};
 };
 
 Config loadConfig(const std::string& filename);
@@ -26,11 +26,10 @@ bool ContentCopyControlDescriptor::unpack(Common::ReadStream& stream)
             
             Common::ReadStream componentStream(nstream, componentControlLength);
             while (componentStream.isEof()) {
-                Component component;
+                Component& component = components.emplace_back();
                 if (!component.unpack(componentStream)) {
                     return false;
                 }
-                components.push_back(component);
             }
         }
 
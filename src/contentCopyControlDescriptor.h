@@ -1,12 +1,15 @@
 #pragma once
 #include "mmtDescriptorBase.h"
-#include <list>
+#include <memory_resource>
+#include <vector>
 
 namespace MmtTlv {
 
 class ContentCopyControlDescriptor
     : public MmtDescriptorTemplate<0x8038> {
 public:
+    explicit ContentCopyControlDescriptor(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : components(resource) {}
     bool unpack(Common::ReadStream& stream) override;
     
     class Component {
@@ -32,7 +35,7 @@ public:
 
     uint8_t componentControlLength;
 
-    std::list<Component> components;
+    std::pmr::vector<Component> components;
 };
 
 }
\ No newline at end of file
@@ -0,0 +1,167 @@
+#include "crc32.h"
+#include <array>
+
+#if defined(_M_X64) || defined(__x86_64__)
+#define CRC32_PCLMUL
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define CRC32_TARGET
+#else
+#define CRC32_TARGET __attribute__((target("pclmul,ssse3")))
+#endif
+#endif
+
+// ARMv8 CRC32 instructions only implement the reflected polynomial (CRC-32 and CRC-32C),
+// which cannot produce CRC-32/MPEG-2, so other architectures use the tables.
+
+namespace MmtTlv {
+
+namespace Common {
+
+namespace {
+
+constexpr uint32_t kPolynomial = 0x04C11DB7;
+
+using CrcTables = std::array<std::array<uint32_t, 256>, 16>;
+
+// tables[k][b]: CRC of byte b followed by k zero bytes
+constexpr CrcTables makeCrcTables() {
+	CrcTables tables{};
+	for (uint32_t i = 0; i < 256; i++) {
+		uint32_t crc = i << 24;
+		for (int bit = 0; bit < 8; bit++) {
+			crc = crc & 0x80000000 ? crc << 1 ^ kPolynomial : crc << 1;
+		}
+		tables[0][i] = crc;
+	}
+	for (size_t k = 1; k < tables.size(); k++) {
+		for (uint32_t i = 0; i < 256; i++) {
+			const uint32_t crc = tables[k - 1][i];
+			tables[k][i] = crc << 8 ^ tables[0][crc >> 24];
+		}
+	}
+	return tables;
+}
+
+constexpr CrcTables crcTables = makeCrcTables();
+
+uint32_t crc32Slice16(const uint8_t* data, size_t size, uint32_t crc)
+{
+	const auto& t = crcTables;
+	while (size >= 16) {
+		const uint32_t a = crc ^ (static_cast<uint32_t>(data[0]) << 24 | static_cast<uint32_t>(data[1]) << 16 |
+			static_cast<uint32_t>(data[2]) << 8 | data[3]);
+		crc = t[15][a >> 24] ^ t[14][(a >> 16) & 0xFF] ^ t[13][(a >> 8) & 0xFF] ^ t[12][a & 0xFF] ^
+			t[11][data[4]] ^ t[10][data[5]] ^ t[9][data[6]] ^ t[8][data[7]] ^
+			t[7][data[8]] ^ t[6][data[9]] ^ t[5][data[10]] ^ t[4][data[11]] ^
+			t[3][data[12]] ^ t[2][data[13]] ^ t[1][data[14]] ^ t[0][data[15]];
+		data += 16;
+		size -= 16;
+	}
+
+	while (size-- > 0) {
+		crc = crc << 8 ^ t[0][(crc >> 24) ^ *data++];
+	}
+	return crc;
+}
+
+#ifdef CRC32_PCLMUL
+
+// x^n mod P, for the folding constants
+constexpr uint64_t xPowMod(int n) {
+	uint32_t r = 1;
+	for (int i = 0; i < n; i++) {
+		r = r & 0x80000000 ? r << 1 ^ kPolynomial : r << 1;
+	}
+	return r;
+}
+
+// floor(x^64 / P), for the Barrett reduction
+constexpr uint64_t barrettMu() {
+	const uint64_t p = 0x100000000ull | kPolynomial;
+	uint64_t quotient = 0;
+	uint64_t remainder = 0;
+	// Long division, bringing down the bits of x^64 from the top
+	for (int bit = 64; bit >= 0; bit--) {
+		remainder = remainder << 1 | (bit == 64 ? 1 : 0);
+		if (remainder & 0x100000000ull) {
+			remainder ^= p;
+			quotient |= 1ull << bit;
+		}
+	}
+	return quotient;
+}
+
+CRC32_TARGET uint32_t crc32Pclmul(const uint8_t* data, size_t size, uint32_t crc)
+{
+	// Byte order of a big-endian 128-bit integer, first byte in the most significant position
+	const __m128i byteSwap = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+	// Folding 128 bits forward: high half times x^192, low half times x^128
+	const __m128i fold = _mm_set_epi64x(static_cast<long long>(xPowMod(192)), static_cast<long long>(xPowMod(128)));
+
+	// The running CRC goes into the first 4 bytes
+	__m128i x = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data)), byteSwap);
+	x = _mm_xor_si128(x, _mm_set_epi32(static_cast<int>(crc), 0, 0, 0));
+	data += 16;
+	size -= 16;
+
+	while (size >= 16) {
+		const __m128i next = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data)), byteSwap);
+		const __m128i high = _mm_clmulepi64_si128(x, fold, 0x11);
+		const __m128i low = _mm_clmulepi64_si128(x, fold, 0x00);
+		x = _mm_xor_si128(_mm_xor_si128(high, low), next);
+		data += 16;
+		size -= 16;
+	}
+
+	// x * x^32 mod P: first down to 96 bits, then 64 bits, then Barrett reduction
+	const __m128i k96 = _mm_cvtsi64_si128(static_cast<long long>(xPowMod(96)));
+	const __m128i k64 = _mm_cvtsi64_si128(static_cast<long long>(xPowMod(64)));
+	const __m128i mu = _mm_cvtsi64_si128(static_cast<long long>(barrettMu()));
+	const __m128i p = _mm_cvtsi64_si128(static_cast<long long>(0x100000000ull | kPolynomial));
+
+	__m128i y = _mm_clmulepi64_si128(x, k96, 0x01);
+	y = _mm_xor_si128(y, _mm_slli_si128(_mm_move_epi64(x), 4));
+
+	__m128i z = _mm_clmulepi64_si128(_mm_srli_si128(y, 8), k64, 0x00);
+	z = _mm_xor_si128(z, _mm_move_epi64(y));
+
+	__m128i t = _mm_clmulepi64_si128(_mm_srli_epi64(z, 32), mu, 0x00);
+	t = _mm_clmulepi64_si128(_mm_srli_epi64(t, 32), p, 0x00);
+	crc = static_cast<uint32_t>(_mm_cvtsi128_si32(_mm_xor_si128(z, t)));
+
+	return crc32Slice16(data, size, crc);
+}
+
+bool hasPclmul()
+{
+#ifdef _MSC_VER
+	int info[4];
+	__cpuid(info, 1);
+	return (info[2] & (1 << 1)) && (info[2] & (1 << 9)); // PCLMULQDQ, SSSE3
+#else
+	return __builtin_cpu_supports("pclmul") && __builtin_cpu_supports("ssse3");
+#endif
+}
+
+const bool usePclmul = hasPclmul();
+
+#endif
+
+}
+
+uint32_t crc32Mpeg2(const uint8_t* data, size_t size, uint32_t crc)
+{
+#ifdef CRC32_PCLMUL
+	// Folding only pays off past a few blocks
+	if (usePclmul && size >= 64) {
+		return crc32Pclmul(data, size, crc);
+	}
+#endif
+	return crc32Slice16(data, size, crc);
+}
+
+}
+
+}
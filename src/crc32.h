@@ -0,0 +1,21 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+namespace MmtTlv {
+
+namespace Common {
+
+// CRC-32/MPEG-2 (polynomial 0x04C11DB7, initial value 0xFFFFFFFF, no reflection, no final XOR),
+// as used by the CRC_32 field of MPEG-2 and MMT-SI sections.
+// Runs on PCLMULQDQ when the CPU has it, and slice-by-16 tables otherwise.
+uint32_t crc32Mpeg2(const uint8_t* data, size_t size, uint32_t crc = 0xFFFFFFFF);
+
+// Checks a whole section ending with its CRC_32: the CRC over the section, CRC_32 included, is 0.
+inline bool checkCrc32Mpeg2(const uint8_t* section, size_t size) {
+	return size >= 4 && crc32Mpeg2(section, size) == 0;
+}
+
+}
+
+}
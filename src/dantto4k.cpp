@@ -10,7 +10,7 @@
 #endif
 #include "aribUtil.h"
 
-MmtTlv::MmtTlvDemuxer demuxer;
+MmtTlv::MmtTlvDemuxer<RemuxerHandler> demuxer;
 std::vector<uint8_t> output;
 RemuxerHandler handler(demuxer, output);
 
@@ -38,7 +38,9 @@ extern "C" __declspec(dllexport) IBonDriver* CreateBonDriver() {
 
         demuxer.setDemuxerHandler(handler);
         demuxer.setSmartCardReaderName(config.smartCardReaderName);
+        demuxer.setUseHugePages(config.useHugePages);
         demuxer.init();
+        handler.setRepetitionIntervals(config);
 
         bonTuner.init();
     }
@@ -176,6 +178,21 @@ int main(int argc, char* argv[]) {
         if (arg == "--disableADTSConversion") {
             config.disableADTSConversion = true;
         }
+        else if (arg == "--useHugePages") {
+            config.useHugePages = true;
+        }
+        else if (arg == "--useSiWorker") {
+            config.useSiWorker = true;
+        }
+        else if (arg.find("--psiInterval=") == 0) {
+            try {
+                config.patInterval = config.pmtInterval = std::stoul(arg.substr(std::string("--psiInterval=").length()));
+            }
+            catch (const std::logic_error&) {
+                std::cerr << "Invalid PSI interval: " << arg << std::endl;
+                return 1;
+            }
+        }
         else if (arg.find("--smartCardReaderName=") == 0) {
             config.smartCardReaderName = arg.substr(std::string("--smartCardReaderName=").length());
         }
@@ -204,8 +221,11 @@ int main(int argc, char* argv[]) {
         std::cerr << "\t'-' can be used instead of a file path to enable piping via stdin or stdout." << std::endl;
         std::cerr << "options:" << std::endl;
         std::cerr << "\t--disableADTSConversion: Uses the raw LATM format without converting to ADTS." << std::endl;
+        std::cerr << "\t--psiInterval=<ms>: Sets the PAT/PMT repetition interval (default: 100, 0: as often as the MPT/PLT arrives). It is checked at each NTP packet, so it is no shorter than the NTP interval." << std::endl;
         std::cerr << "\t--listSmartCardReader: Lists the available smart card readers." << std::endl;
         std::cerr << "\t--smartCardReaderName=<name>: Sets the smart card reader to use." << std::endl;
+        std::cerr << "\t--useHugePages: Backs large frame buffers with transparent huge pages (Linux only)." << std::endl;
+        std::cerr << "\t--useSiWorker: Converts EIT, SDT, BIT, CDT and NIT on a background thread." << std::endl;
         return 1;
     }
 
@@ -239,7 +259,9 @@ int main(int argc, char* argv[]) {
 
     demuxer.setDemuxerHandler(handler);
     demuxer.setSmartCardReaderName(config.smartCardReaderName);
+    demuxer.setUseHugePages(config.useHugePages);
     demuxer.init();
+    handler.setRepetitionIntervals(config);
 
     std::vector<uint8_t> inputBuffer;
     inputBuffer.reserve(chunkSize * 2);
@@ -281,12 +303,24 @@ int main(int argc, char* argv[]) {
         output.clear();
     }
 
+    handler.flush();
+    if (useStdout) {
+        std::cout.write(reinterpret_cast<const char*>(output.data()), output.size());
+    }
+    else {
+        outputFs->write(reinterpret_cast<const char*>(output.data()), output.size());
+    }
+    output.clear();
+
     auto end = std::chrono::high_resolution_clock::now();
     std::chrono::duration<double> elapsed_seconds = end - start;
 
     demuxer.printStatistics();
+    handler.printStatistics();
     demuxer.clear();
+    handler.clear();
     demuxer.release();
+    handler.release();
 
     std::cerr << "Elapsed time: " << elapsed_seconds.count() << " seconds\n";
     return 0;
@@ -1,9 +1,11 @@
 #pragma once
 #include "mmtTlvDemuxer.h"
+#include "remuxerHandler.h"
 #include <mutex>
 
-extern MmtTlv::MmtTlvDemuxer demuxer;
+extern MmtTlv::MmtTlvDemuxer<RemuxerHandler> demuxer;
 extern std::vector<uint8_t> output;
+extern RemuxerHandler handler;
 
 #ifdef _WIN32
 LONG WINAPI ExceptionHandler(EXCEPTION_POINTERS* exceptionInfo);
@@ -21,10 +21,11 @@ public:
 	virtual ~DemuxerHandler() = default;
 
 	// MPU data
-	virtual void onVideoData(const std::shared_ptr<MmtStream> mmtStream, const std::shared_ptr<struct MfuData>& mfuData) {}
-	virtual void onAudioData(const std::shared_ptr<MmtStream> mmtStream, const std::shared_ptr<struct MfuData>& mfuData) {}
-	virtual void onSubtitleData(const std::shared_ptr<MmtStream> mmtStream, const std::shared_ptr<struct MfuData>& mfuData) {}
-	virtual void onApplicationData(const std::shared_ptr<MmtStream> mmtStream, const std::shared_ptr<struct MfuData>& mfuData) {}
+	// The frame buffer in mfuData is returned to the stream's buffer pool after the call unless the handler moves it away.
+	virtual void onVideoData(const std::shared_ptr<MmtStream>& mmtStream, MfuData&& mfuData) {}
+	virtual void onAudioData(const std::shared_ptr<MmtStream>& mmtStream, MfuData&& mfuData) {}
+	virtual void onSubtitleData(const std::shared_ptr<MmtStream>& mmtStream, MfuData&& mfuData) {}
+	virtual void onApplicationData(const std::shared_ptr<MmtStream>& mmtStream, MfuData&& mfuData) {}
 
 	// MMT-SI
 	virtual void onEcm(const std::shared_ptr<Ecm>& ecm) {}
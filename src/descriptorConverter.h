@@ -22,6 +22,8 @@
 #include "mhServiceDescriptor.h"
 #include "aribUtil.h"
 #include "timeUtil.h"
+#include "tsSectionWriter.h"
+#include <type_traits>
 
 constexpr uint8_t convertAudioComponentType(uint8_t componentType) {
     uint8_t audioMode = componentType & 0b00011111;
@@ -73,12 +75,12 @@ struct DescriptorConverter;
 
 template <>
 struct DescriptorConverter<MmtTlv::MhShortEventDescriptor> {
-    static std::optional<std::vector<uint8_t>> convert(const MmtTlv::MhShortEventDescriptor& mmtDescriptor) {
+    static bool write(const MmtTlv::MhShortEventDescriptor& mmtDescriptor, TsSectionWriter& writer) {
         const ts::ByteBlock eventNameBlock = aribEncode(mmtDescriptor.eventName);
         ts::ByteBlock textBlock = aribEncode(mmtDescriptor.text);
 
-        if (eventNameBlock.size() > 257) {
-            return std::nullopt;
+        if (eventNameBlock.size() > 255) {
+            return false;
         }
 
         size_t descriptorLength = 1 // descriptor_tag
@@ -92,264 +94,182 @@ struct DescriptorConverter<MmtTlv::MhShortEventDescriptor> {
         // cut the text if the descriptor length is exceeded
         if (descriptorLength > 257) {
             if (descriptorLength - textBlock.size() > 257) {
-                return std::nullopt;
+                return false;
             }
 
             textBlock.resize(257 - (descriptorLength - textBlock.size()));
-
-            descriptorLength = 1 // descriptor_tag
-                + 1 // descriptor_length
-                + 3 // language
-                + 1 // event_name_length
-                + eventNameBlock.size() // event_name
-                + 1 // text_length
-                + textBlock.size();
-        }
-
-        std::vector<uint8_t> tsDescriptor(descriptorLength);
-        tsDescriptor[0] = 0x4D; // descriptor_tag
-        tsDescriptor[1] = static_cast<uint8_t>(descriptorLength) - 2; // descriptor_length
-
-        memcpy(&tsDescriptor[2], mmtDescriptor.language, 3); // language
-
-        tsDescriptor[5] = static_cast<uint8_t>(eventNameBlock.size()); // event_name_length
-        if (eventNameBlock.size()) {
-            memcpy(&tsDescriptor[6], eventNameBlock.data(), eventNameBlock.size()); // event_name
         }
 
-        tsDescriptor[6 + eventNameBlock.size()] = static_cast<uint8_t>(textBlock.size()); // text_length
-        if (textBlock.size()) {
-            memcpy(&tsDescriptor[6 + eventNameBlock.size() + 1], textBlock.data(), textBlock.size()); // text
-        }
-
-        return tsDescriptor;
+        const size_t position = writer.beginDescriptor(0x4D);
+        writer.putBytes(mmtDescriptor.language, 3); // language
+        writer.putUInt8(static_cast<uint8_t>(eventNameBlock.size())); // event_name_length
+        writer.putBytes(eventNameBlock.data(), eventNameBlock.size()); // event_name
+        writer.putUInt8(static_cast<uint8_t>(textBlock.size())); // text_length
+        writer.putBytes(textBlock.data(), textBlock.size()); // text
+        return writer.endDescriptor(position);
     }
 };
 
 template <>
 struct DescriptorConverter<MmtTlv::MhExtendedEventDescriptor> {
-    static std::optional<std::vector<uint8_t>> convert(const MmtTlv::MhExtendedEventDescriptor& mmtDescriptor) {
+    static bool write(const MmtTlv::MhExtendedEventDescriptor& mmtDescriptor, TsSectionWriter& writer) {
         const ts::ByteBlock textBlock = aribEncode(mmtDescriptor.textChar);
 
         if (textBlock.size() > 255) {
-            return std::nullopt;
+            return false;
         }
 
-        std::vector<ts::ByteBlock> aribItemDescriptionChars;
-        std::vector<ts::ByteBlock> aribItemChars;
-
-        size_t descriptorLength = 1 // descriptor_tag
-            + 1 // descriptor_length
-            + 1 // descriptorNumber | lastDescriptorNumber
-            + 3 // language
-            + 1; // length_of_items
+        const size_t position = writer.beginDescriptor(0x4E);
+        writer.putUInt8((mmtDescriptor.descriptorNumber & 0b1111) << 4 | (mmtDescriptor.lastDescriptorNumber & 0b1111));
+        writer.putBytes(mmtDescriptor.language, 3);
 
-        size_t itemsLength = 0;
+        const size_t itemsPosition = writer.size();
+        writer.putUInt8(0); // length_of_items (patched)
         for (const auto& item : mmtDescriptor.entries) {
             const ts::ByteBlock itemDescriptionCharBlock = aribEncode(item.itemDescriptionChar);
             const ts::ByteBlock itemCharBlock = aribEncode(item.itemChar);
 
-            if (itemDescriptionCharBlock.size() > 255) {
-                return std::nullopt;
-            }
-
-            if (itemCharBlock.size() > 255) {
-                return std::nullopt;
+            if (itemDescriptionCharBlock.size() > 255 || itemCharBlock.size() > 255) {
+                writer.truncate(position);
+                return false;
             }
 
-            aribItemDescriptionChars.push_back(itemDescriptionCharBlock);
-            aribItemChars.push_back(itemCharBlock);
-
-            itemsLength += 1 + itemDescriptionCharBlock.size() + 1 + itemCharBlock.size();
+            writer.putUInt8(static_cast<uint8_t>(itemDescriptionCharBlock.size()));
+            writer.putBytes(itemDescriptionCharBlock.data(), itemDescriptionCharBlock.size());
+            writer.putUInt8(static_cast<uint8_t>(itemCharBlock.size()));
+            writer.putBytes(itemCharBlock.data(), itemCharBlock.size());
         }
 
+        const size_t itemsLength = writer.size() - itemsPosition - 1;
         if (itemsLength > 255) {
-            return std::nullopt;
-        }
-
-        descriptorLength += itemsLength
-            + 1 // text_length
-            + textBlock.size(); // text
-
-        if (descriptorLength > 255) {
-            return std::nullopt;
-        }
-
-        std::vector<uint8_t> tsDescriptor(descriptorLength);
-        tsDescriptor[0] = 0x4E;
-        tsDescriptor[1] = static_cast<uint8_t>(descriptorLength) - 2;
-        tsDescriptor[2] = (mmtDescriptor.descriptorNumber & 0b1111) << 4 | (mmtDescriptor.lastDescriptorNumber & 0b1111);
-        memcpy(&tsDescriptor[3], mmtDescriptor.language, 3);
-
-        tsDescriptor[6] = static_cast<uint8_t>(itemsLength);
-
-        size_t pos = 0;
-        for (size_t i = 0; i < mmtDescriptor.entries.size(); ++i) {
-            tsDescriptor[7 + pos] = static_cast<uint8_t>(aribItemDescriptionChars[i].size());
-            pos++;
-
-            if (aribItemDescriptionChars[i].size()) {
-                memcpy(&tsDescriptor[7 + pos], aribItemDescriptionChars[i].data(), aribItemDescriptionChars[i].size());
-                pos += aribItemDescriptionChars[i].size();
-            }
-
-            tsDescriptor[7 + pos] = static_cast<uint8_t>(aribItemChars[i].size());
-            pos++;
-
-            if (aribItemChars[i].size()) {
-                memcpy(&tsDescriptor[7 + pos], aribItemChars[i].data(), aribItemChars[i].size());
-                pos += aribItemChars[i].size();
-            }
-
-            i++;
+            writer.truncate(position);
+            return false;
         }
+        writer.patchUInt8(itemsPosition, static_cast<uint8_t>(itemsLength));
 
-        tsDescriptor[7 + pos] = static_cast<uint8_t>(textBlock.size());
-        pos++;
-
-        if (textBlock.size()) {
-            memcpy(&tsDescriptor[7 + pos], textBlock.data(), textBlock.size());
-        }
-
-        return tsDescriptor;
+        writer.putUInt8(static_cast<uint8_t>(textBlock.size()));
+        writer.putBytes(textBlock.data(), textBlock.size());
+        return writer.endDescriptor(position);
     }
 };
 
 template <>
 struct DescriptorConverter<MmtTlv::MhAudioComponentDescriptor> {
-    static ts::AudioComponentDescriptor convert(const MmtTlv::MhAudioComponentDescriptor& mmtDescriptor) {
-        ts::AudioComponentDescriptor tsDescriptor;
-        tsDescriptor.stream_content = 2; // audio
-        tsDescriptor.component_type = convertAudioComponentType(mmtDescriptor.componentType);
-        tsDescriptor.component_tag = static_cast<uint8_t>(mmtDescriptor.componentTag);
-        tsDescriptor.stream_type = 0x0F; // ISO/IEC13818-7 audio
-        tsDescriptor.simulcast_group_tag = mmtDescriptor.simulcastGroupTag;
+    static bool write(const MmtTlv::MhAudioComponentDescriptor& mmtDescriptor, TsSectionWriter& writer) {
+        const size_t position = writer.beginDescriptor(0xC4);
+        writer.putUInt8(0xF0 | 2); // reserved_future_use, stream_content (audio)
+        writer.putUInt8(convertAudioComponentType(mmtDescriptor.componentType));
+        writer.putUInt8(static_cast<uint8_t>(mmtDescriptor.componentTag));
+        writer.putUInt8(0x0F); // stream_type: ISO/IEC13818-7 audio
+        writer.putUInt8(mmtDescriptor.simulcastGroupTag);
+        writer.putUInt8((mmtDescriptor.esMultiLingualFlag ? 0x80 : 0x00) |
+            (mmtDescriptor.mainComponentFlag ? 0x40 : 0x00) |
+            (mmtDescriptor.qualityIndicator & 0b11) << 4 |
+            convertAudioSamplingRate(mmtDescriptor.samplingRate) << 1 |
+            0x01); // reserved_future_use
+        writer.putBytes(mmtDescriptor.language1, 3);
         if (mmtDescriptor.esMultiLingualFlag) {
-            tsDescriptor.ISO_639_language_code_2 = ts::UString::FromUTF8(mmtDescriptor.language2);
+            writer.putBytes(mmtDescriptor.language2, 3);
         }
 
-        tsDescriptor.main_component = mmtDescriptor.mainComponentFlag;
-        tsDescriptor.quality_indicator = mmtDescriptor.qualityIndicator;
-        tsDescriptor.sampling_rate = convertAudioSamplingRate(mmtDescriptor.samplingRate);
-        tsDescriptor.ISO_639_language_code = ts::UString::FromUTF8(mmtDescriptor.language1);
-
         const ts::ByteBlock textBlock = aribEncode(mmtDescriptor.text);
-        tsDescriptor.text = ts::UString::FromUTF8(reinterpret_cast<const char*>(textBlock.data()), textBlock.size());
-        return tsDescriptor;
+        writer.putBytes(textBlock.data(), textBlock.size());
+        return writer.endDescriptor(position);
     }
 };
 
 template <>
 struct DescriptorConverter<MmtTlv::VideoComponentDescriptor> {
-    static ts::ComponentDescriptor convert(const MmtTlv::VideoComponentDescriptor& mmtDescriptor) {
-        ts::ComponentDescriptor tsDescriptor;
-        tsDescriptor.stream_content = 1; // video
-        tsDescriptor.component_type = convertVideoComponentType(mmtDescriptor.videoResolution, mmtDescriptor.videoAspectRatio);
-        tsDescriptor.language_code = ts::UString::FromUTF8(mmtDescriptor.language);
+    static bool write(const MmtTlv::VideoComponentDescriptor& mmtDescriptor, TsSectionWriter& writer) {
+        const size_t position = writer.beginDescriptor(0x50);
+        writer.putUInt8(0xF0 | 1); // stream_content_ext, stream_content (video)
+        writer.putUInt8(convertVideoComponentType(mmtDescriptor.videoResolution, mmtDescriptor.videoAspectRatio));
+        writer.putUInt8(0); // component_tag
+        writer.putBytes(mmtDescriptor.language, 3);
 
         const ts::ByteBlock textBlock = aribEncode(mmtDescriptor.text);
-        tsDescriptor.text = ts::UString::FromUTF8(reinterpret_cast<const char*>(textBlock.data()), textBlock.size());
-        return tsDescriptor;
+        writer.putBytes(textBlock.data(), textBlock.size());
+        return writer.endDescriptor(position);
     }
 };
 
 template <>
 struct DescriptorConverter<MmtTlv::MhContentDescriptor> {
-    static ts::ContentDescriptor convert(const MmtTlv::MhContentDescriptor& mmtDescriptor) {
-        ts::ContentDescriptor tsDescriptor;
-
+    static bool write(const MmtTlv::MhContentDescriptor& mmtDescriptor, TsSectionWriter& writer) {
+        const size_t position = writer.beginDescriptor(0x54);
         for (auto& item : mmtDescriptor.entries) {
-            ts::ContentDescriptor::Entry entry;
-            entry.content_nibble_level_1 = item.contentNibbleLevel1;
-            entry.content_nibble_level_2 = item.contentNibbleLevel2;
-            entry.user_nibble_1 = item.userNibble1;
-            entry.user_nibble_2 = item.userNibble2;
-            tsDescriptor.entries.push_back(entry);
+            writer.putUInt8((item.contentNibbleLevel1 & 0x0F) << 4 | (item.contentNibbleLevel2 & 0x0F));
+            writer.putUInt8((item.userNibble1 & 0x0F) << 4 | (item.userNibble2 & 0x0F));
         }
-        return tsDescriptor;
+        return writer.endDescriptor(position);
     }
 };
 
 template <>
 struct DescriptorConverter<MmtTlv::MhLinkageDescriptor> {
-    static ts::LinkageDescriptor convert(const MmtTlv::MhLinkageDescriptor& mmtDescriptor) {
-        ts::LinkageDescriptor tsDescriptor(mmtDescriptor.tlvStreamId, mmtDescriptor.originalNetworkId, mmtDescriptor.serviceId, mmtDescriptor.linkageType);
-        return tsDescriptor;
+    static bool write(const MmtTlv::MhLinkageDescriptor& mmtDescriptor, TsSectionWriter& writer) {
+        const size_t position = writer.beginDescriptor(0x4A);
+        writer.putUInt16(mmtDescriptor.tlvStreamId); // transport_stream_id
+        writer.putUInt16(mmtDescriptor.originalNetworkId);
+        writer.putUInt16(mmtDescriptor.serviceId);
+        writer.putUInt8(mmtDescriptor.linkageType);
+        return writer.endDescriptor(position);
     }
 };
 
 template <>
 struct DescriptorConverter<MmtTlv::MhEventGroupDescriptor> {
-    static ts::EventGroupDescriptor convert(const MmtTlv::MhEventGroupDescriptor& mmtDescriptor) {
-        ts::EventGroupDescriptor tsDescriptor;
-        tsDescriptor.group_type = mmtDescriptor.groupType;
+    static bool write(const MmtTlv::MhEventGroupDescriptor& mmtDescriptor, TsSectionWriter& writer) {
+        const size_t position = writer.beginDescriptor(0xD6);
+        writer.putUInt8((mmtDescriptor.groupType & 0x0F) << 4 | (mmtDescriptor.events.size() & 0x0F));
 
         for (const auto& event : mmtDescriptor.events) {
-            ts::EventGroupDescriptor::ActualEvent actualEvent;
-            actualEvent.service_id = event.serviceId;
-            actualEvent.event_id = event.eventId;
-            tsDescriptor.actual_events.push_back(actualEvent);
+            writer.putUInt16(event.serviceId);
+            writer.putUInt16(event.eventId);
         }
 
-        for (const auto& otherNetworkEvent : mmtDescriptor.otherNetworkEvents) {
-            ts::EventGroupDescriptor::OtherEvent otherEvent;
-            otherEvent.original_network_id = otherNetworkEvent.originalNetworkId;
-            otherEvent.transport_stream_id = otherNetworkEvent.tlvStreamId;
-            otherEvent.service_id = otherNetworkEvent.serviceId;
-            otherEvent.event_id = otherNetworkEvent.eventId;
-            tsDescriptor.other_events.push_back(otherEvent);
+        // Events in other networks only exist for group types 4 and 5, private data otherwise
+        if (mmtDescriptor.groupType == 4 || mmtDescriptor.groupType == 5) {
+            for (const auto& otherNetworkEvent : mmtDescriptor.otherNetworkEvents) {
+                writer.putUInt16(otherNetworkEvent.originalNetworkId);
+                writer.putUInt16(otherNetworkEvent.tlvStreamId); // transport_stream_id
+                writer.putUInt16(otherNetworkEvent.serviceId);
+                writer.putUInt16(otherNetworkEvent.eventId);
+            }
         }
-
-        tsDescriptor.private_data.resize(mmtDescriptor.privateDataByte.size());
-        if (mmtDescriptor.privateDataByte.size()) {
-            memcpy(tsDescriptor.private_data.data(), mmtDescriptor.privateDataByte.data(), mmtDescriptor.privateDataByte.size());
+        else {
+            writer.putBytes(mmtDescriptor.privateDataByte.data(), mmtDescriptor.privateDataByte.size());
         }
-        return tsDescriptor;
+        return writer.endDescriptor(position);
     }
 };
 
 template <>
 struct DescriptorConverter<MmtTlv::MhParentalRatingDescriptor> {
-    static ts::ParentalRatingDescriptor convert(const MmtTlv::MhParentalRatingDescriptor& mmtDescriptor) {
-        ts::ParentalRatingDescriptor tsDescriptor;
-
+    static bool write(const MmtTlv::MhParentalRatingDescriptor& mmtDescriptor, TsSectionWriter& writer) {
+        const size_t position = writer.beginDescriptor(0x55);
         for (const auto& entry : mmtDescriptor.entries) {
-            ts::UString countryCode = ts::UString::FromUTF8(entry.countryCode);
-            ts::ParentalRatingDescriptor::Entry tsEntry(countryCode, entry.rating);
-            tsDescriptor.entries.push_back(tsEntry);
+            writer.putBytes(entry.countryCode, 3);
+            writer.putUInt8(entry.rating);
         }
-
-        return tsDescriptor;
+        return writer.endDescriptor(position);
     }
 };
 
 template <>
 struct DescriptorConverter<MmtTlv::MhSeriesDescriptor> {
-    static ts::SeriesDescriptor convert(const MmtTlv::MhSeriesDescriptor& mmtDescriptor) {
-        ts::SeriesDescriptor tsDescriptor;
-        tsDescriptor.series_id = mmtDescriptor.seriesId;
-        tsDescriptor.repeat_label = mmtDescriptor.repeatLabel;
-        tsDescriptor.program_pattern = mmtDescriptor.programPattern;
-
-        if (mmtDescriptor.expireDateValidFlag) {
-            struct tm tm;
-            EITDecodeMjd(mmtDescriptor.expireDate, &tm.tm_year, &tm.tm_mon, &tm.tm_mday);
-
-            try {
-                tsDescriptor.expire_date = ts::Time(tm.tm_year, tm.tm_mon, tm.tm_mday, 0, 0);
-            }
-            catch (const ts::Time::TimeError&) {
-                return {};
-            }
-        }
-
-        tsDescriptor.episode_number = mmtDescriptor.episodeNumber;
-        tsDescriptor.last_episode_number = mmtDescriptor.lastEpisodeNumber;
+    static bool write(const MmtTlv::MhSeriesDescriptor& mmtDescriptor, TsSectionWriter& writer) {
+        const size_t position = writer.beginDescriptor(0xD5);
+        writer.putUInt16(mmtDescriptor.seriesId);
+        writer.putUInt8((mmtDescriptor.repeatLabel & 0x0F) << 4 | (mmtDescriptor.programPattern & 0x07) << 1 |
+            (mmtDescriptor.expireDateValidFlag ? 1 : 0));
+        // Both use the same 16-bit MJD
+        writer.putUInt16(mmtDescriptor.expireDateValidFlag ? mmtDescriptor.expireDate : 0xFFFF);
+        writer.putUInt24((mmtDescriptor.episodeNumber & 0x0FFF) << 12 | (mmtDescriptor.lastEpisodeNumber & 0x0FFF));
 
         const ts::ByteBlock seriesNameBlock = aribEncode(mmtDescriptor.seriesNameChar);
-        tsDescriptor.series_name = ts::UString::FromUTF8(reinterpret_cast<const char*>(seriesNameBlock.data()), seriesNameBlock.size());
-
-        return tsDescriptor;
+        writer.putBytes(seriesNameBlock.data(), seriesNameBlock.size());
+        return writer.endDescriptor(position);
     }
 };
 
@@ -376,62 +296,104 @@ struct DescriptorConverter<MmtTlv::ContentCopyControlDescriptor> {
 
         return tsDescriptor;
     }
+
+    static bool write(const MmtTlv::ContentCopyControlDescriptor& mmtDescriptor, TsSectionWriter& writer) {
+        const size_t position = writer.beginDescriptor(0xC1);
+        // copy_control_type 00 is followed by reserved bits
+        writer.putUInt8((mmtDescriptor.digitalRecordingControlData & 0b11) << 6 |
+            (mmtDescriptor.maximumBitrateFlag ? 0x20 : 0x00) |
+            (!mmtDescriptor.components.empty() ? 0x10 : 0x00) |
+            0x03);
+        if (mmtDescriptor.maximumBitrateFlag) {
+            writer.putUInt8(mmtDescriptor.maximumBitrate);
+        }
+
+        if (!mmtDescriptor.components.empty()) {
+            const size_t componentsPosition = writer.size();
+            writer.putUInt8(0); // component_control_length (patched)
+            for (const auto& component : mmtDescriptor.components) {
+                writer.putUInt8(static_cast<uint8_t>(component.componentTag));
+                writer.putUInt8((component.digitalRecordingControlData & 0b11) << 6 |
+                    (component.maximumBitrateFlag ? 0x20 : 0x00) |
+                    0x13); // reserved_future_use, copy_control_type 00, reserved
+                if (component.maximumBitrateFlag) {
+                    writer.putUInt8(component.maximumBitrate);
+                }
+            }
+            writer.patchUInt8(componentsPosition, static_cast<uint8_t>(writer.size() - componentsPosition - 1));
+        }
+        return writer.endDescriptor(position);
+    }
 };
 
 template <>
 struct DescriptorConverter<MmtTlv::MultimediaServiceInformationDescriptor> {
-    static ts::DataContentDescriptor convert(const MmtTlv::MultimediaServiceInformationDescriptor& mmtDescriptor) {
-        ts::DataContentDescriptor tsDescriptor;
-        tsDescriptor.data_component_id = mmtDescriptor.dataComponentId;
+    static bool write(const MmtTlv::MultimediaServiceInformationDescriptor& mmtDescriptor, TsSectionWriter& writer) {
+        const size_t position = writer.beginDescriptor(0xC7);
+        writer.putUInt16(mmtDescriptor.dataComponentId);
+        writer.putUInt8(0); // entry_component
+        writer.putUInt8(static_cast<uint8_t>(mmtDescriptor.selectorByte.size()));
+        writer.putBytes(mmtDescriptor.selectorByte.data(), mmtDescriptor.selectorByte.size());
+        writer.putUInt8(0); // num_of_component_ref
 
         if (mmtDescriptor.dataComponentId == 0x0020) {
-            tsDescriptor.ISO_639_language_code = ts::UString::FromUTF8(mmtDescriptor.language);
+            writer.putBytes(mmtDescriptor.language, 3);
 
             const ts::ByteBlock textBlock = aribEncode(mmtDescriptor.text);
-            tsDescriptor.text = ts::UString::FromUTF8(reinterpret_cast<const char*>(textBlock.data()), textBlock.size());
+            if (textBlock.size() > 255) {
+                writer.truncate(position);
+                return false;
+            }
+            writer.putUInt8(static_cast<uint8_t>(textBlock.size()));
+            writer.putBytes(textBlock.data(), textBlock.size());
         }
-
-        tsDescriptor.selector_bytes.resize(mmtDescriptor.selectorByte.size());
-        if (mmtDescriptor.selectorByte.size()) {
-            memcpy(tsDescriptor.selector_bytes.data(), mmtDescriptor.selectorByte.data(), mmtDescriptor.selectorByte.size());
+        else {
+            writer.putUInt24(0); // ISO_639_language_code
+            writer.putUInt8(0); // text_length
         }
-
-        return tsDescriptor;
+        return writer.endDescriptor(position);
     }
 };
 
 template <>
 struct DescriptorConverter<MmtTlv::MhServiceDescriptor> {
-    static ts::ServiceDescriptor convert(const MmtTlv::MhServiceDescriptor& mmtDescriptor) {
+    static bool write(const MmtTlv::MhServiceDescriptor& mmtDescriptor, TsSectionWriter& writer) {
         const ts::ByteBlock serviceProviderName = aribEncode(mmtDescriptor.serviceProviderName);
         const ts::ByteBlock serviceName(ts::ARIBCharset::B24.encoded(
             ts::UString::FromUTF8(mmtDescriptor.serviceName.data(), mmtDescriptor.serviceName.size())));
 
-        ts::ServiceDescriptor tsDescriptor(1,
-            ts::UString::FromUTF8((char*)serviceProviderName.data(), serviceProviderName.size()),
-            ts::UString::FromUTF8((char*)serviceName.data(), serviceName.size()));
-        return tsDescriptor;
+        if (serviceProviderName.size() > 255 || serviceName.size() > 255) {
+            return false;
+        }
+
+        const size_t position = writer.beginDescriptor(0x48);
+        writer.putUInt8(1); // service_type: digital TV
+        writer.putUInt8(static_cast<uint8_t>(serviceProviderName.size()));
+        writer.putBytes(serviceProviderName.data(), serviceProviderName.size());
+        writer.putUInt8(static_cast<uint8_t>(serviceName.size()));
+        writer.putBytes(serviceName.data(), serviceName.size());
+        return writer.endDescriptor(position);
     }
 };
 
 template <>
 struct DescriptorConverter<MmtTlv::MhLogoTransmissionDescriptor> {
-    static ts::LogoTransmissionDescriptor convert(const MmtTlv::MhLogoTransmissionDescriptor& mmtDescriptor) {
-        ts::LogoTransmissionDescriptor tsDescriptor;
-        tsDescriptor.logo_transmission_type = mmtDescriptor.logoTransmissionType;
+    static bool write(const MmtTlv::MhLogoTransmissionDescriptor& mmtDescriptor, TsSectionWriter& writer) {
+        const size_t position = writer.beginDescriptor(0xCF);
+        writer.putUInt8(mmtDescriptor.logoTransmissionType);
         if (mmtDescriptor.logoTransmissionType == 0x01) {
-            tsDescriptor.logo_id = mmtDescriptor.logoId;
-            tsDescriptor.logo_version = mmtDescriptor.logoVersion;
-            tsDescriptor.download_data_id = mmtDescriptor.downloadDataId;
+            writer.putUInt16(0xFE00 | (mmtDescriptor.logoId & 0x01FF));
+            writer.putUInt16(0xF000 | (mmtDescriptor.logoVersion & 0x0FFF));
+            writer.putUInt16(mmtDescriptor.downloadDataId);
         }
         else if (mmtDescriptor.logoTransmissionType == 0x02) {
-            tsDescriptor.logo_id = mmtDescriptor.logoId;
+            writer.putUInt16(0xFE00 | (mmtDescriptor.logoId & 0x01FF));
         }
         else if (mmtDescriptor.logoTransmissionType == 0x03) {
             const ts::ByteBlock logoCharBlock = aribEncode(mmtDescriptor.logoChar);
-            tsDescriptor.logo_char = ts::UString::FromUTF8(reinterpret_cast<const char*>(logoCharBlock.data()), logoCharBlock.size());
+            writer.putBytes(logoCharBlock.data(), logoCharBlock.size());
         }
-        return tsDescriptor;
+        return writer.endDescriptor(position);
     }
 };
 
@@ -481,3 +443,21 @@ struct DescriptorConverter<MmtTlv::ServiceListDescriptor> {
     }
 };
 
+// Visitor for MmtDescriptors::visit that writes each of the listed descriptor classes
+// through its DescriptorConverter and leaves the other descriptors out
+template <typename... Descriptors>
+class DescriptorWriter {
+public:
+    explicit DescriptorWriter(TsSectionWriter& writer)
+        : writer(writer) {}
+
+    template <typename Descriptor>
+        requires (std::is_same_v<Descriptor, Descriptors> || ...)
+    void operator()(const Descriptor& descriptor) const {
+        DescriptorConverter<Descriptor>::write(descriptor, writer);
+    }
+
+private:
+    TsSectionWriter& writer;
+};
+
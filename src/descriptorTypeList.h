@@ -0,0 +1,62 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include "stream.h"
+
+namespace MmtTlv {
+
+// Compile-time list of descriptor classes, dispatched on their kDescriptorTag.
+// Tags are compared against compile-time constants, with no lookup table, std::function or RTTI.
+template<typename... Descriptors>
+class DescriptorTypeList {
+public:
+	// Calls function.template operator()<T>() for the class whose tag matches; false for unknown tags.
+	template<typename Function>
+	static bool dispatch(uint16_t tag, Function&& function) {
+		return ((tag == Descriptors::kDescriptorTag ? (function.template operator()<Descriptors>(), true) : false) || ...);
+	}
+
+	static bool contains(uint16_t tag) {
+		return ((tag == Descriptors::kDescriptorTag) || ...);
+	}
+};
+
+// Unpacks one descriptor of a loop as T on the stack and calls visitor with it; false if it does not unpack.
+// Lists in the descriptor take a stack buffer first, and its strings and byte arrays point into bytes.
+template<typename T, typename Visitor>
+bool visitDescriptor(std::span<const uint8_t> bytes, Visitor& visitor) {
+	Common::ReadStream stream(bytes);
+	if constexpr (std::is_constructible_v<T, std::pmr::memory_resource*>) {
+		std::byte buffer[1024];
+		std::pmr::monotonic_buffer_resource resource(buffer, sizeof(buffer));
+		T descriptor(&resource);
+		if (!descriptor.unpack(stream)) {
+			return false;
+		}
+		visitor(std::as_const(descriptor));
+	}
+	else {
+		T descriptor;
+		if (!descriptor.unpack(stream)) {
+			return false;
+		}
+		visitor(std::as_const(descriptor));
+	}
+	return true;
+}
+
+// Builds a visitor from one callback per descriptor class:
+// descriptors.visit(Overloaded{ [](const MhShortEventDescriptor& descriptor) { ... }, ... });
+template<typename... Callbacks>
+struct Overloaded : Callbacks... {
+	using Callbacks::operator()...;
+};
+
+template<typename... Callbacks>
+Overloaded(Callbacks...) -> Overloaded<Callbacks...>;
+
+}
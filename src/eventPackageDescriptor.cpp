@@ -13,8 +13,7 @@ bool EventPackageDescriptor::unpack(Common::ReadStream& stream)
 
         mmtPackageIdLength = nstream.get8U();
 
-        mmtPackageIdByte.resize(mmtPackageIdLength);
-        nstream.read(mmtPackageIdByte.data(), mmtPackageIdLength);
+        mmtPackageIdByte = nstream.getSpan(mmtPackageIdLength);
 
         stream.skip(descriptorLength);
     }
@@ -0,0 +1,96 @@
+#include "frameBufferPool.h"
+#include <algorithm>
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+namespace MmtTlv {
+
+FrameBufferPool::FrameBufferPool()
+{
+	buffers.reserve(kMaxBuffers);
+}
+
+std::vector<uint8_t> FrameBufferPool::acquire()
+{
+	++acquireCount;
+
+	const size_t reserveSize = getReserveSize();
+	std::vector<uint8_t> buffer;
+	if (!buffers.empty()) {
+		buffer = std::move(buffers.back());
+		buffers.pop_back();
+	}
+
+	if (buffer.capacity() >= reserveSize && buffer.capacity() > 0) {
+		++hitCount;
+	}
+	else {
+		reserve(buffer, reserveSize);
+	}
+
+	return buffer;
+}
+
+void FrameBufferPool::release(std::vector<uint8_t>&& buffer)
+{
+	if (buffer.capacity() == 0 || buffers.size() >= kMaxBuffers) {
+		return;
+	}
+
+	buffer.clear();
+	buffers.push_back(std::move(buffer));
+}
+
+void FrameBufferPool::addAccessUnitSize(size_t size)
+{
+	const size_t evicted = recentSizes[recentSizeIndex];
+	recentSizes[recentSizeIndex] = size;
+	recentSizeIndex = (recentSizeIndex + 1) % kSizeWindow;
+
+	if (size >= maxRecentSize) {
+		maxRecentSize = size;
+	}
+	else if (evicted == maxRecentSize) {
+		maxRecentSize = *std::max_element(recentSizes.begin(), recentSizes.end());
+	}
+}
+
+size_t FrameBufferPool::getReserveSize() const
+{
+	// Leave some headroom so an access unit slightly larger than the recent ones still fits.
+	return maxRecentSize + maxRecentSize / 4;
+}
+
+void FrameBufferPool::clear()
+{
+	buffers.clear();
+	recentSizes.fill(0);
+	recentSizeIndex = 0;
+	maxRecentSize = 0;
+	acquireCount = 0;
+	hitCount = 0;
+}
+
+void FrameBufferPool::reserve(std::vector<uint8_t>& buffer, size_t size)
+{
+	if (size == 0) {
+		return;
+	}
+
+	buffer.reserve(size);
+
+#ifdef __linux__
+	if (useHugePages) {
+		// Only the 2MB aligned part of the allocation can be backed by transparent huge pages.
+		constexpr uintptr_t kHugePageSize = 2 * 1024 * 1024;
+		const uintptr_t begin = (reinterpret_cast<uintptr_t>(buffer.data()) + kHugePageSize - 1) & ~(kHugePageSize - 1);
+		const uintptr_t end = (reinterpret_cast<uintptr_t>(buffer.data()) + buffer.capacity()) & ~(kHugePageSize - 1);
+		if (end > begin) {
+			madvise(reinterpret_cast<void*>(begin), end - begin, MADV_HUGEPAGE);
+		}
+	}
+#endif
+}
+
+}
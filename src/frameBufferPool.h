@@ -0,0 +1,51 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace MmtTlv {
+
+// Recycles frame buffers of a stream so that their capacity is reused by the next access units.
+// Buffers are reserved up front from a running maximum of the recent access unit sizes,
+// so assembling an access unit does not reallocate.
+class FrameBufferPool {
+public:
+	FrameBufferPool();
+
+	// Returns an empty buffer with at least getReserveSize() bytes of capacity.
+	std::vector<uint8_t> acquire();
+
+	// Buffers that have been moved away by the handler have no capacity and are simply dropped.
+	void release(std::vector<uint8_t>&& buffer);
+
+	// Records the size of an assembled access unit.
+	void addAccessUnitSize(size_t size);
+
+	void setUseHugePages(bool useHugePages) { this->useHugePages = useHugePages; }
+	void clear();
+
+	size_t getPooledCount() const { return buffers.size(); }
+	size_t getReserveSize() const;
+	uint64_t getAcquireCount() const { return acquireCount; }
+	uint64_t getHitCount() const { return hitCount; }
+	double getHitRate() const { return acquireCount ? static_cast<double>(hitCount) / acquireCount : 0; }
+
+private:
+	void reserve(std::vector<uint8_t>& buffer, size_t size);
+
+	static constexpr size_t kMaxBuffers = 4;
+	static constexpr size_t kSizeWindow = 64;
+
+	std::vector<std::vector<uint8_t>> buffers;
+
+	std::array<size_t, kSizeWindow> recentSizes{};
+	size_t recentSizeIndex{0};
+	size_t maxRecentSize{0};
+
+	bool useHugePages{false};
+	uint64_t acquireCount{0};
+	uint64_t hitCount{0};
+};
+
+}
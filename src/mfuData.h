@@ -0,0 +1,22 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+namespace MmtTlv {
+
+constexpr uint64_t NOPTS_VALUE = 0x8000000000000000;
+
+struct MfuData {
+	std::vector<uint8_t> data;
+	uint64_t pts{NOPTS_VALUE};
+	uint64_t dts{NOPTS_VALUE};
+	int streamIndex{};
+	bool keyframe{false};
+
+	// Access unit position, used to resolve the timestamps once the MPU timestamp descriptors arrive.
+	uint32_t mpuSequenceNumber{0};
+	uint32_t auIndex{0};
+	bool pendingTimestamp{false};
+};
+
+}
@@ -3,6 +3,7 @@
 #include <optional>
 #include <memory>
 #include "mmtStream.h"
+#include "mfuData.h"
 
 namespace MmtTlv {
 
@@ -17,21 +18,34 @@ namespace AssetType {
 	constexpr int32_t aapp = makeAssetType('a', 'a', 'p', 'p');
 }
 
-constexpr uint64_t NOPTS_VALUE = 0x8000000000000000;
-
-struct MfuData {
-	std::vector<uint8_t> data;
-	uint64_t pts{NOPTS_VALUE};
-	uint64_t dts{NOPTS_VALUE};
-	int streamIndex{};
-	bool keyframe{false};
-};
-
 class MfuDataProcessorBase {
 public:
 	virtual ~MfuDataProcessorBase() = default;
 	virtual std::optional<MfuData> process(const std::shared_ptr<MmtStream>& mmtStream, const std::vector<uint8_t>& data) { return std::nullopt; }
 
+protected:
+	// Assigns the next access unit of the current MPU to mfuData, with its PTS/DTS if the timestamps are already known.
+	// Returns false if the MPU does not have that many access units.
+	static bool assignNextTimestamp(MmtStream& mmtStream, MfuData& mfuData) {
+		int64_t pts, dts;
+		switch (mmtStream.getPtsDts(mmtStream.getLastMpuSequenceNumber(), mmtStream.getAuIndex(), pts, dts)) {
+		case MmtStream::TimestampStatus::Ok:
+			mfuData.pts = pts;
+			mfuData.dts = dts;
+			break;
+		case MmtStream::TimestampStatus::NotFound:
+			mfuData.pendingTimestamp = true;
+			break;
+		case MmtStream::TimestampStatus::OutOfRange:
+			return false;
+		}
+
+		mfuData.mpuSequenceNumber = mmtStream.getLastMpuSequenceNumber();
+		mfuData.auIndex = mmtStream.getAuIndex();
+		mmtStream.nextAuIndex();
+		return true;
+	}
+
 };
 
 template<uint32_t assetType>
@@ -2,9 +2,10 @@
 
 namespace MmtTlv {
 
-bool MhAit::unpack(Common::ReadStream& stream)
+bool MhAit::unpack(Common::ReadStream& input)
 {
     try {
+        Common::ReadStream stream = keepSection(input, peekSectionSize(input));
         if (!MmtTableBase::unpack(stream)) {
             return false;
         }
@@ -36,12 +37,10 @@ bool MhAit::unpack(Common::ReadStream& stream)
         applicationLoopLength = uint16 & 0b0000111111111111;
 
         while (stream.leftBytes() - 4 > 0) {
-            ApplicationIdentifier applicationIdentifier;
+            ApplicationIdentifier& applicationIdentifier = applicationIdentifiers.emplace_back();
             if (!applicationIdentifier.unpack(stream)) {
                 return false;
             }
-
-            applicationIdentifiers.push_back(applicationIdentifier);
         }
 
         crc32 = stream.getBe32U();
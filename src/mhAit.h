@@ -1,4 +1,5 @@
 #pragma once
+#include <memory_resource>
 #include <vector>
 #include "mmtTableBase.h"
 #include "mmtDescriptors.h"
@@ -31,7 +32,7 @@ public:
     MmtDescriptors descriptors;
     uint16_t applicationLoopLength;
 
-    std::list<ApplicationIdentifier> applicationIdentifiers;
+    std::pmr::vector<ApplicationIdentifier> applicationIdentifiers{ arena.getResource() };
     uint32_t crc32;
 };
 
@@ -1,5 +1,6 @@
 #pragma once
 #include "mmtDescriptorBase.h"
+#include <string_view>
 
 namespace MmtTlv {
 
@@ -26,7 +27,7 @@ public:
     uint8_t samplingRate;
     char language1[4];
     char language2[4];
-    std::string text;
+    std::string_view text;
 };
 
 }
\ No newline at end of file
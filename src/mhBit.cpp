@@ -2,9 +2,10 @@
 
 namespace MmtTlv {
 
-bool MhBit::unpack(Common::ReadStream& stream)
+bool MhBit::unpack(Common::ReadStream& input)
 {
     try {
+        Common::ReadStream stream = keepSection(input, peekSectionSize(input));
         if (!MmtTableBase::unpack(stream)) {
             return false;
         }
@@ -34,12 +35,10 @@ bool MhBit::unpack(Common::ReadStream& stream)
         stream.skip(firstDescriptorsLength);
 
         while (stream.leftBytes() - 4 > 0) {
-            Broadcaster entry;
+            Broadcaster& entry = broadcasters.emplace_back();
             if (!entry.unpack(stream)) {
                 return false;
             }
-
-            broadcasters.push_back(entry);
         }
 
         crc32 = stream.getBe32U();
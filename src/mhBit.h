@@ -1,4 +1,5 @@
 #pragma once
+#include <memory_resource>
 #include <vector>
 #include "mmtTableBase.h"
 #include "mmtDescriptors.h"
@@ -34,7 +35,7 @@ public:
     MmtDescriptors descriptors;
 
 
-    std::vector<Broadcaster> broadcasters;
+    std::pmr::vector<Broadcaster> broadcasters{ arena.getResource() };
     uint32_t crc32;
 };
 
@@ -11,8 +11,7 @@ bool MhBroadcasterNameDescriptor::unpack(Common::ReadStream& stream)
 
         Common::ReadStream nstream(stream, descriptorLength);
         
-        text.resize(nstream.leftBytes());
-        nstream.read(text.data(), nstream.leftBytes());
+        text = nstream.getStringView(nstream.leftBytes());
 
         stream.skip(descriptorLength);
     }
@@ -1,5 +1,6 @@
 #pragma once
 #include "mmtDescriptorBase.h"
+#include <string_view>
 
 namespace MmtTlv {
 
@@ -8,7 +9,7 @@ class MhBroadcasterNameDescriptor
 public:
     bool unpack(Common::ReadStream& stream) override;
 
-    std::string text;
+    std::string_view text;
 };
 
 }
\ No newline at end of file
@@ -22,12 +22,10 @@ bool MhCaContractInformation::unpack(Common::ReadStream& stream)
         }
 
         contractVerificationInfoLength = nstream.get8U();
-        contractVerificationInfo.resize(contractVerificationInfoLength);
-        nstream.read(contractVerificationInfo.data(), contractVerificationInfoLength);
+        contractVerificationInfo = nstream.getSpan(contractVerificationInfoLength);
 
         feeNameLength = nstream.get8U();
-        feeName.resize(feeNameLength);
-        nstream.read(feeName.data(), feeNameLength);
+        feeName = nstream.getStringView(feeNameLength);
 
         stream.skip(descriptorLength);
     }
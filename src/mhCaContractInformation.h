@@ -1,25 +1,30 @@
 #pragma once
 #include "mmtDescriptorBase.h"
-#include <list>
+#include <span>
+#include <string_view>
+#include <memory_resource>
+#include <vector>
 
 namespace MmtTlv {
 
 class MhCaContractInformation
     : public MmtDescriptorTemplate<0x8041> {
 public:
+    explicit MhCaContractInformation(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : componentTags(resource) {}
     bool unpack(Common::ReadStream& stream) override;
 
     uint16_t caSystemId;
     uint8_t caUnitId;
     uint8_t numOfComponent;
 
-    std::list<uint16_t> componentTags;
+    std::pmr::vector<uint16_t> componentTags;
 
     uint8_t contractVerificationInfoLength;
-    std::vector<uint8_t> contractVerificationInfo;
+    std::span<const uint8_t> contractVerificationInfo;
 
     uint8_t feeNameLength;
-    std::string feeName;
+    std::string_view feeName;
 
 };
 
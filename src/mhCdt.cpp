@@ -2,9 +2,10 @@
 
 namespace MmtTlv {
 
-bool MhCdt::unpack(Common::ReadStream& stream)
+bool MhCdt::unpack(Common::ReadStream& input)
 {
     try {
+        Common::ReadStream stream = keepSection(input, peekSectionSize(input));
         if (!MmtTableBase::unpack(stream)) {
             return false;
         }
@@ -38,13 +39,12 @@ bool MhCdt::unpack(Common::ReadStream& stream)
         }
         stream.skip(descriptorsLoopLength);
 
-        dataModuleByte.resize(stream.leftBytes() - 4);
-        stream.read(dataModuleByte.data(), stream.leftBytes() - 4);
-
         if (stream.leftBytes() < 4) {
             return false;
         }
 
+        dataModuleByte = stream.getSpan(stream.leftBytes() - 4);
+
         crc32 = stream.getBe32U();
     }
     catch (const std::out_of_range&) {
@@ -1,5 +1,5 @@
 #pragma once
-#include <vector>
+#include <span>
 #include "mmtTableBase.h"
 #include "mmtDescriptors.h"
 
@@ -27,7 +27,7 @@ public:
 
     MmtDescriptors descriptors;
 
-    std::vector<uint8_t> dataModuleByte;
+    std::span<const uint8_t> dataModuleByte;
     uint32_t crc32;
 };
 
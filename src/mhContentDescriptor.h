@@ -1,12 +1,15 @@
 #pragma once
 #include "mmtDescriptorBase.h"
-#include <list>
+#include <memory_resource>
+#include <vector>
 
 namespace MmtTlv {
 
 class MhContentDescriptor
     : public MmtDescriptorTemplate<0x8012> {
 public:
+    explicit MhContentDescriptor(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : entries(resource) {}
     bool unpack(Common::ReadStream& stream) override;
 
     class Entry {
@@ -19,7 +22,7 @@ public:
         uint8_t userNibble2;
     };
 
-    std::list<Entry> entries;
+    std::pmr::vector<Entry> entries;
 };
 
 }
\ No newline at end of file
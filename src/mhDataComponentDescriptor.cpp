@@ -12,8 +12,7 @@ bool MhDataComponentDescriptor::unpack(Common::ReadStream& stream)
 		Common::ReadStream nstream(stream, descriptorLength);
 
 		dataComponentId = nstream.getBe16U();
-		additionalDataComponentInfo.resize(nstream.leftBytes());
-		nstream.read(additionalDataComponentInfo.data(), nstream.leftBytes());
+		additionalDataComponentInfo = nstream.getSpan(nstream.leftBytes());
 
 		stream.skip(descriptorLength);
 	}
@@ -1,5 +1,6 @@
 #pragma once
 #include "mmtDescriptorBase.h"
+#include <span>
 
 namespace MmtTlv {
 
@@ -9,7 +10,7 @@ public:
     bool unpack(Common::ReadStream& stream) override;
 
     uint16_t dataComponentId;
-    std::vector<uint8_t> additionalDataComponentInfo;
+    std::span<const uint8_t> additionalDataComponentInfo;
 };
 
 }
\ No newline at end of file
@@ -2,9 +2,10 @@
 
 namespace MmtTlv {
 
-bool MhEit::unpack(Common::ReadStream& stream)
+bool MhEit::unpack(Common::ReadStream& input)
 {
     try {
+        Common::ReadStream stream = keepSection(input, peekSectionSize(input));
         if (!MmtTableBase::unpack(stream)) {
             return false;
         }
@@ -27,12 +28,10 @@ bool MhEit::unpack(Common::ReadStream& stream)
         lastTableId = stream.get8U();
 
         while (stream.leftBytes() - 4 > 0) {
-            std::shared_ptr<Event> event = std::make_shared<Event>();
-            if (!event->unpack(stream)) {
+            Event& event = events.emplace_back();
+            if (!event.unpack(stream)) {
                 return false;
             }
-
-            events.push_back(event);
         }
 
         if (stream.leftBytes() < 4) {
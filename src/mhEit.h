@@ -1,5 +1,6 @@
 #pragma once
-#include <list>
+#include <memory_resource>
+#include <vector>
 #include "mmtTableBase.h"
 #include "mmtDescriptors.h"
 
@@ -45,7 +46,7 @@ public:
     uint8_t lastTableId;
     uint8_t eventCount;
 
-    std::list<std::shared_ptr<Event>> events;
+    std::pmr::vector<Event> events{ arena.getResource() };
     uint32_t crc32;
 };
 
@@ -16,25 +16,22 @@ bool MhEventGroupDescriptor::unpack(Common::ReadStream& stream)
 		eventCount = uint8 & 0b00001111;
 
 		for (int i = 0; i < eventCount; i++) {
-			Event event;
+			Event& event = events.emplace_back();
 			if (!event.unpack(nstream)) {
 				return false;
 			}
-			events.push_back(event);
 		}
 
 		if (groupType == 4 || groupType == 5) {
 			while (!nstream.isEof()) {
-				OtherNetworkEvent otherNetworkEvent;
+				OtherNetworkEvent& otherNetworkEvent = otherNetworkEvents.emplace_back();
 				if (!otherNetworkEvent.unpack(nstream)) {
 					return false;
 				}
-				otherNetworkEvents.push_back(otherNetworkEvent);
 			}
 		}
 		else {
-			privateDataByte.resize(nstream.leftBytes());
-			nstream.read(privateDataByte.data(), nstream.leftBytes());
+			privateDataByte = nstream.getSpan(nstream.leftBytes());
 		}
 
 		stream.skip(descriptorLength);
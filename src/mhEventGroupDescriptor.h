@@ -1,12 +1,16 @@
 #pragma once
 #include "mmtDescriptorBase.h"
-#include <list>
+#include <span>
+#include <memory_resource>
+#include <vector>
 
 namespace MmtTlv {
 
 class MhEventGroupDescriptor
     : public MmtDescriptorTemplate<0x800C> {
 public:
+    explicit MhEventGroupDescriptor(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : events(resource), otherNetworkEvents(resource) {}
     bool unpack(Common::ReadStream& stream) override;
 
     uint8_t groupType;
@@ -28,10 +32,10 @@ public:
         uint16_t eventId;
     };
 
-    std::list<Event> events;
-    std::list<OtherNetworkEvent> otherNetworkEvents;
+    std::pmr::vector<Event> events;
+    std::pmr::vector<OtherNetworkEvent> otherNetworkEvents;
 
-    std::vector<uint8_t> privateDataByte;
+    std::span<const uint8_t> privateDataByte;
 };
 
 }
\ No newline at end of file
@@ -18,20 +18,17 @@ bool MhExtendedEventDescriptor::unpack(Common::ReadStream& stream)
         lengthOfItems = stream.getBe16U();
         Common::ReadStream nstream(stream, lengthOfItems);
         while (!nstream.isEof()) {
-            Entry entry;
+            Entry& entry = entries.emplace_back();
             if (!entry.unpack(nstream)) {
                 return false;
             }
-
-            entries.push_back(entry);
         }
         stream.skip(lengthOfItems);
 
 
         textLength = stream.getBe16U();
         if (textLength) {
-            textChar.resize(textLength);
-            stream.read(textChar.data(), textLength);
+            textChar = stream.getStringView(textLength);
         }
     }
     catch (const std::out_of_range&) {
@@ -46,14 +43,12 @@ bool MhExtendedEventDescriptor::Entry::unpack(Common::ReadStream& stream)
     try {
         itemDescriptionLength = stream.get8U();
         if (itemDescriptionLength > 0) {
-            itemDescriptionChar.resize(itemDescriptionLength);
-            stream.read(itemDescriptionChar.data(), itemDescriptionLength);
+            itemDescriptionChar = stream.getStringView(itemDescriptionLength);
         }
 
         itemLength = stream.getBe16U();
         if (itemLength > 0) {
-            itemChar.resize(itemLength);
-            stream.read(itemChar.data(), itemLength);
+            itemChar = stream.getStringView(itemLength);
         }
     }
     catch (const std::out_of_range&) {
@@ -1,12 +1,16 @@
 #pragma once
 #include "mmtDescriptorBase.h"
-#include <list>
+#include <string_view>
+#include <memory_resource>
+#include <vector>
 
 namespace MmtTlv {
 
 class MhExtendedEventDescriptor
     : public MmtDescriptorTemplate<0xF002, true> {
 public:
+    explicit MhExtendedEventDescriptor(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : entries(resource) {}
     bool unpack(Common::ReadStream& stream) override;
 
     class Entry {
@@ -14,10 +18,10 @@ public:
         bool unpack(Common::ReadStream& stream);
 
         uint8_t itemDescriptionLength;
-        std::string itemDescriptionChar;
+        std::string_view itemDescriptionChar;
 
         uint16_t itemLength;
-        std::string itemChar;
+        std::string_view itemChar;
     };
 
     uint8_t descriptorNumber;
@@ -25,10 +29,10 @@ public:
     char language[4];
     uint16_t lengthOfItems;
 
-    std::list<Entry> entries;
+    std::pmr::vector<Entry> entries;
 
     uint16_t textLength;
-    std::string textChar;
+    std::string_view textChar;
 };
 
 }
\ No newline at end of file
@@ -16,8 +16,7 @@ bool MhLinkageDescriptor::unpack(Common::ReadStream& stream)
         serviceId = nstream.getBe16U();
         linkageType = nstream.get8U();
 
-        privateDataByte.resize(nstream.leftBytes());
-        nstream.read(privateDataByte.data(), nstream.leftBytes());
+        privateDataByte = nstream.getSpan(nstream.leftBytes());
 
         stream.skip(descriptorLength);
     }
@@ -1,5 +1,6 @@
 #pragma once
 #include "mmtDescriptorBase.h"
+#include <span>
 
 namespace MmtTlv {
 
@@ -12,7 +13,7 @@ public:
     uint16_t originalNetworkId;
     uint16_t serviceId;
     uint8_t linkageType;
-    std::vector<uint8_t> privateDataByte;
+    std::span<const uint8_t> privateDataByte;
 
 };
 
@@ -23,11 +23,10 @@ bool MhLogoTransmissionDescriptor::unpack(Common::ReadStream& stream)
             downloadDataId = nstream.getBe16U();
 
             while (!nstream.isEof()) {
-                Entry entry;
+                Entry& entry = entries.emplace_back();
                 if (!entry.unpack(nstream)) {
                     return false;
                 }
-                entries.push_back(entry);
             }
         }
         else if (logoTransmissionType == 0x02) {
@@ -36,8 +35,7 @@ bool MhLogoTransmissionDescriptor::unpack(Common::ReadStream& stream)
             logoId = uint16 & 0b0000000111111111;
         }
         else if (logoTransmissionType == 0x03) {
-            logoChar.resize(nstream.leftBytes());
-            nstream.read(logoChar.data(), nstream.leftBytes());
+            logoChar = nstream.getStringView(nstream.leftBytes());
         }
 
         stream.skip(descriptorLength);
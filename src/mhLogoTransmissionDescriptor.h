@@ -1,12 +1,16 @@
 #pragma once
 #include "mmtDescriptorBase.h"
-#include <list>
+#include <string_view>
+#include <memory_resource>
+#include <vector>
 
 namespace MmtTlv {
 
 class MhLogoTransmissionDescriptor
     : public MmtDescriptorTemplate<0x8025> {
 public:
+    explicit MhLogoTransmissionDescriptor(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : entries(resource) {}
     bool unpack(Common::ReadStream& stream) override;
 
     class Entry {
@@ -25,9 +29,9 @@ public:
     uint16_t logoVersion;
     uint16_t downloadDataId;
 
-    std::list<Entry> entries;
+    std::pmr::vector<Entry> entries;
 
-    std::string logoChar;
+    std::string_view logoChar;
 };
 
 }
\ No newline at end of file
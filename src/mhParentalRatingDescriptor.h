@@ -1,12 +1,15 @@
 #pragma once
 #include "mmtDescriptorBase.h"
-#include <list>
+#include <memory_resource>
+#include <vector>
 
 namespace MmtTlv {
 
 class MhParentalRatingDescriptor
     : public MmtDescriptorTemplate<0x8013> {
 public:
+    explicit MhParentalRatingDescriptor(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : entries(resource) {}
     bool unpack(Common::ReadStream& stream) override;
 
     class Entry {
@@ -17,7 +20,7 @@ public:
         uint8_t rating;
     };
     
-    std::list<Entry> entries;
+    std::pmr::vector<Entry> entries;
 };
 
 }
\ No newline at end of file
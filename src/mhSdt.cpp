@@ -1,12 +1,12 @@
 #include "mhSdt.h"
 #include "mhServiceDescriptor.h"
-#include <memory>
 
 namespace MmtTlv {
 
-bool MhSdt::unpack(Common::ReadStream& stream)
+bool MhSdt::unpack(Common::ReadStream& input)
 {
     try {
+        Common::ReadStream stream = keepSection(input, peekSectionSize(input));
         if (!MmtTableBase::unpack(stream)) {
             return false;
         }
@@ -26,12 +26,10 @@ bool MhSdt::unpack(Common::ReadStream& stream)
         stream.skip(1);
 
         while (stream.leftBytes() > 4) {
-            std::shared_ptr<Service> service = std::make_shared<Service>();
-            if (!service->unpack(stream)) {
+            Service& service = services.emplace_back();
+            if (!service.unpack(stream)) {
                 return false;
             }
-
-            services.push_back(service);
         }
 
         if (stream.leftBytes() < 4) {
@@ -1,5 +1,6 @@
 #pragma once
-#include <list>
+#include <memory_resource>
+#include <vector>
 #include "mmtTableBase.h"
 #include "mmtDescriptors.h"
 
@@ -37,7 +38,7 @@ public:
 
     uint16_t originalNetworkId;
 
-    std::list<std::shared_ptr<Service>> services;
+    std::pmr::vector<Service> services{ arena.getResource() };
     uint32_t crc32;
 };
 
@@ -25,8 +25,7 @@ bool MhSeriesDescriptor::unpack(Common::ReadStream& stream)
         episodeNumber = (uint16 & 0b1111111111110000) >> 4;
         lastEpisodeNumber = (uint16 & 0b0000000000001111) << 8 | nstream.get8U();
 
-        seriesNameChar.resize(nstream.leftBytes());
-        nstream.read(seriesNameChar.data(), nstream.leftBytes());
+        seriesNameChar = nstream.getStringView(nstream.leftBytes());
 
         stream.skip(descriptorLength);
     }
@@ -1,5 +1,6 @@
 #pragma once
 #include "mmtDescriptorBase.h"
+#include <string_view>
 
 namespace MmtTlv {
 
@@ -19,7 +20,7 @@ public:
     uint16_t episodeNumber;
     uint16_t lastEpisodeNumber;
 
-    std::string seriesNameChar;
+    std::string_view seriesNameChar;
 
 };
 
@@ -14,14 +14,12 @@ bool MhServiceDescriptor::unpack(Common::ReadStream& stream)
 		serviceType = nstream.get8U();
 		serviceProviderNameLength = nstream.get8U();
 		if (serviceProviderNameLength) {
-			serviceProviderName.resize(serviceProviderNameLength);
-			nstream.read(serviceProviderName.data(), serviceProviderNameLength);
+			serviceProviderName = nstream.getStringView(serviceProviderNameLength);
 		}
 
 		serviceNameLength = nstream.get8U();
 		if (serviceNameLength) {
-			serviceName.resize(serviceNameLength);
-			nstream.read(serviceName.data(), serviceNameLength);
+			serviceName = nstream.getStringView(serviceNameLength);
 		}
 
 		stream.skip(descriptorLength);
@@ -1,5 +1,6 @@
 #pragma once
 #include "mmtDescriptorBase.h"
+#include <string_view>
 
 namespace MmtTlv {
 
@@ -11,9 +12,9 @@ public:
 
 	uint8_t serviceType;
 	uint8_t serviceProviderNameLength;
-	std::string serviceProviderName;
+	std::string_view serviceProviderName;
 	uint8_t serviceNameLength;
-	std::string serviceName;
+	std::string_view serviceName;
 };
 
 }
\ No newline at end of file
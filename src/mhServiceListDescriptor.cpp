@@ -12,12 +12,10 @@ bool MhServiceListDescriptor::unpack(Common::ReadStream& stream)
         Common::ReadStream nstream(stream, descriptorLength);
 
 		while (!nstream.isEof()) {
-			Entry entry;
+			Entry& entry = entries.emplace_back();
 			if (!entry.unpack(nstream)) {
 				return false;
 			}
-
-			entries.push_back(entry);
 		}
 
 		stream.skip(descriptorLength);
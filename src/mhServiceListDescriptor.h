@@ -1,12 +1,15 @@
 #pragma once
 #include "mmtDescriptorBase.h"
-#include <list>
+#include <memory_resource>
+#include <vector>
 
 namespace MmtTlv {
 
 class MhServiceListDescriptor
 	: public MmtDescriptorTemplate<0x800D> {
 public:
+	explicit MhServiceListDescriptor(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+		: entries(resource) {}
 	virtual ~MhServiceListDescriptor() {}
 	bool unpack(Common::ReadStream& stream) override;
 
@@ -18,7 +21,7 @@ public:
 		uint8_t serviceType;
 	};
 
-	std::list<Entry> entries;
+	std::pmr::vector<Entry> entries;
 };
 
 }
\ No newline at end of file
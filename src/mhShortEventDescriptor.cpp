@@ -16,12 +16,10 @@ bool MhShortEventDescriptor::unpack(Common::ReadStream& stream)
         language[3] = '\0';
 
         eventNameLength = stream.get8U();
-        eventName.resize(eventNameLength);
-        stream.read(eventName.data(), eventNameLength);
+        eventName = stream.getStringView(eventNameLength);
 
         textLength = stream.getBe16U();
-        text.resize(textLength);
-        stream.read(text.data(), textLength);
+        text = stream.getStringView(textLength);
     }
     catch (const std::out_of_range&) {
         return false;
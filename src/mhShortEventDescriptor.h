@@ -1,5 +1,6 @@
 #pragma once
 #include "mmtDescriptorBase.h"
+#include <string_view>
 
 namespace MmtTlv {
 
@@ -9,8 +10,8 @@ public:
 	bool unpack(Common::ReadStream& stream) override;
 
 	char language[4];
-	std::string eventName;
-	std::string text;
+	std::string_view eventName;
+	std::string_view text;
 
 };
 
@@ -15,12 +15,10 @@ bool MhSiParameterDescriptor::unpack(Common::ReadStream& stream)
         updateTime = nstream.getBe16U();
 
         while (!nstream.isEof()) {
-            Entry entry;
+            Entry& entry = entries.emplace_back();
             if (!entry.unpack(nstream)) {
                 return false;
             }
-
-            entries.push_back(entry);
         }
         
         stream.skip(descriptorLength);
@@ -38,8 +36,7 @@ bool MhSiParameterDescriptor::Entry::unpack(Common::ReadStream& stream)
         tableId = stream.get8U();
         tableDescriptionLength = stream.get8U();
 
-        tableDescriptionByte.resize(tableDescriptionLength);
-        stream.read(tableDescriptionByte.data(), tableDescriptionLength);
+        tableDescriptionByte = stream.getSpan(tableDescriptionLength);
     }
     catch (const std::out_of_range&) {
         return false;
@@ -1,12 +1,16 @@
 #pragma once
 #include "mmtDescriptorBase.h"
-#include <list>
+#include <span>
+#include <memory_resource>
+#include <vector>
 
 namespace MmtTlv {
 
 class MhSiParameterDescriptor
 	: public MmtDescriptorTemplate<0x8017> {
 public:
+	explicit MhSiParameterDescriptor(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+		: entries(resource) {}
 	bool unpack(Common::ReadStream& stream) override;
 
 	class Entry {
@@ -15,12 +19,12 @@ public:
 
 		uint8_t tableId;
 		uint8_t tableDescriptionLength;
-		std::vector<uint8_t> tableDescriptionByte;
+		std::span<const uint8_t> tableDescriptionByte;
 	};
 
 	uint8_t parameterVersion;
 	uint16_t updateTime;
-	std::list<Entry> entries;
+	std::pmr::vector<Entry> entries;
 
 };
 
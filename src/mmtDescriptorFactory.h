@@ -1,15 +0,0 @@
-#pragma once
-#include "mmtDescriptorBase.h"
-#include <list>
-#include <memory>
-
-namespace MmtTlv {
-
-class MmtDescriptorFactory {
-public:
-	static std::shared_ptr<MmtDescriptorBase> create(uint16_t tag);
-	static bool isValidTag(uint16_t tag);
-
-};
-
-}
\ No newline at end of file
@@ -0,0 +1,60 @@
+#pragma once
+#include "descriptorTypeList.h"
+#include "mmtDescriptorBase.h"
+
+#include "eventPackageDescriptor.h"
+#include "mhAudioComponentDescriptor.h"
+#include "mhCaContractInformation.h"
+#include "mhContentDescriptor.h"
+#include "mhDataComponentDescriptor.h"
+#include "mhEventGroupDescriptor.h"
+#include "mhExtendedEventDescriptor.h"
+#include "mhLinkageDescriptor.h"
+#include "mhLogoTransmissionDescriptor.h"
+#include "mhParentalRatingDescriptor.h"
+#include "mhSeriesDescriptor.h"
+#include "mhServiceDescriptor.h"
+#include "mhShortEventDescriptor.h"
+#include "mhStreamIdentificationDescriptor.h"
+#include "mpuExtendedTimestampDescriptor.h"
+#include "mpuTimestampDescriptor.h"
+#include "videoComponentDescriptor.h"
+#include "contentCopyControlDescriptor.h"
+#include "multimediaServiceInformationDescriptor.h"
+#include "accessControlDescriptor.h"
+#include "mhSiParameterDescriptor.h"
+#include "relatedBroadcasterDescriptor.h"
+#include "mhBroadcasterNameDescriptor.h"
+#include "mhServiceListDescriptor.h"
+
+namespace MmtTlv {
+
+// MMT-SI descriptors that can be visited; others are skipped by their length
+using MmtDescriptorTypes = DescriptorTypeList<
+	MhAudioComponentDescriptor,
+	MhContentDescriptor,
+	MhExtendedEventDescriptor,
+	MhServiceDescriptor,
+	MhShortEventDescriptor,
+	MpuExtendedTimestampDescriptor,
+	MpuTimestampDescriptor,
+	VideoComponentDescriptor,
+	EventPackageDescriptor,
+	MhCaContractInformation,
+	MhLinkageDescriptor,
+	MhLogoTransmissionDescriptor,
+	MhSeriesDescriptor,
+	MhEventGroupDescriptor,
+	MhParentalRatingDescriptor,
+	MhStreamIdentificationDescriptor,
+	MhDataComponentDescriptor,
+	ContentCopyControlDescriptor,
+	MultimediaServiceInformationDescriptor,
+	AccessControlDescriptor,
+	MhSiParameterDescriptor,
+	RelatedBroadcasterDescriptor,
+	MhBroadcasterNameDescriptor,
+	MhServiceListDescriptor
+>;
+
+}
@@ -1,30 +1,36 @@
 #include "mmtDescriptors.h"
-#include "mmtDescriptorFactory.h"
 
 namespace MmtTlv {
 
 bool MmtDescriptors::unpack(Common::ReadStream& stream)
 {
-	list.clear();
-	while (!stream.isEof()) {
-		uint16_t descriptorTag = stream.peekBe16U();
-		auto it = MmtDescriptorFactory::create(descriptorTag);
-		if (it == nullptr) {
-			MmtDescriptorBase base;
-			if (!base.unpack(stream)) {
-				return false;
-			}
-			stream.skip(base.getDescriptorLength());
-		}
-		else {
- 			if (!it->unpack(stream)) {
-				return false;
-			}
-			list.push_back(std::move(it));
+	try {
+		Common::ReadStream walk(stream);
+		while (!walk.isEof()) {
+			walk.skip(peekDescriptorSize(walk));
 		}
+
+		loop = stream.getSpan(stream.leftBytes());
+	}
+	catch (const std::out_of_range&) {
+		return false;
 	}
+
 	return true;
 }
 
+size_t MmtDescriptors::peekDescriptorSize(Common::ReadStream& stream)
+{
+	Common::ReadStream header(stream);
+	const uint16_t descriptorTag = header.getBe16U();
 
-}
\ No newline at end of file
+	// Descriptors not visited are taken to have an 8-bit length
+	bool is16BitLength = false;
+	MmtDescriptorTypes::dispatch(descriptorTag, [&]<typename T>() {
+		is16BitLength = T::kIs16BitLength;
+	});
+
+	return is16BitLength ? 4 + header.getBe16U() : 3 + header.get8U();
+}
+
+}
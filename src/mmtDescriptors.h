@@ -1,15 +1,40 @@
 #pragma once
 #include "mmtDescriptorBase.h"
-#include <list>
-#include <memory>
+#include "mmtDescriptorTypes.h"
+#include <span>
+#include <type_traits>
 
 namespace MmtTlv {
 
+// View of a descriptor loop in the section kept by the table. unpack only walks the lengths;
+// a descriptor is unpacked when it is visited, and only if the visitor takes its class.
 class MmtDescriptors {
 public:
 	bool unpack(Common::ReadStream& stream);
-	std::list<std::shared_ptr<MmtDescriptorBase>> list;
+
+	// Calls visitor for each descriptor whose class it takes, in the order of the loop:
+	// descriptors.visit(Overloaded{ [](const MhShortEventDescriptor& descriptor) { ... }, ... });
+	// The descriptor passed to visitor only lives for the call.
+	template<typename Visitor>
+	void visit(Visitor&& visitor) const {
+		Common::ReadStream stream(loop);
+		while (!stream.isEof()) {
+			const uint16_t descriptorTag = stream.peekBe16U();
+			const std::span<const uint8_t> descriptor = stream.getSpan(peekDescriptorSize(stream));
+			MmtDescriptorTypes::dispatch(descriptorTag, [&]<typename T>() {
+				if constexpr (std::is_invocable_v<Visitor&, const T&>) {
+					visitDescriptor<T>(descriptor, visitor);
+				}
+			});
+		}
+	}
+
+	std::span<const uint8_t> loop;
+
+private:
+	// Size of the descriptor at the stream position, with its tag and length
+	static size_t peekDescriptorSize(Common::ReadStream& stream);
 
 };
 
-}
\ No newline at end of file
+}
@@ -43,8 +43,7 @@ bool MmtGeneralLocationInfo::unpack(Common::ReadStream& stream)
 			break;
 		case 5:
 			urlLength = stream.get8U();
-			urlByte.resize(urlLength);
-			stream.read(urlByte.data(), urlLength);
+			urlByte = stream.getSpan(urlLength);
 			break;
 		}
 	}
@@ -1,5 +1,5 @@
 #pragma once
-#include <vector>
+#include <span>
 #include "stream.h"
 #include "ip.h"
 
@@ -27,7 +27,7 @@ public:
 	uint16_t mpeg2Pid;
 
 	uint8_t urlLength;
-	std::vector<uint8_t> urlByte;
+	std::span<const uint8_t> urlByte;
 };
 
 }
\ No newline at end of file
@@ -6,42 +6,88 @@
 
 namespace MmtTlv {
 
-std::pair<int64_t, int64_t> MmtStream::getNextPtsDts()
+MmtStream::TimestampStatus MmtStream::getPtsDts(uint32_t mpuSequenceNumber, uint32_t auIndex, int64_t& pts, int64_t& dts) const
 {
-    const auto timestamp = getCurrentTimestamp();
+    const MpuTimestamp& timestamp = mpuTimestamps[mpuSequenceNumber % kMpuTimestampRingSize];
+    if (timestamp.mpuSequenceNumber != mpuSequenceNumber ||
+        !timestamp.hasPresentationTime || !timestamp.hasExtendedTimestamp) {
+        return TimestampStatus::NotFound;
+    }
+
+    if (auIndex >= timestamp.numOfAu) {
+        return TimestampStatus::OutOfRange;
+    }
 
-    int64_t ptime = av_rescale(timestamp.first.mpuPresentationTime, timeBase.den,
-        1000000ll * timeBase.num);
+    int64_t ptime = presentationTimeRescaler.rescale(timestamp.mpuPresentationTime);
+    dts = ptime - timestamp.mpuDecodingTimeOffset + timestamp.dtsOffsets[auIndex];
+    pts = dts + timestamp.dtsPtsOffsets[auIndex];
 
-    if (auIndex >= timestamp.second.numOfAu) {
-        throw std::out_of_range("au index out of bounds");
+    return TimestampStatus::Ok;
+}
+
+void MmtStream::setTimeBase(int num, int den)
+{
+    if (timeBase.num == num && timeBase.den == den) {
+        return;
     }
 
-    int64_t dts = ptime - timestamp.second.mpuDecodingTimeOffset;
-    for (uint32_t j = 0; j < auIndex; ++j) {
-        dts += timestamp.second.ptsOffsets[j];
+    timeBase.num = num;
+    timeBase.den = den;
+
+    // mpu_presentation_time is in microseconds
+    presentationTimeRescaler = Rescaler(den, 1000000ll * num);
+    tsRescaler = Rescaler(90000ll * num, den);
+}
+
+MmtStream::MpuTimestamp* MmtStream::getMpuTimestampSlot(uint32_t mpuSequenceNumber)
+{
+    MpuTimestamp& timestamp = mpuTimestamps[mpuSequenceNumber % kMpuTimestampRingSize];
+    if (timestamp.mpuSequenceNumber != mpuSequenceNumber) {
+        // Do not let a stale entry evict a newer MPU sharing the same slot.
+        if ((timestamp.hasPresentationTime || timestamp.hasExtendedTimestamp) &&
+            timestamp.mpuSequenceNumber > mpuSequenceNumber) {
+            return nullptr;
+        }
+
+        timestamp.mpuSequenceNumber = mpuSequenceNumber;
+        timestamp.hasPresentationTime = false;
+        timestamp.hasExtendedTimestamp = false;
     }
 
-    int64_t pts = dts + timestamp.second.dtsPtsOffsets[auIndex];
+    return &timestamp;
+}
 
-    ++auIndex;
+void MmtStream::setMpuPresentationTime(const MpuTimestampDescriptor::Entry& entry)
+{
+    MpuTimestamp* timestamp = getMpuTimestampSlot(entry.mpuSequenceNumber);
+    if (!timestamp) {
+        return;
+    }
 
-    return std::pair<int64_t, int64_t>(pts, dts);
+    timestamp->mpuPresentationTime = entry.mpuPresentationTime;
+    timestamp->hasPresentationTime = true;
 }
 
-std::pair<const MpuTimestampDescriptor::Entry, const MpuExtendedTimestampDescriptor::Entry> MmtStream::getCurrentTimestamp() const
+void MmtStream::setMpuExtendedTimestamp(const MpuExtendedTimestampDescriptor::Entry& entry)
 {
-    auto mpuTimestampIt = std::find_if(mpuTimestamps.begin(), mpuTimestamps.end(),
-        [this](const auto& entry) { return entry.mpuSequenceNumber == lastMpuSequenceNumber; });
+    MpuTimestamp* timestamp = getMpuTimestampSlot(entry.mpuSequenceNumber);
+    if (!timestamp) {
+        return;
+    }
 
-    auto extendedTimestampIt = std::find_if(mpuExtendedTimestamps.begin(), mpuExtendedTimestamps.end(),
-        [this](const auto& entry) { return entry.mpuSequenceNumber == lastMpuSequenceNumber; });
+    timestamp->mpuDecodingTimeOffset = entry.mpuDecodingTimeOffset;
+    timestamp->numOfAu = entry.numOfAu;
+    timestamp->dtsOffsets.resize(entry.numOfAu);
+    timestamp->dtsPtsOffsets.resize(entry.numOfAu);
 
-    if (mpuTimestampIt == mpuTimestamps.end() || extendedTimestampIt == mpuExtendedTimestamps.end()) {
-        return {};
+    int64_t dtsOffset = 0;
+    for (size_t i = 0; i < entry.numOfAu; ++i) {
+        timestamp->dtsPtsOffsets[i] = entry.getDtsPtsOffset(i);
+        timestamp->dtsOffsets[i] = dtsOffset;
+        dtsOffset += entry.getPtsOffset(i);
     }
 
-    return { *mpuTimestampIt, *extendedTimestampIt };
+    timestamp->hasExtendedTimestamp = true;
 }
 
 bool MmtStream::Is8KVideo() const
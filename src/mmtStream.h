@@ -1,8 +1,13 @@
 #pragma once
+#include <array>
+#include <deque>
 #include <vector>
 #include <memory>
 #include "mpuExtendedTimestampDescriptor.h"
 #include "mpuTimestampDescriptor.h"
+#include "frameBufferPool.h"
+#include "timebase.h"
+#include "mfuData.h"
 
 namespace MmtTlv {
 
@@ -21,7 +26,16 @@ public:
 	MmtStream(MmtStream&&) = default;
     MmtStream& operator=(MmtStream&&) = default;
 
-	std::pair<int64_t, int64_t> getNextPtsDts();
+	enum class TimestampStatus {
+		Ok,
+		NotFound,
+		OutOfRange,
+	};
+
+	TimestampStatus getPtsDts(uint32_t mpuSequenceNumber, uint32_t auIndex, int64_t& pts, int64_t& dts) const;
+	uint32_t getLastMpuSequenceNumber() const { return lastMpuSequenceNumber; }
+	void nextAuIndex() { ++auIndex; }
+	int64_t rescaleTo90kHz(int64_t timestamp) const { return tsRescaler.rescale(timestamp); }
 	uint32_t getAuIndex() const { return auIndex; }
 	uint16_t getMpeg2PacketId() const { return componentTag == -1 ? 0x200 + streamIndex : 0x100 + componentTag; }
 	uint16_t getPacketId() const { return packetId; }
@@ -32,22 +46,44 @@ public:
 	bool Is8KVideo() const;
 	bool Is22_2chAudio() const;
 	uint32_t getSamplingRate() const;
+	FrameBufferPool& getFrameBufferPool() { return frameBufferPool; }
 
-	const std::shared_ptr<VideoComponentDescriptor>& getVideoComponentDescriptor() const { return videoComponentDescriptor; }
-	const std::shared_ptr<MhAudioComponentDescriptor>& getMhAudioComponentDescriptor() const { return mhAudioComponentDescriptor; }
+	const std::shared_ptr<const VideoComponentDescriptor>& getVideoComponentDescriptor() const { return videoComponentDescriptor; }
+	const std::shared_ptr<const MhAudioComponentDescriptor>& getMhAudioComponentDescriptor() const { return mhAudioComponentDescriptor; }
 
 	struct TimeBase {
-		int num;
-		int den;
+		int num{1};
+		int den{0};
 	};
 
 	struct TimeBase timeBase;
 
 private:
+	friend class MmtTlvDemuxerBase;
+	template<typename Handler>
 	friend class MmtTlvDemuxer;
 
-	std::pair<const MpuTimestampDescriptor::Entry, const MpuExtendedTimestampDescriptor::Entry> getCurrentTimestamp() const;
-	
+	// Timestamps of a single MPU, combined from MpuTimestampDescriptor and MpuExtendedTimestampDescriptor.
+	struct MpuTimestamp {
+		uint32_t mpuSequenceNumber{0};
+		bool hasPresentationTime{false};
+		bool hasExtendedTimestamp{false};
+		uint64_t mpuPresentationTime{0};
+		uint16_t mpuDecodingTimeOffset{0};
+		uint8_t numOfAu{0};
+		// Sum of the pts_offsets of the preceding access units, i.e. the DTS of each access unit relative to the first one.
+		std::vector<int64_t> dtsOffsets;
+		std::vector<uint16_t> dtsPtsOffsets;
+	};
+
+	// Ring indexed by mpu_sequence_number.
+	static constexpr size_t kMpuTimestampRingSize = 128;
+
+	void setTimeBase(int num, int den);
+	MpuTimestamp* getMpuTimestampSlot(uint32_t mpuSequenceNumber);
+	void setMpuPresentationTime(const MpuTimestampDescriptor::Entry& entry);
+	void setMpuExtendedTimestamp(const MpuExtendedTimestampDescriptor::Entry& entry);
+
 	uint16_t packetId = 0;
 	uint32_t assetType = 0;
 	uint32_t lastMpuSequenceNumber = 0;
@@ -56,11 +92,20 @@ private:
 	int16_t componentTag = -1;
 	bool rapFlag = false;
 
-	std::vector<MpuTimestampDescriptor::Entry> mpuTimestamps;
-	std::vector<MpuExtendedTimestampDescriptor::Entry> mpuExtendedTimestamps;
+	std::array<MpuTimestamp, kMpuTimestampRingSize> mpuTimestamps;
+	Rescaler presentationTimeRescaler{0, 1};
+	Rescaler tsRescaler{0, 1};
+
+	// Access units waiting for the timestamps of their MPU, in arrival order.
+	static constexpr size_t kMaxPendingAccessUnits = 256;
+	std::deque<MfuData> pendingAccessUnits;
+	// Oldest MPU described by the latest MPU extended timestamp descriptor. Timestamps of older MPUs will not arrive anymore.
+	uint32_t oldestDescribedMpuSequenceNumber = 0;
 	std::shared_ptr<MfuDataProcessorBase> mfuDataProcessor;
-	std::shared_ptr<VideoComponentDescriptor> videoComponentDescriptor;
-	std::shared_ptr<MhAudioComponentDescriptor> mhAudioComponentDescriptor;
+	// Copies that keep the MPT they came from alive, as their text points into its section
+	std::shared_ptr<const VideoComponentDescriptor> videoComponentDescriptor;
+	std::shared_ptr<const MhAudioComponentDescriptor> mhAudioComponentDescriptor;
+	FrameBufferPool frameBufferPool;
 };
 
 }
@@ -1,5 +1,6 @@
 #pragma once
 #include "stream.h"
+#include "arena.h"
 
 namespace MmtTlv {
     
@@ -69,6 +70,48 @@ public:
 protected:
     uint8_t tableId;
 
+    // Holds everything unpacked from the section, released together with the table
+    Common::Arena arena;
+
+    // Copies the section at the stream position into the arena and returns a stream over the copy,
+    // so strings and byte arrays unpacked from it can be views that live as long as the table.
+    // The stream moves past the section, or to its end when the section is truncated.
+    Common::ReadStream keepSection(Common::ReadStream& stream, size_t size)
+    {
+        if (size == 0 || stream.leftBytes() < size) {
+            stream.skip(stream.leftBytes());
+            throw std::out_of_range("Access out of bounds");
+        }
+
+        uint8_t* section = arena.allocate<uint8_t>(size);
+        stream.read(section, size);
+        return Common::ReadStream(std::span<const uint8_t>(section, size));
+    }
+
+    // Size of a section with a 12-bit section_length after table_id, or 0 if it is truncated
+    static size_t peekSectionSize(Common::ReadStream& stream)
+    {
+        if (stream.leftBytes() < 3) {
+            return 0;
+        }
+
+        Common::ReadStream header(stream);
+        header.skip(1);
+        return 3 + (header.getBe16U() & 0x0FFF);
+    }
+
+    // Size of a table with version and a 16-bit length after table_id, as MPT and PLT, or 0 if it is truncated
+    static size_t peekTableSize(Common::ReadStream& stream)
+    {
+        if (stream.leftBytes() < 4) {
+            return 0;
+        }
+
+        Common::ReadStream header(stream);
+        header.skip(2);
+        return 4 + header.getBe16U();
+    }
+
 };
 
 }
\ No newline at end of file
@@ -8,56 +8,82 @@
 #include "plt.h"
 #include "mhBit.h"
 #include "mhAit.h"
-#include <unordered_map>
-#include <functional>
 
 namespace MmtTlv {
 
-static const std::unordered_map<uint8_t, std::function<std::shared_ptr<MmtTableBase>()>> mapMmtTableFactory = {
-	{ MmtTableId::Ecm_0,		[] { return std::make_shared<Ecm>(); } },
-	{ MmtTableId::MhCdt,		[] { return std::make_shared<MhCdt>(); } },
-	{ MmtTableId::MhEitPf,		[] { return std::make_shared<MhEit>(); } },
-	{ MmtTableId::MhEitS_0,		[] { return std::make_shared<MhEit>(); } },
-	{ MmtTableId::MhEitS_1,		[] { return std::make_shared<MhEit>(); } },
-	{ MmtTableId::MhEitS_2,		[] { return std::make_shared<MhEit>(); } },
-	{ MmtTableId::MhEitS_3,		[] { return std::make_shared<MhEit>(); } },
-	{ MmtTableId::MhEitS_4,		[] { return std::make_shared<MhEit>(); } },
-	{ MmtTableId::MhEitS_5,		[] { return std::make_shared<MhEit>(); } },
-	{ MmtTableId::MhEitS_6,		[] { return std::make_shared<MhEit>(); } },
-	{ MmtTableId::MhEitS_7,		[] { return std::make_shared<MhEit>(); } },
-	{ MmtTableId::MhEitS_8,		[] { return std::make_shared<MhEit>(); } },
-	{ MmtTableId::MhEitS_9,		[] { return std::make_shared<MhEit>(); } },
-	{ MmtTableId::MhEitS_10,	[] { return std::make_shared<MhEit>(); } },
-	{ MmtTableId::MhEitS_11,	[] { return std::make_shared<MhEit>(); } },
-	{ MmtTableId::MhEitS_12,	[] { return std::make_shared<MhEit>(); } },
-	{ MmtTableId::MhEitS_13,	[] { return std::make_shared<MhEit>(); } },
-	{ MmtTableId::MhEitS_14,	[] { return std::make_shared<MhEit>(); } },
-	{ MmtTableId::MhEitS_15,	[] { return std::make_shared<MhEit>(); } },
-	{ MmtTableId::MhSdtActual,	[] { return std::make_shared<MhSdt>(); } },
-	{ MmtTableId::MhTot,		[] { return std::make_shared<MhTot>(); } },
-	{ MmtTableId::Mpt,			[] { return std::make_shared<Mpt>(); } },
-	{ MmtTableId::Plt,			[] { return std::make_shared<Plt>(); } },
-	{ MmtTableId::MhBit,		[] { return std::make_shared<MhBit>(); } },
-	{ MmtTableId::MhAit,		[] { return std::make_shared<MhAit>(); } },
-};
-
 std::shared_ptr<MmtTableBase> MmtTableFactory::create(uint8_t id) {
-	auto it = mapMmtTableFactory.find(id);
-	if (it == mapMmtTableFactory.end()) {
-		return {};
+	switch (id) {
+	case MmtTableId::Ecm_0:
+		return std::make_shared<Ecm>();
+	case MmtTableId::MhCdt:
+		return std::make_shared<MhCdt>();
+	case MmtTableId::MhEitPf:
+	case MmtTableId::MhEitS_0:
+	case MmtTableId::MhEitS_1:
+	case MmtTableId::MhEitS_2:
+	case MmtTableId::MhEitS_3:
+	case MmtTableId::MhEitS_4:
+	case MmtTableId::MhEitS_5:
+	case MmtTableId::MhEitS_6:
+	case MmtTableId::MhEitS_7:
+	case MmtTableId::MhEitS_8:
+	case MmtTableId::MhEitS_9:
+	case MmtTableId::MhEitS_10:
+	case MmtTableId::MhEitS_11:
+	case MmtTableId::MhEitS_12:
+	case MmtTableId::MhEitS_13:
+	case MmtTableId::MhEitS_14:
+	case MmtTableId::MhEitS_15:
+		return std::make_shared<MhEit>();
+	case MmtTableId::MhSdtActual:
+		return std::make_shared<MhSdt>();
+	case MmtTableId::MhTot:
+		return std::make_shared<MhTot>();
+	case MmtTableId::Mpt:
+		return std::make_shared<Mpt>();
+	case MmtTableId::Plt:
+		return std::make_shared<Plt>();
+	case MmtTableId::MhBit:
+		return std::make_shared<MhBit>();
+	case MmtTableId::MhAit:
+		return std::make_shared<MhAit>();
 	}
 
-	return it->second();
+	return {};
 }
 
 bool MmtTableFactory::isValidId(uint8_t id)
 {
-	auto it = mapMmtTableFactory.find(id);
-	if (it == mapMmtTableFactory.end()) {
-		return false;
+	switch (id) {
+	case MmtTableId::Ecm_0:
+	case MmtTableId::MhCdt:
+	case MmtTableId::MhEitPf:
+	case MmtTableId::MhEitS_0:
+	case MmtTableId::MhEitS_1:
+	case MmtTableId::MhEitS_2:
+	case MmtTableId::MhEitS_3:
+	case MmtTableId::MhEitS_4:
+	case MmtTableId::MhEitS_5:
+	case MmtTableId::MhEitS_6:
+	case MmtTableId::MhEitS_7:
+	case MmtTableId::MhEitS_8:
+	case MmtTableId::MhEitS_9:
+	case MmtTableId::MhEitS_10:
+	case MmtTableId::MhEitS_11:
+	case MmtTableId::MhEitS_12:
+	case MmtTableId::MhEitS_13:
+	case MmtTableId::MhEitS_14:
+	case MmtTableId::MhEitS_15:
+	case MmtTableId::MhSdtActual:
+	case MmtTableId::MhTot:
+	case MmtTableId::Mpt:
+	case MmtTableId::Plt:
+	case MmtTableId::MhBit:
+	case MmtTableId::MhAit:
+		return true;
 	}
 
-	return true;
+	return false;
 }
 
 }
\ No newline at end of file
@@ -31,417 +31,172 @@
 #include "ntp.h"
 #include "dataTransmissionMessage.h"
 #include "caMessage.h"
+#include "crc32.h"
 #include <algorithm>
 
 namespace MmtTlv {
 
-MmtTlvDemuxer::MmtTlvDemuxer()
-{
-    smartCard = std::make_shared<Acas::SmartCard>();
-    acasCard = std::make_unique<Acas::AcasCard>(smartCard);
-}
+namespace {
 
-bool MmtTlvDemuxer::init()
+// Checks the CRC_32 ending a table in MPEG-2 section format, located by its 12-bit section_length.
+// sectionSize is set to the size of the section, or 0 if it runs past the end of the stream.
+bool checkSectionCrc(const Common::ReadStream& stream, size_t& sectionSize)
 {
-    try {
-        smartCard->init();
-        smartCard->connect();
+    sectionSize = 0;
+    if (stream.leftBytes() < 3) {
+        return false;
     }
-    catch (const std::runtime_error& e) {
-        std::cerr << e.what() << std::endl;
+
+    const uint8_t* data = stream.getCurrentData();
+    const size_t size = 3 + ((data[1] & 0x0F) << 8 | data[2]);
+    if (size > stream.leftBytes()) {
+        return false;
     }
 
-    return true;
+    sectionSize = size;
+    return Common::checkCrc32Mpeg2(data, size);
 }
 
-void MmtTlvDemuxer::setDemuxerHandler(DemuxerHandler& demuxerHandler)
+// Copies a descriptor visited in the MPT, sharing the ownership of the MPT whose section holds its text
+template<typename T>
+std::shared_ptr<const T> keepDescriptor(const T& descriptor, const std::shared_ptr<Mpt>& mpt)
 {
-    this->demuxerHandler = &demuxerHandler;
-}
+    struct Kept {
+        std::shared_ptr<Mpt> mpt;
+        T descriptor;
+    };
 
-void MmtTlvDemuxer::setSmartCardReaderName(const std::string& smartCardReaderName) {
-    
-    smartCard->setSmartCardReaderName(smartCardReaderName);
+    auto kept = std::make_shared<Kept>(Kept{ mpt, descriptor });
+    return std::shared_ptr<const T>(kept, &kept->descriptor);
 }
 
-DemuxStatus MmtTlvDemuxer::demux(Common::ReadStream& stream)
+// MMT-SI tables from ECM to EMT are sections ending with a CRC_32. MPT, PLT and
+// the other tables carried in MMT messages have none.
+bool hasSectionCrc(uint8_t tableId)
 {
-    size_t cur = stream.getCur();
-
-    if (stream.leftBytes() < 4) {
-        return DemuxStatus::NotEnoughBuffer;
-    }
-
-    if (!isVaildTlv(stream)) {
-        stream.skip(1);
-        return DemuxStatus::NotValidTlv;
-    }
-
-    if (!tlv.unpack(stream)) {
-        stream.setCur(cur);
-        return DemuxStatus::NotEnoughBuffer;
-    }
-
-    if (stream.leftBytes() < tlv.getDataLength()) {
-        stream.setCur(cur);
-        return DemuxStatus::NotEnoughBuffer;
-    }
-
-    statistics.tlvPacketCount++;
-
-    Common::ReadStream tlvDataStream(tlv.getData());
-
-    switch (tlv.getPacketType()) {
-    case TlvPacketType::Ipv4Packet:
-    {
-        statistics.tlvIpv4PacketCount++;
-        break;
-    }
-    case TlvPacketType::Ipv6Packet:
-    {
-        statistics.tlvIpv6PacketCount++;
-
-        IPv6Header ipv6(false);
-        if (!ipv6.unpack(tlvDataStream)) {
-            break;
-        }
-
-        if (ipv6.nexthdr == IPv6::PROTOCOL_UDP) {
-            UDPHeader udpHeader;
-            if (!udpHeader.unpack(tlvDataStream)) {
-                break;
-            }
-
-            // NTP
-            if (udpHeader.destination_port == IPv6::PORT_NTP) {
-                NTPv4 ntp;
-                if (!ntp.unpack(tlvDataStream)) {
-                    break;
-                }
-
-                demuxerHandler->onNtp(std::make_shared<NTPv4>(ntp));
-            }
-        }
-        break;
-    }
-    case TlvPacketType::HeaderCompressedIpPacket:
-    {
-        statistics.tlvHeaderCompressedIpPacketCount++;
-
-        if (!compressedIPPacket.unpack(tlvDataStream)) {
-            break;
-        }
-        
-        if (!mmt.unpack(tlvDataStream)) {
-            break;
-        }
-        
-        auto mmtStat = statistics.getMmtStat(mmt.packetId);
-        if (mmtStat->count == 0) {
-            mmtStat->lastPacketSequenceNumber = mmt.packetSequenceNumber;
-            mmtStat->count++;
-        }
-        else {
-            auto mmtStat = statistics.getMmtStat(mmt.packetId);
-            if (mmtStat->lastPacketSequenceNumber + 1 != mmt.packetSequenceNumber) {
-                mmtStat->drop++;
-            }
-            mmtStat->lastPacketSequenceNumber = mmt.packetSequenceNumber;
-            mmtStat->count++;
-        }
-
-        if (mmt.extensionHeaderScrambling.has_value()) {
-            if (mmt.extensionHeaderScrambling->encryptionFlag == EncryptionFlag::ODD ||
-                mmt.extensionHeaderScrambling->encryptionFlag == EncryptionFlag::EVEN) {
-                auto lastEcm = acasCard->getLastEcm();
-                if (!lastEcm) {
-                    return DemuxStatus::WattingForEcm;
-                }
-                
-                mmt.decryptPayload(*lastEcm);
-            }
-        }
-
-        Common::ReadStream mmtpPayloadStream(mmt.payload);
-        switch (mmt.payloadType) {
-        case PayloadType::Mpu:
-            processMpu(mmtpPayloadStream);
-            break;
-        case PayloadType::ContainsOneOrMoreControlMessage:
-            processSignalingMessages(mmtpPayloadStream);
-            break;
-        default:
-            break;
-        }
-        break;
-    }
-    case TlvPacketType::TransmissionControlSignalPacket:
-    {
-        statistics.tlvTransmissionControlSignalPacketCount++;
-        processTlvTable(tlvDataStream);
-        break;
-    }
-    case TlvPacketType::NullPacket:
-    {
-        statistics.tlvNullPacketCount++;
-        break;
-    }
-    default:
-    {
-        statistics.tlvUndefinedCount++;
-    }
-    }
+    return tableId >= MmtTableId::Ecm_0 && tableId <= MmtTableId::Emt;
+}
 
-    return DemuxStatus::Ok;
 }
 
-void MmtTlvDemuxer::processPaMessage(Common::ReadStream& stream)
-{
-    PaMessage message;
-    if (!message.unpack(stream)) {
-        return;
-    }
+// Demuxer for handlers known only through the virtual interface
+template class MmtTlvDemuxer<DemuxerHandler>;
 
-    Common::ReadStream nstream(message.table);
-    while (!nstream.isEof()) {
-        processMmtTable(nstream);
-    }
+MmtTlvDemuxerBase::MmtTlvDemuxerBase()
+{
+    smartCard = std::make_shared<Acas::SmartCard>();
+    acasCard = std::make_unique<Acas::AcasCard>(smartCard);
 }
 
-void MmtTlvDemuxer::processM2SectionMessage(Common::ReadStream& stream)
+bool MmtTlvDemuxerBase::init()
 {
-    M2SectionMessage message;
-    if (!message.unpack(stream)) {
-        return;
+    try {
+        smartCard->init();
+        smartCard->connect();
+    }
+    catch (const std::runtime_error& e) {
+        std::cerr << e.what() << std::endl;
     }
 
-    processMmtTable(stream);
+    return true;
 }
 
-void MmtTlvDemuxer::processCaMessage(Common::ReadStream& stream)
-{
-    CaMessage message;
-    if (!message.unpack(stream)) {
-        return;
-    }
+void MmtTlvDemuxerBase::setSmartCardReaderName(const std::string& smartCardReaderName) {
     
-    processMmtTable(stream);
-}
-
-void MmtTlvDemuxer::processM2ShortSectionMessage(Common::ReadStream& stream)
-{
-    M2ShortSectionMessage message;
-    if (!message.unpack(stream)) {
-        return;
-    }
-
-    processMmtTable(stream);
+    smartCard->setSmartCardReaderName(smartCardReaderName);
 }
 
-void MmtTlvDemuxer::processDataTransmissionMessage(Common::ReadStream& stream)
+void MmtTlvDemuxerBase::setUseHugePages(bool useHugePages)
 {
-    DataTransmissionMessage message;
-    if (!message.unpack(stream)) {
-        return;
-    }
-    
-    processMmtTable(stream);
+    this->useHugePages = useHugePages;
 }
 
-void MmtTlvDemuxer::processTlvTable(Common::ReadStream& stream)
+std::shared_ptr<TlvTableBase> MmtTlvDemuxerBase::unpackTlvTable(Common::ReadStream& stream)
 {
     if (stream.leftBytes() < 2) {
-        return;
+        return nullptr;
     }
 
     uint8_t tableId = stream.peek8U();
-    const auto table = TlvTableFactory::create(tableId);
+    auto table = TlvTableFactory::create(tableId);
     if (table == nullptr) {
-        return;
+        return nullptr;
     }
 
-    if (!table->unpack(stream)) {
-        return;
+    // Every TLV-SI table is a section ending with a CRC_32
+    size_t sectionSize;
+    if (!checkSectionCrc(stream, sectionSize)) {
+        statistics.tlvCrcErrorSectionCount++;
+        return nullptr;
     }
 
-    switch (tableId) {
-    case TlvTableId::Nit:
-        if (demuxerHandler) {
-            demuxerHandler->onNit(std::dynamic_pointer_cast<Nit>(table));
-        }
-        break;
+    if (!table->unpack(stream)) {
+        return nullptr;
     }
+
+    return table;
 }
 
-void MmtTlvDemuxer::processMmtTable(Common::ReadStream& stream)
+std::shared_ptr<MmtTableBase> MmtTlvDemuxerBase::unpackMmtTable(Common::ReadStream& stream)
 {
     uint8_t tableId = stream.peek8U();
-    processMmtTableStatistics(tableId);
+    statistics.getMmtStat(mmt.packetId).tableId = tableId;
+
+    // Unchanged sections are handed out again from the cache, so the handler still sees every repetition
+    SectionKey sectionKey;
+    bool cacheable = SectionCache::readKey(mmt.packetId, stream.getCurrentData(), stream.leftBytes(), sectionKey);
+    if (cacheable) {
+        const std::shared_ptr<MmtTableBase>* cachedTable = sectionCache.find(sectionKey);
+        if (cachedTable) {
+            stream.skip(sectionKey.size);
+            statistics.skippedSectionCount++;
+            return *cachedTable;
+        }
+    }
 
-    const auto table = MmtTableFactory::create(tableId);
+    auto table = MmtTableFactory::create(tableId);
     if (table == nullptr) {
         stream.skip(stream.leftBytes());
-        return;
+        return nullptr;
+    }
+
+    // Checked after the cache lookup: a repetition whose CRC_32 matches an accepted section needs no check
+    size_t sectionSize;
+    if (hasSectionCrc(tableId) && !checkSectionCrc(stream, sectionSize)) {
+        statistics.crcErrorSectionCount++;
+        // Only the broken section is dropped, the tables after it in the message are still read.
+        // A section_length running past the message leaves nothing to resynchronize on.
+        stream.skip(sectionSize ? sectionSize : stream.leftBytes());
+        return nullptr;
+    }
+
+    if (!table->unpack(stream)) {
+        // Remember only sections that unpacked completely, or a broken one would keep being served
+        cacheable = false;
     }
 
-    table->unpack(stream);
+    if (cacheable) {
+        sectionCache.store(sectionKey, table);
+    }
 
     switch (tableId) {
     case MmtTableId::Mpt:
     {
-        processMmtPackageTable(std::dynamic_pointer_cast<Mpt>(table));
+        processMmtPackageTable(std::static_pointer_cast<Mpt>(table));
         break;
     }
     case MmtTableId::Ecm_0:
     {
-        processEcm(std::dynamic_pointer_cast<Ecm>(table));
+        processEcm(std::static_pointer_cast<Ecm>(table));
         break;
     }
     }
-    
-    if (demuxerHandler) {
-        switch (tableId) {
-        case MmtTableId::Ecm_0:
-            demuxerHandler->onEcm(std::dynamic_pointer_cast<Ecm>(table));
-            break;
-        case MmtTableId::MhCdt:
-            demuxerHandler->onMhCdt(std::dynamic_pointer_cast<MhCdt>(table));
-            break;
-        case MmtTableId::MhEitPf:
-        case MmtTableId::MhEitS_0:
-        case MmtTableId::MhEitS_1:
-        case MmtTableId::MhEitS_2:
-        case MmtTableId::MhEitS_3:
-        case MmtTableId::MhEitS_4:
-        case MmtTableId::MhEitS_5:
-        case MmtTableId::MhEitS_6:
-        case MmtTableId::MhEitS_7:
-        case MmtTableId::MhEitS_8:
-        case MmtTableId::MhEitS_9:
-        case MmtTableId::MhEitS_10:
-        case MmtTableId::MhEitS_11:
-        case MmtTableId::MhEitS_12:
-        case MmtTableId::MhEitS_13:
-        case MmtTableId::MhEitS_14:
-        case MmtTableId::MhEitS_15:
-            demuxerHandler->onMhEit(std::dynamic_pointer_cast<MhEit>(table));
-            break;
-        case MmtTableId::MhSdtActual:
-            demuxerHandler->onMhSdtActual(std::dynamic_pointer_cast<MhSdt>(table));
-            break;
-        case MmtTableId::MhTot:
-            demuxerHandler->onMhTot(std::dynamic_pointer_cast<MhTot>(table));
-            break;
-        case MmtTableId::Mpt:
-            demuxerHandler->onMpt(std::dynamic_pointer_cast<Mpt>(table));
-            break;
-        case MmtTableId::Plt:
-            demuxerHandler->onPlt(std::dynamic_pointer_cast<Plt>(table));
-            break;
-        case MmtTableId::MhBit:
-            demuxerHandler->onMhBit(std::dynamic_pointer_cast<MhBit>(table));
-            break;
-        case MmtTableId::MhAit:
-            demuxerHandler->onMhAit(std::dynamic_pointer_cast<MhAit>(table));
-            break;
-        }
-    }
-}
 
-void MmtTlvDemuxer::processMmtTableStatistics(uint8_t tableId)
-{
-    switch (tableId) {
-    case MmtTableId::Pat:
-        statistics.getMmtStat(mmt.packetId)->setName("PAT");
-        break;
-    case MmtTableId::Ecm_0:
-        statistics.getMmtStat(mmt.packetId)->setName("ECM");
-        break;
-    case MmtTableId::Ecm_1:
-        statistics.getMmtStat(mmt.packetId)->setName("ECM");
-        break;
-    case MmtTableId::MhCdt:
-        statistics.getMmtStat(mmt.packetId)->setName("MH-CDT");
-        break;
-    case MmtTableId::MhEitPf:
-        statistics.getMmtStat(mmt.packetId)->setName("MH-EIT");
-        break;
-    case MmtTableId::MhEitS_0:
-    case MmtTableId::MhEitS_1:
-    case MmtTableId::MhEitS_2:
-    case MmtTableId::MhEitS_3:
-    case MmtTableId::MhEitS_4:
-    case MmtTableId::MhEitS_5:
-    case MmtTableId::MhEitS_6:
-    case MmtTableId::MhEitS_7:
-    case MmtTableId::MhEitS_8:
-    case MmtTableId::MhEitS_9:
-    case MmtTableId::MhEitS_10:
-    case MmtTableId::MhEitS_11:
-    case MmtTableId::MhEitS_12:
-    case MmtTableId::MhEitS_13:
-    case MmtTableId::MhEitS_14:
-    case MmtTableId::MhEitS_15:
-        statistics.getMmtStat(mmt.packetId)->setName("MH-EIT");
-        break;
-    case MmtTableId::MhSdtActual:
-        statistics.getMmtStat(mmt.packetId)->setName("MH-SDT");
-        break;
-    case MmtTableId::MhSdtOther:
-        statistics.getMmtStat(mmt.packetId)->setName("MH-SDT");
-        break;
-    case MmtTableId::MhTot:
-        statistics.getMmtStat(mmt.packetId)->setName("MH-TOT");
-        break;
-    case MmtTableId::Mpt:
-        statistics.getMmtStat(mmt.packetId)->setName("MPT");
-        break;
-    case MmtTableId::Plt:
-        statistics.getMmtStat(mmt.packetId)->setName("PLT");
-        break;
-    case MmtTableId::MhBit:
-        statistics.getMmtStat(mmt.packetId)->setName("MH-BIT");
-        break;
-    case MmtTableId::Lct:
-        statistics.getMmtStat(mmt.packetId)->setName("LCT");
-        break;
-    case MmtTableId::Emm_0:
-        statistics.getMmtStat(mmt.packetId)->setName("EMM");
-        break;
-    case MmtTableId::Emm_1:
-        statistics.getMmtStat(mmt.packetId)->setName("EMM");
-        break;
-    case MmtTableId::Cat:
-        statistics.getMmtStat(mmt.packetId)->setName("CAT");
-        break;
-    case MmtTableId::Dcm:
-        statistics.getMmtStat(mmt.packetId)->setName("DCM");
-        break;
-    case MmtTableId::Dmm:
-        statistics.getMmtStat(mmt.packetId)->setName("DMM");
-        break;
-    case MmtTableId::MhSdtt:
-        statistics.getMmtStat(mmt.packetId)->setName("MH-SDTT");
-        break;
-    case MmtTableId::MhAit:
-        statistics.getMmtStat(mmt.packetId)->setName("MH-AIT");
-        break;
-    case MmtTableId::Ddmt:
-        statistics.getMmtStat(mmt.packetId)->setName("DDMT");
-        break;
-    case MmtTableId::Damt:
-        statistics.getMmtStat(mmt.packetId)->setName("DAMT");
-        break;
-    case MmtTableId::Dcct:
-        statistics.getMmtStat(mmt.packetId)->setName("DCCT");
-        break;
-    case MmtTableId::Emt:
-        statistics.getMmtStat(mmt.packetId)->setName("EMT");
-        break;
-    }
+    // Handed out even if it did not unpack completely
+    return table;
 }
 
-void MmtTlvDemuxer::processMmtPackageTable(const std::shared_ptr<Mpt>& mpt)
+void MmtTlvDemuxerBase::processMmtPackageTable(const std::shared_ptr<Mpt>& mpt)
 {
     // Remove streams that do not exist in the MPT
     std::map<uint16_t, uint32_t> mapMpt; // packetId, assetType
@@ -454,23 +209,13 @@ void MmtTlvDemuxer::processMmtPackageTable(const std::shared_ptr<Mpt>& mpt)
     }
 
     if (mapMpt.size()) {
-        for (auto it = mapStream.begin(); it != mapStream.end(); ) {
-            auto mptIt = mapMpt.find(it->first);
-            if (mptIt != mapMpt.end()) {
-                if (mptIt->second != it->second->assetType) {
-                    it = mapStream.erase(it);
-                }
-                else {
-                    ++it;
-                }
-            }
-            else {
-                it = mapStream.erase(it);
-            }
-        }
+        streams.eraseIf([&mapMpt](const auto& entry) {
+            auto mptIt = mapMpt.find(entry.first);
+            return mptIt == mapMpt.end() || mptIt->second != entry.second->assetType;
+        });
     }
 
-    mapStreamByStreamIdx.clear();
+    streamsByIndex.clear();
 
     int streamIndex = 0;
     for (const auto& asset : mpt->assets) {
@@ -485,7 +230,8 @@ void MmtTlvDemuxer::processMmtPackageTable(const std::shared_ptr<Mpt>& mpt)
                     mmtStream = getStream(locationInfo.packetId);
                     if (!mmtStream) {
                         mmtStream = std::make_shared<MmtStream>(locationInfo.packetId);
-                        mapStream[locationInfo.packetId] = mmtStream;
+                        mmtStream->frameBufferPool.setUseHugePages(useHugePages);
+                        streams.tryEmplace(locationInfo.packetId, mmtStream);
                     }
                     mmtStream->assetType = asset.assetType;
                     mmtStream->streamIndex = streamIndex;
@@ -494,8 +240,8 @@ void MmtTlvDemuxer::processMmtPackageTable(const std::shared_ptr<Mpt>& mpt)
                         mmtStream->mfuDataProcessor = MfuDataProcessorFactory::create(mmtStream->assetType);
                     }
 
-                    mapStreamByStreamIdx[streamIndex] = mmtStream;
-                    statistics.getMmtStat(locationInfo.packetId)->assetType = asset.assetType;
+                    streamsByIndex.push_back(mmtStream);
+                    statistics.getMmtStat(locationInfo.packetId).assetType = asset.assetType;
                     ++streamIndex;
                 }
             }
@@ -505,154 +251,69 @@ void MmtTlvDemuxer::processMmtPackageTable(const std::shared_ptr<Mpt>& mpt)
             continue;
         }
 
-        for (const auto& descriptor : asset.descriptors.list) {
-            switch (descriptor->getDescriptorTag()) {
-            case MpuTimestampDescriptor::kDescriptorTag:
-            {
-                processMpuTimestampDescriptor(std::dynamic_pointer_cast<MpuTimestampDescriptor>(descriptor), mmtStream);
-                break;
-            }
-            case MpuExtendedTimestampDescriptor::kDescriptorTag:
-            {
-                processMpuExtendedTimestampDescriptor(std::dynamic_pointer_cast<MpuExtendedTimestampDescriptor>(descriptor), mmtStream);
-                break;
-            }
-            case MhStreamIdentificationDescriptor::kDescriptorTag:
-            {
-                auto mmtDescriptor = std::dynamic_pointer_cast<MmtTlv::MhStreamIdentificationDescriptor>(descriptor);
-                mmtStream->componentTag = mmtDescriptor->componentTag;
-                break;
-            }
-            case VideoComponentDescriptor::kDescriptorTag:
-            {
-                auto mmtDescriptor = std::dynamic_pointer_cast<MmtTlv::VideoComponentDescriptor>(descriptor);
-                mmtStream->videoComponentDescriptor = mmtDescriptor;
-
-                statistics.getMmtStat(mmtStream->packetId)->videoResolution = mmtDescriptor->videoResolution;
-                statistics.getMmtStat(mmtStream->packetId)->videoAspectRatio = mmtDescriptor->videoAspectRatio;
-                break;
-            }
-            case MhAudioComponentDescriptor::kDescriptorTag:
-            {
-                auto mmtDescriptor = std::dynamic_pointer_cast<MmtTlv::MhAudioComponentDescriptor>(descriptor);
-                mmtStream->mhAudioComponentDescriptor = mmtDescriptor;
-                
-                statistics.getMmtStat(mmtStream->packetId)->audioComponentType = mmtDescriptor->componentType;
-                statistics.getMmtStat(mmtStream->packetId)->audioSamplingRate = mmtDescriptor->samplingRate;
-                break;
-            }
-            }
-        }
+        asset.descriptors.visit(Overloaded{
+            [&](const MpuTimestampDescriptor& descriptor) {
+                processMpuTimestampDescriptor(descriptor, mmtStream);
+            },
+            [&](const MpuExtendedTimestampDescriptor& descriptor) {
+                processMpuExtendedTimestampDescriptor(descriptor, mmtStream);
+            },
+            [&](const MhStreamIdentificationDescriptor& descriptor) {
+                mmtStream->componentTag = descriptor.componentTag;
+            },
+            [&](const VideoComponentDescriptor& descriptor) {
+                mmtStream->videoComponentDescriptor = keepDescriptor(descriptor, mpt);
+
+                statistics.getMmtStat(mmtStream->packetId).videoResolution = descriptor.videoResolution;
+                statistics.getMmtStat(mmtStream->packetId).videoAspectRatio = descriptor.videoAspectRatio;
+            },
+            [&](const MhAudioComponentDescriptor& descriptor) {
+                mmtStream->mhAudioComponentDescriptor = keepDescriptor(descriptor, mpt);
+
+                statistics.getMmtStat(mmtStream->packetId).audioComponentType = descriptor.componentType;
+                statistics.getMmtStat(mmtStream->packetId).audioSamplingRate = descriptor.samplingRate;
+            },
+        });
     }
 }
 
-void MmtTlvDemuxer::processMpuTimestampDescriptor(const std::shared_ptr<MpuTimestampDescriptor>& descriptor, std::shared_ptr<MmtStream>& mmtStream)
+void MmtTlvDemuxerBase::processMpuTimestampDescriptor(const MpuTimestampDescriptor& descriptor, std::shared_ptr<MmtStream>& mmtStream)
 {
-    for (const auto& ts : descriptor->entries) {
-        bool find = false;
-        for (size_t i = 0; i < mmtStream->mpuTimestamps.size(); i++) {
-            if (mmtStream->mpuTimestamps[i].mpuSequenceNumber == ts.mpuSequenceNumber) {
-                mmtStream->mpuTimestamps[i].mpuPresentationTime = ts.mpuPresentationTime;
-                find = true;
-                break;
-            }
-        }
-        if (find) {
-            continue;
-        }
-
-        for (size_t i = 0; i < mmtStream->mpuTimestamps.size(); i++) {
-            if (mmtStream->mpuTimestamps[i].mpuSequenceNumber < mmtStream->lastMpuSequenceNumber) {
-                mmtStream->mpuTimestamps[i].mpuSequenceNumber = ts.mpuSequenceNumber;
-                mmtStream->mpuTimestamps[i].mpuPresentationTime = ts.mpuPresentationTime;
-                find = true;
-                break;
-            }
-        }
-
-        if (find) {
-            continue;
-        }
-
-        if (mmtStream->mpuTimestamps.size() >= 100) {
-            auto minElement = std::min_element(mmtStream->mpuTimestamps.begin(), mmtStream->mpuTimestamps.end(), 
-                [](const auto& lhs, const auto& rhs) {
-                    return lhs.mpuSequenceNumber < rhs.mpuSequenceNumber;
-                });
-
-            if (minElement != mmtStream->mpuTimestamps.end()) {
-                minElement->mpuSequenceNumber = ts.mpuSequenceNumber;
-                minElement->mpuPresentationTime = ts.mpuPresentationTime;
-            }
-        }
-        else {
-            mmtStream->mpuTimestamps.push_back(ts);
-        }
+    for (const auto& ts : descriptor.entries) {
+        mmtStream->setMpuPresentationTime(ts);
     }
 }
 
-void MmtTlvDemuxer::processMpuExtendedTimestampDescriptor(const std::shared_ptr<MpuExtendedTimestampDescriptor>& descriptor, std::shared_ptr<MmtStream>& mmtStream)
+void MmtTlvDemuxerBase::processMpuExtendedTimestampDescriptor(const MpuExtendedTimestampDescriptor& descriptor, std::shared_ptr<MmtStream>& mmtStream)
 {
-    if (descriptor->timescaleFlag) {
-        mmtStream->timeBase.num = 1;
-        mmtStream->timeBase.den = descriptor->timescale;
+    if (descriptor.timescaleFlag) {
+        mmtStream->setTimeBase(1, descriptor.timescale);
     }
 
-    for (const auto& ts : descriptor->entries) {
-        if (mmtStream->lastMpuSequenceNumber > ts.mpuSequenceNumber)
-            continue;
+    if (descriptor.entries.empty()) {
+        return;
+    }
 
-        bool find = false;
-        for (size_t i = 0; i < mmtStream->mpuExtendedTimestamps.size(); i++) {
-            if (mmtStream->mpuExtendedTimestamps[i].mpuSequenceNumber == ts.mpuSequenceNumber) {
-                mmtStream->mpuExtendedTimestamps[i].mpuDecodingTimeOffset = ts.mpuDecodingTimeOffset;
-                mmtStream->mpuExtendedTimestamps[i].numOfAu = ts.numOfAu;
-                mmtStream->mpuExtendedTimestamps[i].ptsOffsets = ts.ptsOffsets;
-                mmtStream->mpuExtendedTimestamps[i].dtsPtsOffsets = ts.dtsPtsOffsets;
-                find = true;
-                break;
-            }
-        }
-        if (find) {
-            continue;
-        }
+    // Older MPUs are still needed if access units of them are waiting for their timestamps.
+    uint32_t oldestNeededMpuSequenceNumber = mmtStream->lastMpuSequenceNumber;
+    if (!mmtStream->pendingAccessUnits.empty()) {
+        oldestNeededMpuSequenceNumber = std::min(oldestNeededMpuSequenceNumber, mmtStream->pendingAccessUnits.front().mpuSequenceNumber);
+    }
 
-        for (size_t i = 0; i < mmtStream->mpuExtendedTimestamps.size(); i++) {
-            if (mmtStream->mpuExtendedTimestamps[i].mpuSequenceNumber < mmtStream->lastMpuSequenceNumber) {
-                mmtStream->mpuExtendedTimestamps[i].mpuSequenceNumber = ts.mpuSequenceNumber;
-                mmtStream->mpuExtendedTimestamps[i].mpuDecodingTimeOffset = ts.mpuDecodingTimeOffset;
-                mmtStream->mpuExtendedTimestamps[i].numOfAu = ts.numOfAu;
-                mmtStream->mpuExtendedTimestamps[i].ptsOffsets = ts.ptsOffsets;
-                mmtStream->mpuExtendedTimestamps[i].dtsPtsOffsets = ts.dtsPtsOffsets;
-                find = true;
-                break;
-            }
-        }
-        if (find) {
+    uint32_t oldestDescribedMpuSequenceNumber = descriptor.entries.front().mpuSequenceNumber;
+    for (const auto& ts : descriptor.entries) {
+        oldestDescribedMpuSequenceNumber = std::min(oldestDescribedMpuSequenceNumber, ts.mpuSequenceNumber);
+
+        if (oldestNeededMpuSequenceNumber > ts.mpuSequenceNumber)
             continue;
-        }
 
-        if (mmtStream->mpuExtendedTimestamps.size() >= 100) {
-            auto minElement = std::min_element(mmtStream->mpuExtendedTimestamps.begin(), mmtStream->mpuExtendedTimestamps.end(),
-                [](const auto& lhs, const auto& rhs) {
-                    return lhs.mpuSequenceNumber < rhs.mpuSequenceNumber;
-                });
-
-            if (minElement != mmtStream->mpuExtendedTimestamps.end()) {
-                minElement->mpuSequenceNumber = ts.mpuSequenceNumber;
-                minElement->mpuDecodingTimeOffset = ts.mpuDecodingTimeOffset;
-                minElement->numOfAu = ts.numOfAu;
-                minElement->ptsOffsets = ts.ptsOffsets;
-                minElement->dtsPtsOffsets = ts.dtsPtsOffsets;
-            }
-        }
-        else {
-            mmtStream->mpuExtendedTimestamps.push_back(ts);
-        }
+        mmtStream->setMpuExtendedTimestamp(ts);
     }
+
+    mmtStream->oldestDescribedMpuSequenceNumber = oldestDescribedMpuSequenceNumber;
 }
 
-void MmtTlvDemuxer::processEcm(std::shared_ptr<Ecm> ecm)
+void MmtTlvDemuxerBase::processEcm(std::shared_ptr<Ecm> ecm)
 {
     try {
         acasCard->processEcm(ecm->ecmData);
@@ -662,221 +323,61 @@ void MmtTlvDemuxer::processEcm(std::shared_ptr<Ecm> ecm)
     }
 }
 
-void MmtTlvDemuxer::clear()
+void MmtTlvDemuxerBase::clear()
 {
-    mapAssembler.clear();
+    assemblers.clear();
     mfuData.clear();
-    mapStream.clear();
-    mapStreamByStreamIdx.clear();
+    streams.clear();
+    streamsByIndex.clear();
+    sectionCache.clear();
     acasCard->clear();
     statistics.clear();
 }
 
-void MmtTlvDemuxer::release()
+void MmtTlvDemuxerBase::release()
 {
     smartCard->release();
 }
 
-void MmtTlvDemuxer::printStatistics() const
+void MmtTlvDemuxerBase::printStatistics() const
 {
     statistics.print();
-}
 
-std::shared_ptr<FragmentAssembler> MmtTlvDemuxer::getAssembler(uint16_t packetId)
-{
-    if (mapAssembler.find(packetId) == mapAssembler.end()) {
-        auto assembler = std::make_shared<FragmentAssembler>();
-        mapAssembler[packetId] = assembler;
-        return assembler;
-    }
-    else {
-        return mapAssembler[packetId];
-    }
-}
+    std::cerr << "Frame Buffer Pool:" << std::endl;
+    for (const auto& [packetId, mmtStream] : streams) {
+        const FrameBufferPool& pool = mmtStream->frameBufferPool;
 
-std::shared_ptr<MmtStream> MmtTlvDemuxer::getStream(uint16_t packetId)
-{
-    if (mapStream.find(packetId) == mapStream.end()) {
-        return nullptr;
-    }
-    else {
-        return mapStream[packetId];
+        std::ostringstream oss;
+        oss << " - PacketId: 0x" << std::setw(4) << std::setfill('0') << std::hex << std::uppercase << packetId << std::dec;
+        oss << ", Pooled: " << pool.getPooledCount();
+        oss << ", ReserveSize: " << pool.getReserveSize();
+        oss << ", HitRate: " << std::fixed << std::setprecision(1) << pool.getHitRate() * 100 << "%";
+        oss << " (" << pool.getHitCount() << "/" << pool.getAcquireCount() << ")";
+        std::cerr << oss.str() << std::endl;
     }
 }
 
-void MmtTlvDemuxer::processMpu(Common::ReadStream& stream)
+FragmentAssembler& MmtTlvDemuxerBase::getAssembler(uint16_t packetId)
 {
-    if (!mpu.unpack(stream)) {
-        return;
-    }
-
-    auto assembler = getAssembler(mmt.packetId);
-    Common::ReadStream nstream(mpu.payload);
-    std::shared_ptr<MmtStream> mmtStream = getStream(mmt.packetId);
-
-    if (!mmtStream) {
-        return;
-    }
-
-    if (mpu.aggregateFlag && mpu.fragmentationIndicator != FragmentationIndicator::NotFragmented) {
-        return;
-    }
-
-    if (mpu.fragmentType != FragmentType::Mfu) {
-        return;
-    }
-
-    if (assembler->state == FragmentAssembler::State::Init) {
-        mmtStream->lastMpuSequenceNumber = mpu.mpuSequenceNumber;
-    }
-    else if (mpu.mpuSequenceNumber == mmtStream->lastMpuSequenceNumber + 1) {
-        mmtStream->lastMpuSequenceNumber = mpu.mpuSequenceNumber;
-        mmtStream->auIndex = 0;
-    }
-    else if (mpu.mpuSequenceNumber != mmtStream->lastMpuSequenceNumber) {
-        assembler->state = FragmentAssembler::State::Init;
-        return;
-    }
-
-    assembler->checkState(mmt.packetSequenceNumber);
-
-    mmtStream->rapFlag = mmt.rapFlag;
-    
-
-    if (mpu.aggregateFlag == 0) {
-        DataUnit dataUnit;
-        if (!dataUnit.unpack(nstream, mpu.timedFlag, mpu.aggregateFlag)) {
-            return;
-        }
-
-        if (assembler->assemble(dataUnit.data, mpu.fragmentationIndicator, mmt.packetSequenceNumber)) {
-            Common::ReadStream dataStream(assembler->data);
-            processMfuData(dataStream);
-            assembler->clear();
-        }
-    }
-    else
-    {
-        while (!nstream.isEof()) {
-            DataUnit dataUnit;
-            if (!dataUnit.unpack(nstream, mpu.timedFlag, mpu.aggregateFlag)) {
-                return;
-            }
-
-            if (assembler->assemble(dataUnit.data, mpu.fragmentationIndicator, mmt.packetSequenceNumber)) {
-                Common::ReadStream dataStream(assembler->data);
-                processMfuData(dataStream);
-                assembler->clear();
-            }
-        }
-    }
+    return assemblers.tryEmplace(packetId);
 }
 
-void MmtTlvDemuxer::processMfuData(Common::ReadStream& stream)
+const std::shared_ptr<MmtStream>& MmtTlvDemuxerBase::getStream(uint16_t packetId) const
 {
-    std::shared_ptr<MmtStream> mmtStream = getStream(mmt.packetId);
-    if (!mmtStream) {
-        return;
-    }
-
-    if (!mmtStream->mfuDataProcessor) {
-        return;
-    }
+    static const std::shared_ptr<MmtStream> empty;
 
-    std::vector<uint8_t> data(stream.leftBytes());
-    stream.read(data.data(), stream.leftBytes());
-
-    const auto ret = mmtStream->mfuDataProcessor->process(mmtStream, data);
-    if (ret.has_value()) {
-        const auto& mfuData = ret.value();
-        auto it = std::next(mapStream.begin(), mfuData.streamIndex);
-        if (it == mapStream.end()) {
-            return;
-        }
-        
-        if(demuxerHandler) {
-            switch (mmtStream->assetType) {
-            case AssetType::hev1:
-                demuxerHandler->onVideoData(it->second, std::make_shared<MfuData>(mfuData));
-                break;
-            case AssetType::mp4a:
-                demuxerHandler->onAudioData(it->second, std::make_shared<MfuData>(mfuData));
-                break;
-            case AssetType::stpp:
-                demuxerHandler->onSubtitleData(it->second, std::make_shared<MfuData>(mfuData));
-                break;
-            case AssetType::aapp:
-                demuxerHandler->onApplicationData(it->second, std::make_shared<MfuData>(mfuData));
-                break;
-            }
-        }
-    }
+    const auto* mmtStream = streams.find(packetId);
+    return mmtStream ? *mmtStream : empty;
 }
 
-void MmtTlvDemuxer::processSignalingMessages(Common::ReadStream& stream)
+const std::shared_ptr<MmtStream>& MmtTlvDemuxerBase::getStreamByIndex(size_t streamIndex) const
 {
-    SignalingMessage signalingMessage;
-    if (!signalingMessage.unpack(stream)) {
-        return;
-    }
-
-    auto assembler = getAssembler(mmt.packetId);
-    assembler->checkState(mmt.packetSequenceNumber);
-
-    if (!signalingMessage.aggregationFlag) {
-        if (assembler->assemble(signalingMessage.payload, signalingMessage.fragmentationIndicator, mmt.packetSequenceNumber)) {
-            Common::ReadStream messageStream(assembler->data);
-            processSignalingMessage(messageStream);
-            assembler->clear();
-        }
-    }
-    else {
-        if (signalingMessage.fragmentationIndicator != FragmentationIndicator::NotFragmented) {
-            return;
-        }
+    static const std::shared_ptr<MmtStream> empty;
 
-        Common::ReadStream nstream(signalingMessage.payload);
-        while (nstream.isEof()) {
-            uint32_t length;
-            if (signalingMessage.lengthExtensionFlag)
-                length = nstream.getBe32U();
-            else
-                length = nstream.getBe16U();
-
-            std::vector<uint8_t> message;
-            message.resize(length);
-            stream.read(message.data(), length);
-
-            if (assembler->assemble(message, signalingMessage.fragmentationIndicator, mmt.packetSequenceNumber)) {
-                Common::ReadStream messageStream(assembler->data);
-                processSignalingMessage(messageStream);
-                assembler->clear();
-            }
-        }
-    }
-
-    return;
-}
-
-void MmtTlvDemuxer::processSignalingMessage(Common::ReadStream& stream)
-{
-    MmtMessageId id = static_cast<MmtMessageId>(stream.peekBe16U());
-
-    switch (id) {
-    case MmtMessageId::PaMessage:
-        return processPaMessage(stream);
-    case MmtMessageId::M2SectionMessage:
-        return processM2SectionMessage(stream);
-    case MmtMessageId::CaMessage:
-        return processCaMessage(stream);
-    case MmtMessageId::M2ShortSectionMessage:
-        return processM2ShortSectionMessage(stream);
-    case MmtMessageId::DataTransmissionMessage:
-        return processDataTransmissionMessage(stream);
-    }
+    return streamIndex < streamsByIndex.size() ? streamsByIndex[streamIndex] : empty;
 }
 
-bool MmtTlvDemuxer::isVaildTlv(Common::ReadStream& stream) const
+bool MmtTlvDemuxerBase::isVaildTlv(Common::ReadStream& stream) const
 {
     try {
         uint8_t bytes[2];
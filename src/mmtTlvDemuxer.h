@@ -14,15 +14,33 @@
 #include "compressedIPPacket.h"
 #include "mfuDataProcessorBase.h"
 #include "mmtTlvStatistics.h"
+#include "fragmentAssembler.h"
+#include "packetIdTable.h"
+#include "sectionCache.h"
+#include "demuxerHandler.h"
+#include "dataUnit.h"
+#include "signalingMessage.h"
+#include "paMessage.h"
+#include "m2SectionMessage.h"
+#include "m2ShortSectionMessage.h"
+#include "caMessage.h"
+#include "dataTransmissionMessage.h"
+#include "ipv6.h"
+#include "ntp.h"
+#include "ecm.h"
+#include "mhAit.h"
+#include "mhBit.h"
+#include "mhCdt.h"
+#include "mhEit.h"
+#include "mhSdt.h"
+#include "mhTot.h"
+#include "nit.h"
+#include "plt.h"
 
 namespace MmtTlv {
 
-class FragmentAssembler;
 class TableBase;
-class Plt;
-class Ecm;
 class TlvTableBase;
-class DemuxerHandler;
 
 enum class MmtMessageId {
 	PaMessage = 0x0000,
@@ -40,55 +58,546 @@ enum class DemuxStatus {
 	Error = 0x2000,
 };
 
-class MmtTlvDemuxer {
+// State of the demuxer and the parts of demuxing that do not call the handler
+class MmtTlvDemuxerBase {
 public:
-	MmtTlvDemuxer();
+	MmtTlvDemuxerBase();
 	bool init();
-	void setDemuxerHandler(DemuxerHandler& demuxerHandler);
 	void setSmartCardReaderName(const std::string& smartCardReaderName);
-	DemuxStatus demux(Common::ReadStream& stream);
+	void setUseHugePages(bool useHugePages);
 	void clear();
 	void release();
 	void printStatistics() const;
+	// Counters can be read from another thread while demuxing.
+	const mmtTlvStatistics& getStatistics() const { return statistics; }
 
-private:
+	const std::shared_ptr<MmtStream>& getStream(uint16_t packetId) const;
+	const std::shared_ptr<MmtStream>& getStreamByIndex(size_t streamIndex) const;
+
+protected:
 	bool isVaildTlv(Common::ReadStream& stream) const;
 
-	void processMpu(Common::ReadStream& stream);
-	void processMfuData(Common::ReadStream& stream);
-	void processSignalingMessages(Common::ReadStream& stream);
-	void processSignalingMessage(Common::ReadStream& stream);
-	void processPaMessage(Common::ReadStream& stream);
-	void processM2SectionMessage(Common::ReadStream& stream);
-	void processCaMessage(Common::ReadStream& stream);
-	void processM2ShortSectionMessage(Common::ReadStream& stream);
-	void processDataTransmissionMessage(Common::ReadStream& stream);
-	void processTlvTable(Common::ReadStream& stream);
-	void processMmtTable(Common::ReadStream& stream);
-	void processMmtTableStatistics(uint8_t tableId);
+	// Unpacks the table and returns it for the handler, or nullptr if there is nothing to hand out
+	std::shared_ptr<TlvTableBase> unpackTlvTable(Common::ReadStream& stream);
+	std::shared_ptr<MmtTableBase> unpackMmtTable(Common::ReadStream& stream);
+
 	void processMmtPackageTable(const std::shared_ptr<Mpt>& mpt);
-	void processMpuTimestampDescriptor(const std::shared_ptr<MpuTimestampDescriptor>& descriptor, std::shared_ptr<MmtStream>& mmtStream);
-	void processMpuExtendedTimestampDescriptor(const std::shared_ptr<MpuExtendedTimestampDescriptor>& descriptor, std::shared_ptr<MmtStream>& mmtStream);
+	void processMpuTimestampDescriptor(const MpuTimestampDescriptor& descriptor, std::shared_ptr<MmtStream>& mmtStream);
+	void processMpuExtendedTimestampDescriptor(const MpuExtendedTimestampDescriptor& descriptor, std::shared_ptr<MmtStream>& mmtStream);
 	void processEcm(std::shared_ptr<Ecm> ecm);
 
-public:
-	std::shared_ptr<MmtStream> getStream(uint16_t pid);
+	FragmentAssembler& getAssembler(uint16_t packetId);
 
-	std::map<uint16_t, std::shared_ptr<MmtStream>> mapStream;
-	std::map<uint16_t, std::shared_ptr<MmtStream>> mapStreamByStreamIdx;
-
-private:
-	std::shared_ptr<FragmentAssembler> getAssembler(uint16_t pid);
+	PacketIdTable<std::shared_ptr<MmtStream>> streams;
+	// Streams in MPT asset order, indexed by MmtStream::streamIndex
+	std::vector<std::shared_ptr<MmtStream>> streamsByIndex;
 
 	std::shared_ptr<Acas::SmartCard> smartCard;
 	std::unique_ptr<Acas::AcasCard> acasCard;
-	std::map<uint16_t, std::shared_ptr<FragmentAssembler>> mapAssembler;
+	PacketIdTable<FragmentAssembler> assemblers;
+	SectionCache sectionCache;
 	Tlv tlv;
 	CompressedIPPacket compressedIPPacket;
 	Mmt mmt;
 	Mpu mpu;
 	std::map<uint16_t, std::vector<uint8_t>> mfuData;
-	DemuxerHandler* demuxerHandler = nullptr;
+	bool useHugePages = false;
 	mmtTlvStatistics statistics;
 };
-}
\ No newline at end of file
+
+// Demuxer calling the callbacks of Handler directly, so they can be inlined into the demux loop.
+// Handler has the callbacks of DemuxerHandler; MmtTlvDemuxer<DemuxerHandler> calls them through its virtual interface.
+template<typename Handler>
+class MmtTlvDemuxer : public MmtTlvDemuxerBase {
+public:
+	void setDemuxerHandler(Handler& demuxerHandler) { this->demuxerHandler = &demuxerHandler; }
+	DemuxStatus demux(Common::ReadStream& stream);
+
+private:
+	void processMpu(Common::ReadStream& stream);
+	void processMfuData(const std::vector<uint8_t>& data);
+	void flushPendingAccessUnits(const std::shared_ptr<MmtStream>& mmtStream);
+	void deliverMfuData(const std::shared_ptr<MmtStream>& mmtStream, MfuData& mfuData);
+	void processSignalingMessages(Common::ReadStream& stream);
+	void processSignalingMessage(Common::ReadStream& stream);
+	template<typename Message>
+	void processMessage(Common::ReadStream& stream);
+	void processPaMessage(Common::ReadStream& stream);
+	void processTlvTable(Common::ReadStream& stream);
+	void processMmtTable(Common::ReadStream& stream);
+	void dispatchMmtTable(uint8_t tableId, const std::shared_ptr<MmtTableBase>& table);
+
+	Handler* demuxerHandler = nullptr;
+};
+
+extern template class MmtTlvDemuxer<DemuxerHandler>;
+
+template<typename Handler>
+DemuxStatus MmtTlvDemuxer<Handler>::demux(Common::ReadStream& stream)
+{
+	size_t cur = stream.getCur();
+
+	if (stream.leftBytes() < 4) {
+		return DemuxStatus::NotEnoughBuffer;
+	}
+
+	if (!isVaildTlv(stream)) {
+		stream.skip(1);
+		return DemuxStatus::NotValidTlv;
+	}
+
+	if (!tlv.unpack(stream)) {
+		stream.setCur(cur);
+		return DemuxStatus::NotEnoughBuffer;
+	}
+
+	if (stream.leftBytes() < tlv.getDataLength()) {
+		stream.setCur(cur);
+		return DemuxStatus::NotEnoughBuffer;
+	}
+
+	statistics.tlvPacketCount++;
+
+	Common::ReadStream tlvDataStream(tlv.getData());
+
+	switch (tlv.getPacketType()) {
+	case TlvPacketType::Ipv4Packet:
+	{
+		statistics.tlvIpv4PacketCount++;
+		break;
+	}
+	case TlvPacketType::Ipv6Packet:
+	{
+		statistics.tlvIpv6PacketCount++;
+
+		IPv6Header ipv6(false);
+		if (!ipv6.unpack(tlvDataStream)) {
+			break;
+		}
+
+		if (ipv6.nexthdr == IPv6::PROTOCOL_UDP) {
+			UDPHeader udpHeader;
+			if (!udpHeader.unpack(tlvDataStream)) {
+				break;
+			}
+
+			// NTP
+			if (udpHeader.destination_port == IPv6::PORT_NTP) {
+				NTPv4 ntp;
+				if (!ntp.unpack(tlvDataStream)) {
+					break;
+				}
+
+				if (demuxerHandler) {
+					demuxerHandler->onNtp(std::make_shared<NTPv4>(ntp));
+				}
+			}
+		}
+		break;
+	}
+	case TlvPacketType::HeaderCompressedIpPacket:
+	{
+		statistics.tlvHeaderCompressedIpPacketCount++;
+
+		if (!compressedIPPacket.unpack(tlvDataStream)) {
+			break;
+		}
+
+		if (!mmt.unpack(tlvDataStream)) {
+			break;
+		}
+
+		auto& mmtStat = statistics.getMmtStat(mmt.packetId);
+		if (statistics.isOverflowMmtStat(mmtStat)) {
+			mmtStat.count++;
+		}
+		else if (mmtStat.count == 0) {
+			mmtStat.lastPacketSequenceNumber = mmt.packetSequenceNumber;
+			mmtStat.count++;
+		}
+		else {
+			if (mmtStat.lastPacketSequenceNumber + 1 != mmt.packetSequenceNumber) {
+				mmtStat.drop++;
+			}
+			mmtStat.lastPacketSequenceNumber = mmt.packetSequenceNumber;
+			mmtStat.count++;
+		}
+
+		if (mmt.extensionHeaderScrambling.has_value()) {
+			if (mmt.extensionHeaderScrambling->encryptionFlag == EncryptionFlag::ODD ||
+				mmt.extensionHeaderScrambling->encryptionFlag == EncryptionFlag::EVEN) {
+				auto lastEcm = acasCard->getLastEcm();
+				if (!lastEcm) {
+					return DemuxStatus::WattingForEcm;
+				}
+
+				mmt.decryptPayload(*lastEcm);
+			}
+		}
+
+		Common::ReadStream mmtpPayloadStream(mmt.payload);
+		switch (mmt.payloadType) {
+		case PayloadType::Mpu:
+			processMpu(mmtpPayloadStream);
+			break;
+		case PayloadType::ContainsOneOrMoreControlMessage:
+			processSignalingMessages(mmtpPayloadStream);
+			break;
+		default:
+			break;
+		}
+		break;
+	}
+	case TlvPacketType::TransmissionControlSignalPacket:
+	{
+		statistics.tlvTransmissionControlSignalPacketCount++;
+		processTlvTable(tlvDataStream);
+		break;
+	}
+	case TlvPacketType::NullPacket:
+	{
+		statistics.tlvNullPacketCount++;
+		break;
+	}
+	default:
+	{
+		statistics.tlvUndefinedCount++;
+	}
+	}
+
+	return DemuxStatus::Ok;
+}
+
+template<typename Handler>
+void MmtTlvDemuxer<Handler>::processMpu(Common::ReadStream& stream)
+{
+	if (!mpu.unpack(stream)) {
+		return;
+	}
+
+	auto& assembler = getAssembler(mmt.packetId);
+	Common::ReadStream nstream(mpu.payload);
+	const std::shared_ptr<MmtStream>& mmtStream = getStream(mmt.packetId);
+
+	if (!mmtStream) {
+		return;
+	}
+
+	if (mpu.aggregateFlag && mpu.fragmentationIndicator != FragmentationIndicator::NotFragmented) {
+		return;
+	}
+
+	if (mpu.fragmentType != FragmentType::Mfu) {
+		return;
+	}
+
+	if (assembler.state == FragmentAssembler::State::Init) {
+		mmtStream->lastMpuSequenceNumber = mpu.mpuSequenceNumber;
+	}
+	else if (mpu.mpuSequenceNumber == mmtStream->lastMpuSequenceNumber + 1) {
+		mmtStream->lastMpuSequenceNumber = mpu.mpuSequenceNumber;
+		mmtStream->auIndex = 0;
+	}
+	else if (mpu.mpuSequenceNumber != mmtStream->lastMpuSequenceNumber) {
+		assembler.state = FragmentAssembler::State::Init;
+		return;
+	}
+
+	assembler.checkState(mmt.packetSequenceNumber);
+
+	mmtStream->rapFlag = mmt.rapFlag;
+
+
+	if (mpu.aggregateFlag == 0) {
+		DataUnit dataUnit;
+		if (!dataUnit.unpack(nstream, mpu.timedFlag, mpu.aggregateFlag)) {
+			return;
+		}
+
+		if (assembler.assemble(dataUnit.data, mpu.fragmentationIndicator, mmt.packetSequenceNumber)) {
+			processMfuData(assembler.data);
+			assembler.clear();
+		}
+	}
+	else
+	{
+		while (!nstream.isEof()) {
+			DataUnit dataUnit;
+			if (!dataUnit.unpack(nstream, mpu.timedFlag, mpu.aggregateFlag)) {
+				return;
+			}
+
+			if (assembler.assemble(dataUnit.data, mpu.fragmentationIndicator, mmt.packetSequenceNumber)) {
+				processMfuData(assembler.data);
+				assembler.clear();
+			}
+		}
+	}
+}
+
+template<typename Handler>
+void MmtTlvDemuxer<Handler>::processMfuData(const std::vector<uint8_t>& data)
+{
+	const std::shared_ptr<MmtStream>& mmtStream = getStream(mmt.packetId);
+	if (!mmtStream) {
+		return;
+	}
+
+	if (!mmtStream->mfuDataProcessor) {
+		return;
+	}
+
+	auto ret = mmtStream->mfuDataProcessor->process(mmtStream, data);
+	if (!ret.has_value()) {
+		return;
+	}
+
+	auto& mfuData = ret.value();
+	mmtStream->frameBufferPool.addAccessUnitSize(mfuData.data.size());
+
+	// Keep the access units in order behind the ones still waiting for their timestamps.
+	if (mfuData.pendingTimestamp || !mmtStream->pendingAccessUnits.empty()) {
+		if (mmtStream->pendingAccessUnits.size() >= MmtStream::kMaxPendingAccessUnits) {
+			mmtStream->frameBufferPool.release(std::move(mmtStream->pendingAccessUnits.front().data));
+			mmtStream->pendingAccessUnits.pop_front();
+		}
+
+		mmtStream->pendingAccessUnits.push_back(std::move(mfuData));
+		flushPendingAccessUnits(mmtStream);
+		return;
+	}
+
+	deliverMfuData(mmtStream, mfuData);
+}
+
+template<typename Handler>
+void MmtTlvDemuxer<Handler>::flushPendingAccessUnits(const std::shared_ptr<MmtStream>& mmtStream)
+{
+	auto& pendingAccessUnits = mmtStream->pendingAccessUnits;
+	while (!pendingAccessUnits.empty()) {
+		MfuData& mfuData = pendingAccessUnits.front();
+
+		if (mfuData.pendingTimestamp) {
+			int64_t pts, dts;
+			auto status = mmtStream->getPtsDts(mfuData.mpuSequenceNumber, mfuData.auIndex, pts, dts);
+			if (status == MmtStream::TimestampStatus::NotFound &&
+				mfuData.mpuSequenceNumber >= mmtStream->oldestDescribedMpuSequenceNumber) {
+				break;
+			}
+
+			if (status != MmtStream::TimestampStatus::Ok) {
+				mmtStream->frameBufferPool.release(std::move(mfuData.data));
+				pendingAccessUnits.pop_front();
+				continue;
+			}
+
+			mfuData.pts = pts;
+			mfuData.dts = dts;
+			mfuData.pendingTimestamp = false;
+		}
+
+		deliverMfuData(mmtStream, mfuData);
+		pendingAccessUnits.pop_front();
+	}
+}
+
+template<typename Handler>
+void MmtTlvDemuxer<Handler>::deliverMfuData(const std::shared_ptr<MmtStream>& mmtStream, MfuData& mfuData)
+{
+	if (demuxerHandler) {
+		switch (mmtStream->assetType) {
+		case AssetType::hev1:
+			demuxerHandler->onVideoData(mmtStream, std::move(mfuData));
+			break;
+		case AssetType::mp4a:
+			demuxerHandler->onAudioData(mmtStream, std::move(mfuData));
+			break;
+		case AssetType::stpp:
+			demuxerHandler->onSubtitleData(mmtStream, std::move(mfuData));
+			break;
+		case AssetType::aapp:
+			demuxerHandler->onApplicationData(mmtStream, std::move(mfuData));
+			break;
+		}
+	}
+
+	mmtStream->frameBufferPool.release(std::move(mfuData.data));
+}
+
+template<typename Handler>
+void MmtTlvDemuxer<Handler>::processSignalingMessages(Common::ReadStream& stream)
+{
+	SignalingMessage signalingMessage;
+	if (!signalingMessage.unpack(stream)) {
+		return;
+	}
+
+	auto& assembler = getAssembler(mmt.packetId);
+	assembler.checkState(mmt.packetSequenceNumber);
+
+	if (!signalingMessage.aggregationFlag) {
+		if (assembler.assemble(signalingMessage.payload, signalingMessage.fragmentationIndicator, mmt.packetSequenceNumber)) {
+			Common::ReadStream messageStream(assembler.data);
+			processSignalingMessage(messageStream);
+			assembler.clear();
+		}
+	}
+	else {
+		if (signalingMessage.fragmentationIndicator != FragmentationIndicator::NotFragmented) {
+			return;
+		}
+
+		Common::ReadStream nstream(signalingMessage.payload);
+		while (nstream.isEof()) {
+			uint32_t length;
+			if (signalingMessage.lengthExtensionFlag)
+				length = nstream.getBe32U();
+			else
+				length = nstream.getBe16U();
+
+			std::vector<uint8_t> message;
+			message.resize(length);
+			stream.read(message.data(), length);
+
+			if (assembler.assemble(message, signalingMessage.fragmentationIndicator, mmt.packetSequenceNumber)) {
+				Common::ReadStream messageStream(assembler.data);
+				processSignalingMessage(messageStream);
+				assembler.clear();
+			}
+		}
+	}
+}
+
+template<typename Handler>
+void MmtTlvDemuxer<Handler>::processSignalingMessage(Common::ReadStream& stream)
+{
+	MmtMessageId id = static_cast<MmtMessageId>(stream.peekBe16U());
+
+	switch (id) {
+	case MmtMessageId::PaMessage:
+		return processPaMessage(stream);
+	case MmtMessageId::M2SectionMessage:
+		return processMessage<M2SectionMessage>(stream);
+	case MmtMessageId::CaMessage:
+		return processMessage<CaMessage>(stream);
+	case MmtMessageId::M2ShortSectionMessage:
+		return processMessage<M2ShortSectionMessage>(stream);
+	case MmtMessageId::DataTransmissionMessage:
+		return processMessage<DataTransmissionMessage>(stream);
+	}
+}
+
+// Messages carrying a single table
+template<typename Handler>
+template<typename Message>
+void MmtTlvDemuxer<Handler>::processMessage(Common::ReadStream& stream)
+{
+	Message message;
+	if (!message.unpack(stream)) {
+		return;
+	}
+
+	processMmtTable(stream);
+}
+
+template<typename Handler>
+void MmtTlvDemuxer<Handler>::processPaMessage(Common::ReadStream& stream)
+{
+	PaMessage message;
+	if (!message.unpack(stream)) {
+		return;
+	}
+
+	Common::ReadStream nstream(message.table);
+	while (!nstream.isEof()) {
+		processMmtTable(nstream);
+	}
+}
+
+template<typename Handler>
+void MmtTlvDemuxer<Handler>::processTlvTable(Common::ReadStream& stream)
+{
+	const auto table = unpackTlvTable(stream);
+	if (!table || !demuxerHandler) {
+		return;
+	}
+
+	switch (table->getTableId()) {
+	case TlvTableId::Nit:
+		demuxerHandler->onNit(std::static_pointer_cast<Nit>(table));
+		break;
+	}
+}
+
+template<typename Handler>
+void MmtTlvDemuxer<Handler>::processMmtTable(Common::ReadStream& stream)
+{
+	const auto table = unpackMmtTable(stream);
+	if (!table) {
+		return;
+	}
+
+	// Timestamps from the MPT may complete access units waiting for them
+	if (table->getTableId() == MmtTableId::Mpt) {
+		for (const auto& mmtStream : streamsByIndex) {
+			flushPendingAccessUnits(mmtStream);
+		}
+	}
+
+	dispatchMmtTable(table->getTableId(), table);
+}
+
+template<typename Handler>
+void MmtTlvDemuxer<Handler>::dispatchMmtTable(uint8_t tableId, const std::shared_ptr<MmtTableBase>& table)
+{
+	// MmtTableFactory picked the class from the same table id, so the casts need no RTTI
+	if (demuxerHandler) {
+		switch (tableId) {
+		case MmtTableId::Ecm_0:
+			demuxerHandler->onEcm(std::static_pointer_cast<Ecm>(table));
+			break;
+		case MmtTableId::MhCdt:
+			demuxerHandler->onMhCdt(std::static_pointer_cast<MhCdt>(table));
+			break;
+		case MmtTableId::MhEitPf:
+		case MmtTableId::MhEitS_0:
+		case MmtTableId::MhEitS_1:
+		case MmtTableId::MhEitS_2:
+		case MmtTableId::MhEitS_3:
+		case MmtTableId::MhEitS_4:
+		case MmtTableId::MhEitS_5:
+		case MmtTableId::MhEitS_6:
+		case MmtTableId::MhEitS_7:
+		case MmtTableId::MhEitS_8:
+		case MmtTableId::MhEitS_9:
+		case MmtTableId::MhEitS_10:
+		case MmtTableId::MhEitS_11:
+		case MmtTableId::MhEitS_12:
+		case MmtTableId::MhEitS_13:
+		case MmtTableId::MhEitS_14:
+		case MmtTableId::MhEitS_15:
+			demuxerHandler->onMhEit(std::static_pointer_cast<MhEit>(table));
+			break;
+		case MmtTableId::MhSdtActual:
+			demuxerHandler->onMhSdtActual(std::static_pointer_cast<MhSdt>(table));
+			break;
+		case MmtTableId::MhTot:
+			demuxerHandler->onMhTot(std::static_pointer_cast<MhTot>(table));
+			break;
+		case MmtTableId::Mpt:
+			demuxerHandler->onMpt(std::static_pointer_cast<Mpt>(table));
+			break;
+		case MmtTableId::Plt:
+			demuxerHandler->onPlt(std::static_pointer_cast<Plt>(table));
+			break;
+		case MmtTableId::MhBit:
+			demuxerHandler->onMhBit(std::static_pointer_cast<MhBit>(table));
+			break;
+		case MmtTableId::MhAit:
+			demuxerHandler->onMhAit(std::static_pointer_cast<MhAit>(table));
+			break;
+		}
+	}
+}
+
+}
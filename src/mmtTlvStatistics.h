@@ -1,37 +1,76 @@
 #pragma once
 #include <iomanip>
 #include <sstream>
+#include <algorithm>
+#include <vector>
+#include <array>
+#include <atomic>
+#include "mmtTableBase.h"
 
 namespace MmtTlv {
 
 class mmtTlvStatistics {
 public:
-	uint64_t tlvPacketCount{0};
-	uint64_t tlvIpv4PacketCount{0};
-	uint64_t tlvIpv6PacketCount{0};
-	uint64_t tlvHeaderCompressedIpPacketCount{0};
-	uint64_t tlvTransmissionControlSignalPacketCount{0};
-	uint64_t tlvNullPacketCount{0};
-	uint64_t tlvUndefinedCount{0};
+	// Counter that is written by the demuxer thread only and may be read from any other thread.
+	// Single writer, so an increment is a relaxed load and store without a locked read-modify-write.
+	template <typename T>
+	class RelaxedCounter {
+	public:
+		RelaxedCounter() = default;
+		RelaxedCounter(const RelaxedCounter&) = delete;
+		RelaxedCounter& operator=(const RelaxedCounter&) = delete;
+
+		T load() const { return value.load(std::memory_order_relaxed); }
+		operator T() const { return load(); }
+		RelaxedCounter& operator=(T newValue) { value.store(newValue, std::memory_order_relaxed); return *this; }
+		void operator++(int) { value.store(load() + 1, std::memory_order_relaxed); }
+
+	private:
+		std::atomic<T> value{};
+	};
+
+	RelaxedCounter<uint64_t> tlvPacketCount;
+	RelaxedCounter<uint64_t> tlvIpv4PacketCount;
+	RelaxedCounter<uint64_t> tlvIpv6PacketCount;
+	RelaxedCounter<uint64_t> tlvHeaderCompressedIpPacketCount;
+	RelaxedCounter<uint64_t> tlvTransmissionControlSignalPacketCount;
+	RelaxedCounter<uint64_t> tlvNullPacketCount;
+	RelaxedCounter<uint64_t> tlvUndefinedCount;
+	// MMT-SI sections recognized as unchanged repetitions and not unpacked again
+	RelaxedCounter<uint64_t> skippedSectionCount;
+	// MMT-SI and TLV-SI sections dropped for a CRC_32 mismatch
+	RelaxedCounter<uint64_t> crcErrorSectionCount;
+	RelaxedCounter<uint64_t> tlvCrcErrorSectionCount;
 
 	class MmtStat {
 	public:
-		MmtStat(uint16_t packetId) : packetId(packetId) {}
-		uint16_t packetId{0};
-		std::string name;
-		uint32_t lastPacketSequenceNumber{0};
-		uint32_t assetType{0};
-		uint64_t count{0};
-		uint64_t drop{0};
-		uint8_t videoResolution{0};
-		uint8_t videoAspectRatio{0};
-		uint8_t audioComponentType{0};
-		uint8_t audioSamplingRate{0};
-
-		void setName(const std::string& name) {
-			this->name = name;
+		static constexpr uint32_t kEmpty = 0xFFFFFFFF;
+		static constexpr int16_t kNoTableId = -1;
+
+		// Published last, with release semantics, once the slot has been reset for the packet ID.
+		std::atomic<uint32_t> packetId{kEmpty};
+		RelaxedCounter<uint32_t> lastPacketSequenceNumber;
+		RelaxedCounter<uint32_t> assetType;
+		RelaxedCounter<int16_t> tableId;
+		RelaxedCounter<uint64_t> count;
+		RelaxedCounter<uint64_t> drop;
+		RelaxedCounter<uint8_t> videoResolution;
+		RelaxedCounter<uint8_t> videoAspectRatio;
+		RelaxedCounter<uint8_t> audioComponentType;
+		RelaxedCounter<uint8_t> audioSamplingRate;
+
+		void reset() {
+			lastPacketSequenceNumber = 0;
+			assetType = 0;
+			tableId = kNoTableId;
+			count = 0;
+			drop = 0;
+			videoResolution = 0;
+			videoAspectRatio = 0;
+			audioComponentType = 0;
+			audioSamplingRate = 0;
 		}
-		
+
 		std::string getName() const {
 			if (assetType != 0) {
 				switch (assetType) {
@@ -47,8 +86,77 @@ public:
 					return "Unknown";
 				}
 			}
+			else if (tableId != kNoTableId) {
+				return getTableName(static_cast<uint8_t>(tableId.load()));
+			}
 			else {
-				return name;
+				return "";
+			}
+		}
+
+		static std::string getTableName(uint8_t tableId) {
+			switch (tableId) {
+			case MmtTableId::Pat:
+				return "PAT";
+			case MmtTableId::Ecm_0:
+			case MmtTableId::Ecm_1:
+				return "ECM";
+			case MmtTableId::MhCdt:
+				return "MH-CDT";
+			case MmtTableId::MhEitPf:
+			case MmtTableId::MhEitS_0:
+			case MmtTableId::MhEitS_1:
+			case MmtTableId::MhEitS_2:
+			case MmtTableId::MhEitS_3:
+			case MmtTableId::MhEitS_4:
+			case MmtTableId::MhEitS_5:
+			case MmtTableId::MhEitS_6:
+			case MmtTableId::MhEitS_7:
+			case MmtTableId::MhEitS_8:
+			case MmtTableId::MhEitS_9:
+			case MmtTableId::MhEitS_10:
+			case MmtTableId::MhEitS_11:
+			case MmtTableId::MhEitS_12:
+			case MmtTableId::MhEitS_13:
+			case MmtTableId::MhEitS_14:
+			case MmtTableId::MhEitS_15:
+				return "MH-EIT";
+			case MmtTableId::MhSdtActual:
+			case MmtTableId::MhSdtOther:
+				return "MH-SDT";
+			case MmtTableId::MhTot:
+				return "MH-TOT";
+			case MmtTableId::Mpt:
+				return "MPT";
+			case MmtTableId::Plt:
+				return "PLT";
+			case MmtTableId::MhBit:
+				return "MH-BIT";
+			case MmtTableId::Lct:
+				return "LCT";
+			case MmtTableId::Emm_0:
+			case MmtTableId::Emm_1:
+				return "EMM";
+			case MmtTableId::Cat:
+				return "CAT";
+			case MmtTableId::Dcm:
+				return "DCM";
+			case MmtTableId::Dmm:
+				return "DMM";
+			case MmtTableId::MhSdtt:
+				return "MH-SDTT";
+			case MmtTableId::MhAit:
+				return "MH-AIT";
+			case MmtTableId::Ddmt:
+				return "DDMT";
+			case MmtTableId::Damt:
+				return "DAMT";
+			case MmtTableId::Dcct:
+				return "DCCT";
+			case MmtTableId::Emt:
+				return "EMT";
+			default:
+				return "";
 			}
 		}
 
@@ -149,11 +257,11 @@ public:
 			std::string output;
 			std::ostringstream oss;
 
-			oss << "0x" << std::setw(4) << std::setfill('0') << std::hex << std::uppercase << packetId;
+			oss << "0x" << std::setw(4) << std::setfill('0') << std::hex << std::uppercase << packetId.load(std::memory_order_relaxed);
 
 			output = " - PacketId: " + oss.str() + ", ";
-			output += "Drop: " + std::to_string(drop) + ", ";
-			output += "Count: " + std::to_string(count);
+			output += "Drop: " + std::to_string(drop.load()) + ", ";
+			output += "Count: " + std::to_string(count.load());
 
 			std::string name = getName();
 			if(name != "") {
@@ -173,36 +281,79 @@ public:
 		}
 	};
 
-	std::map<uint16_t, std::shared_ptr<MmtStat>> mapMmtStat;
-	std::shared_ptr<MmtStat> getMmtStat(uint16_t packetId) {
-		if (mapMmtStat.find(packetId) == mapMmtStat.end()) {
-			auto mmtStat = std::make_shared<MmtStat>(packetId);
-			mapMmtStat[packetId] = mmtStat;
-			return mmtStat;
-		}
-		else {
-			return mapMmtStat[packetId];
+	// Open-addressed slots keyed by packet ID. Only the demuxer thread claims slots,
+	// so readers can walk them at any time without locking.
+	MmtStat& getMmtStat(uint16_t packetId) {
+		size_t i = (packetId * 0x9E3779B1u) >> (32 - kMmtStatSlotBits);
+		for (size_t probe = 0; probe < kMmtStatSlotCount; ++probe) {
+			MmtStat& slot = mmtStats[i];
+			uint32_t slotPacketId = slot.packetId.load(std::memory_order_relaxed);
+			if (slotPacketId == packetId) {
+				return slot;
+			}
+			if (slotPacketId == MmtStat::kEmpty) {
+				slot.reset();
+				slot.packetId.store(packetId, std::memory_order_release);
+				return slot;
+			}
+			i = (i + 1) & (kMmtStatSlotCount - 1);
 		}
+
+		// All slots are taken; count the remaining packet IDs together.
+		return overflowMmtStat;
+	}
+
+	// The overflow slot mixes the packets of several packet IDs, so it only counts them:
+	// their packet sequence numbers do not follow one another and cannot tell drops.
+	bool isOverflowMmtStat(const MmtStat& mmtStat) const {
+		return &mmtStat == &overflowMmtStat;
 	}
 
 	void clear() {
-		mapMmtStat.clear();
+		for (auto& slot : mmtStats) {
+			slot.packetId.store(MmtStat::kEmpty, std::memory_order_relaxed);
+		}
+		overflowMmtStat.reset();
 	}
 
 	void print() const {
 		std::cerr << "TLV Packet" << std::endl;
-		std::cerr << " - IPv4Packet: " << std::to_string(tlvIpv4PacketCount) << std::endl;
-		std::cerr << " - IPv6Packet: " << std::to_string(tlvIpv6PacketCount) << std::endl;
-		std::cerr << " - HeaderCompressedIpPacket: " << std::to_string(tlvHeaderCompressedIpPacketCount) << std::endl;
-		std::cerr << " - TransmissionControlSignalPacket: " << std::to_string(tlvTransmissionControlSignalPacketCount) << std::endl;
-		std::cerr << " - NullPacket: " << std::to_string(tlvNullPacketCount) << std::endl;
-		std::cerr << " - Undefined: " << std::to_string(tlvUndefinedCount) << std::endl;
+		std::cerr << " - IPv4Packet: " << std::to_string(tlvIpv4PacketCount.load()) << std::endl;
+		std::cerr << " - IPv6Packet: " << std::to_string(tlvIpv6PacketCount.load()) << std::endl;
+		std::cerr << " - HeaderCompressedIpPacket: " << std::to_string(tlvHeaderCompressedIpPacketCount.load()) << std::endl;
+		std::cerr << " - TransmissionControlSignalPacket: " << std::to_string(tlvTransmissionControlSignalPacketCount.load()) << std::endl;
+		std::cerr << " - NullPacket: " << std::to_string(tlvNullPacketCount.load()) << std::endl;
+		std::cerr << " - Undefined: " << std::to_string(tlvUndefinedCount.load()) << std::endl;
+		std::cerr << " - TLV-SI CRC Error: " << std::to_string(tlvCrcErrorSectionCount.load()) << std::endl;
+		std::cerr << "MMT-SI Section" << std::endl;
+		std::cerr << " - Skipped: " << std::to_string(skippedSectionCount.load()) << std::endl;
+		std::cerr << " - CRC Error: " << std::to_string(crcErrorSectionCount.load()) << std::endl;
 		std::cerr << "MMT:" << std::endl;
 
-		for (const auto& mmtStat : mapMmtStat) {
-			mmtStat.second->print();
+		std::vector<const MmtStat*> sortedMmtStats;
+		for (const auto& slot : mmtStats) {
+			if (slot.packetId.load(std::memory_order_acquire) != MmtStat::kEmpty) {
+				sortedMmtStats.push_back(&slot);
+			}
+		}
+		std::sort(sortedMmtStats.begin(), sortedMmtStats.end(),
+			[](const MmtStat* lhs, const MmtStat* rhs) { return lhs->packetId.load() < rhs->packetId.load(); });
+
+		for (const auto& mmtStat : sortedMmtStats) {
+			mmtStat->print();
+		}
+
+		if (overflowMmtStat.count != 0) {
+			std::cerr << " - Packet ID overflow, Count: " << std::to_string(overflowMmtStat.count.load()) << std::endl;
 		}
 	}
+
+private:
+	static constexpr size_t kMmtStatSlotBits = 8;
+	static constexpr size_t kMmtStatSlotCount = 1 << kMmtStatSlotBits;
+
+	std::array<MmtStat, kMmtStatSlotCount> mmtStats;
+	MmtStat overflowMmtStat;
 };
 
 }
\ No newline at end of file
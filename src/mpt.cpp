@@ -1,10 +1,12 @@
 #include "mpt.h"
+#include <memory>
 
 namespace MmtTlv {
 
-bool Mpt::unpack(Common::ReadStream& stream)
+bool Mpt::unpack(Common::ReadStream& input)
 {
 	try {
+		Common::ReadStream stream = keepSection(input, peekTableSize(input));
 		if (!MmtTableBase::unpack(stream)) {
 			return false;
 		}
@@ -20,8 +22,7 @@ bool Mpt::unpack(Common::ReadStream& stream)
 			return false;
 		}
 
-		mmtPackageIdByte.resize(mmtPackageIdLength);
-		stream.read(mmtPackageIdByte.data(), mmtPackageIdLength);
+		mmtPackageIdByte = stream.getSpan(mmtPackageIdLength);
 
 		mptDescriptorsLength = stream.getBe16U();
 		
@@ -32,12 +33,12 @@ bool Mpt::unpack(Common::ReadStream& stream)
 		stream.skip(mptDescriptorsLength);
 
 		numberOfAssets = stream.get8U();
+		assets.reserve(numberOfAssets);
 		for (int i = 0; i < numberOfAssets; i++) {
-			Asset asset;
-			if (!asset.unpack(stream)) {
+			Asset& asset = assets.emplace_back();
+			if (!asset.unpack(stream, arena)) {
 				return false;
 			}
-			assets.push_back(asset);
 		}
 	}
 	catch (const std::out_of_range&) {
@@ -47,28 +48,28 @@ bool Mpt::unpack(Common::ReadStream& stream)
 	return true;
 }
 
-bool Mpt::Asset::unpack(Common::ReadStream& stream)
+bool Mpt::Asset::unpack(Common::ReadStream& stream, Common::Arena& arena)
 {
 	try {
 		identifierType = stream.get8U();
 		assetIdScheme = stream.getBe32U();
 		assetIdLength = stream.get8U();
 
-		assetIdByte.resize(assetIdLength);
-		stream.read(assetIdByte.data(), assetIdLength);
+		assetIdByte = stream.getSpan(assetIdLength);
 
 		assetType = stream.getBe32U();
 		uint8_t uint8 = stream.get8U();
 		reserved = (uint8 & 0b11111110) >> 2;
 		assetClockRelationFlag = (uint8 & 0x00000001);
 		locationCount = stream.get8U();
+		MmtGeneralLocationInfo* locationInfo = arena.allocate<MmtGeneralLocationInfo>(locationCount);
+		std::uninitialized_default_construct_n(locationInfo, locationCount);
 		for (int i = 0; i < locationCount; i++) {
-			MmtGeneralLocationInfo locationInfo;
-			if (!locationInfo.unpack(stream)) {
+			if (!locationInfo[i].unpack(stream)) {
 				return false;
 			}
-			locationInfos.push_back(locationInfo);
 		}
+		locationInfos = { locationInfo, locationCount };
 
 		assetDescriptorsLength = stream.getBe16U();
 
@@ -1,4 +1,7 @@
 #pragma once
+#include <memory_resource>
+#include <span>
+#include <vector>
 #include "mmtTableBase.h"
 #include "mmtGeneralLocationInfo.h"
 #include "mmtDescriptors.h"
@@ -12,17 +15,17 @@ public:
 
 	class Asset {
 	public:
-		bool unpack(Common::ReadStream& stream);
+		bool unpack(Common::ReadStream& stream, Common::Arena& arena);
 
 		uint8_t identifierType;
 		uint32_t assetIdScheme;
 		uint8_t assetIdLength;
-		std::vector<uint8_t> assetIdByte;
+		std::span<const uint8_t> assetIdByte;
 		uint32_t assetType;
 		uint8_t reserved;
 		bool assetClockRelationFlag;
 		uint8_t locationCount;
-		std::vector<MmtGeneralLocationInfo> locationInfos;
+		std::span<const MmtGeneralLocationInfo> locationInfos;
 
 		uint16_t assetDescriptorsLength;
 		MmtDescriptors descriptors;
@@ -33,12 +36,12 @@ public:
 	uint8_t reserved;
 	uint8_t mptMode;
 	uint8_t mmtPackageIdLength;
-	std::vector<uint8_t> mmtPackageIdByte;
+	std::span<const uint8_t> mmtPackageIdByte;
 	uint16_t mptDescriptorsLength;
 	MmtDescriptors descriptors;
 
 	uint8_t numberOfAssets;
-	std::list<Asset> assets;
+	std::pmr::vector<Asset> assets{ arena.getResource() };
 };
 
 }
\ No newline at end of file
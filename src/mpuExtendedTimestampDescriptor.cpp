@@ -23,12 +23,10 @@ bool MpuExtendedTimestampDescriptor::unpack(Common::ReadStream& stream)
 
 		entries.reserve(15);
 		while (!stream.isEof()) {
-			Entry entry;
+			Entry& entry = entries.emplace_back();
 			if (!entry.unpack(stream, ptsOffsetType, defaultPtsOffset)) {
 				return false;
 			}
-
-			entries.push_back(entry);
 		}
 	}
 	catch (const std::out_of_range&) {
@@ -48,17 +46,9 @@ bool MpuExtendedTimestampDescriptor::Entry::unpack(Common::ReadStream& stream, u
 		mpuDecodingTimeOffset = stream.getBe16U();
 		numOfAu = stream.get8U();
 
-		dtsPtsOffsets.reserve(numOfAu);
-		ptsOffsets.reserve(numOfAu);
-		for (int i = 0; i < numOfAu; i++) {
-			dtsPtsOffsets.push_back(stream.getBe16U());
-			if (ptsOffsetType == 2) {
-				ptsOffsets.push_back(stream.getBe16U());
-			}
-			else {
-				ptsOffsets.push_back(defaultPtsOffset);
-			}
-		}
+		this->ptsOffsetType = ptsOffsetType;
+		this->defaultPtsOffset = defaultPtsOffset;
+		offsets = stream.getSpan(numOfAu * getOffsetsStride());
 	}
 	catch (const std::out_of_range&) {
 		return false;
@@ -1,11 +1,16 @@
 #pragma once
 #include "mmtDescriptorBase.h"
+#include <memory_resource>
+#include <span>
+#include <vector>
 
 namespace MmtTlv {
 
 class MpuExtendedTimestampDescriptor
 	: public MmtDescriptorTemplate<0x8026> {
 public:
+	explicit MpuExtendedTimestampDescriptor(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+		: entries(resource) {}
 	bool unpack(Common::ReadStream& stream) override;
 
 	class Entry {
@@ -17,8 +22,25 @@ public:
 		uint8_t reserved;
 		uint16_t mpuDecodingTimeOffset;
 		uint8_t numOfAu;
-		std::vector<uint16_t> dtsPtsOffsets;
-		std::vector<uint16_t> ptsOffsets;
+
+		// dts_pts_offset of the access unit i
+		uint16_t getDtsPtsOffset(size_t i) const {
+			return readOffset(i * getOffsetsStride());
+		}
+
+		// pts_offset of the access unit i, or the default one when they are not listed
+		uint16_t getPtsOffset(size_t i) const {
+			return ptsOffsetType == 2 ? readOffset(i * getOffsetsStride() + 2) : defaultPtsOffset;
+		}
+
+	private:
+		size_t getOffsetsStride() const { return ptsOffsetType == 2 ? 4 : 2; }
+		uint16_t readOffset(size_t position) const { return offsets[position] << 8 | offsets[position + 1]; }
+
+		// The offsets of all access units, read as they are in the section
+		std::span<const uint8_t> offsets;
+		uint8_t ptsOffsetType;
+		uint16_t defaultPtsOffset;
 	};
 
 	uint8_t reserved;
@@ -28,7 +50,7 @@ public:
 	uint32_t timescale;
 	uint16_t defaultPtsOffset;
 
-	std::vector<Entry> entries;
+	std::pmr::vector<Entry> entries;
 };
 
 }
\ No newline at end of file
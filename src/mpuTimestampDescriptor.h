@@ -1,11 +1,15 @@
 #pragma once
 #include "mmtDescriptorBase.h"
+#include <memory_resource>
+#include <vector>
 
 namespace MmtTlv {
 
 class MpuTimestampDescriptor
 	: public MmtDescriptorTemplate<0x0001> {
 public:
+	explicit MpuTimestampDescriptor(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+		: entries(resource) {}
 	bool unpack(Common::ReadStream& stream) override;
 
 	class Entry {
@@ -14,7 +18,7 @@ public:
 		uint64_t mpuPresentationTime;
 	};
 
-	std::vector<Entry> entries;
+	std::pmr::vector<Entry> entries;
 };
 
 }
\ No newline at end of file
@@ -19,8 +19,7 @@ bool MultimediaServiceInformationDescriptor::unpack(Common::ReadStream& stream)
 			language[3] = '\0';
 
 			textLength = nstream.get8U();
-			text.resize(textLength);
-			nstream.read(text.data(), textLength);
+			text = nstream.getStringView(textLength);
 		}
 		
 		if (dataComponentId == 0x0021) {
@@ -30,8 +29,7 @@ bool MultimediaServiceInformationDescriptor::unpack(Common::ReadStream& stream)
 		}
 		
 		selectorLength = nstream.get8U();
-		selectorByte.resize(selectorLength);
-		nstream.read(selectorByte.data(), selectorLength);
+		selectorByte = nstream.getSpan(selectorLength);
 
         stream.skip(descriptorLength);
 	}
@@ -1,5 +1,7 @@
 #pragma once
 #include "mmtDescriptorBase.h"
+#include <span>
+#include <string_view>
 
 namespace MmtTlv {
 
@@ -13,13 +15,13 @@ public:
 	uint16_t componentTag;
 	char language[4];
 	uint8_t textLength;
-	std::string text;
+	std::string_view text;
 
 	uint8_t associatedContentsFlag;
 	uint8_t reserved;
 
 	uint8_t selectorLength;
-	std::vector<uint8_t> selectorByte;
+	std::span<const uint8_t> selectorByte;
 
 };
 
@@ -10,8 +10,7 @@ bool NetworkNameDescriptor::unpack(Common::ReadStream& stream)
         }
 
         size_t size = stream.leftBytes();
-        networkName.resize(size);
-        stream.read(networkName.data(), size);
+        networkName = stream.getStringView(size);
 	}
 	catch (const std::out_of_range&) {
 		return false;
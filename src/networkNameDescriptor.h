@@ -1,12 +1,13 @@
 #pragma once
 #include "tlvDescriptorBase.h"
+#include <string_view>
 
 namespace MmtTlv {
 
 class NetworkNameDescriptor : public TlvDescriptorTemplate<0x40> {
 public:
     bool unpack(Common::ReadStream& stream);
-    std::string networkName;
+    std::string_view networkName;
 };
 
 }
\ No newline at end of file
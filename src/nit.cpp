@@ -2,9 +2,10 @@
 
 namespace MmtTlv {
 
-bool Nit::unpack(Common::ReadStream& stream)
+bool Nit::unpack(Common::ReadStream& input)
 {
     try {
+        Common::ReadStream stream = keepSection(input, peekSectionSize(input));
         if (!TlvTableBase::unpack(stream)) {
             return false;
         }
@@ -37,13 +38,18 @@ bool Nit::unpack(Common::ReadStream& stream)
 
         Common::ReadStream nstream(stream, tlvStreamLoopLength);
         while (!nstream.isEof()) {
-            Entry entry;
+            Entry& entry = entries.emplace_back();
             if (!entry.unpack(nstream)) {
                 return false;
             }
-            entries.push_back(entry);
         }
         stream.skip(tlvStreamLoopLength);
+
+        if (stream.leftBytes() < 4) {
+            return false;
+        }
+
+        crc32 = stream.getBe32U();
 	}
 	catch (const std::out_of_range&) {
 		return false;
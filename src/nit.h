@@ -1,5 +1,6 @@
 #pragma once
-#include <list>
+#include <memory_resource>
+#include <vector>
 #include "tlvTableBase.h"
 #include "tlvDescriptors.h"
 #include "stream.h"
@@ -34,7 +35,8 @@ public:
     TlvDescriptors descriptors;
 
     uint16_t tlvStreamLoopLength;
-    std::list<Entry> entries;
+    std::pmr::vector<Entry> entries{ arena.getResource() };
+    uint32_t crc32;
 
 };
 
@@ -0,0 +1,93 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace MmtTlv {
+
+// Table keyed by a 16-bit packet ID. A direct index over the whole packet ID space points
+// into a dense entry vector, so a lookup is two array accesses and iteration only visits used entries.
+// Inserting or erasing entries may move other entries; do not keep references across those calls.
+template <typename T>
+class PacketIdTable {
+public:
+	using Entry = std::pair<uint16_t, T>;
+
+	PacketIdTable() : index(kPacketIdCount, kEmpty) {}
+
+	T* find(uint16_t packetId) {
+		uint32_t i = index[packetId];
+		return i == kEmpty ? nullptr : &entries[i - 1].second;
+	}
+
+	const T* find(uint16_t packetId) const {
+		uint32_t i = index[packetId];
+		return i == kEmpty ? nullptr : &entries[i - 1].second;
+	}
+
+	template <typename... Args>
+	T& tryEmplace(uint16_t packetId, Args&&... args) {
+		uint32_t i = index[packetId];
+		if (i != kEmpty) {
+			return entries[i - 1].second;
+		}
+
+		index[packetId] = static_cast<uint32_t>(entries.size() + 1);
+		entries.emplace_back(std::piecewise_construct, std::forward_as_tuple(packetId), std::forward_as_tuple(std::forward<Args>(args)...));
+		return entries.back().second;
+	}
+
+	void erase(uint16_t packetId) {
+		uint32_t i = index[packetId];
+		if (i == kEmpty) {
+			return;
+		}
+
+		// Move the last entry into the hole to keep the entries dense.
+		if (i != entries.size()) {
+			entries[i - 1] = std::move(entries.back());
+			index[entries[i - 1].first] = i;
+		}
+		entries.pop_back();
+		index[packetId] = kEmpty;
+	}
+
+	template <typename Predicate>
+	void eraseIf(Predicate predicate) {
+		for (size_t i = 0; i < entries.size(); ) {
+			if (predicate(entries[i])) {
+				erase(entries[i].first);
+			}
+			else {
+				++i;
+			}
+		}
+	}
+
+	void clear() {
+		for (const auto& entry : entries) {
+			index[entry.first] = kEmpty;
+		}
+		entries.clear();
+	}
+
+	size_t size() const { return entries.size(); }
+	bool empty() const { return entries.empty(); }
+
+	typename std::vector<Entry>::iterator begin() { return entries.begin(); }
+	typename std::vector<Entry>::iterator end() { return entries.end(); }
+	typename std::vector<Entry>::const_iterator begin() const { return entries.begin(); }
+	typename std::vector<Entry>::const_iterator end() const { return entries.end(); }
+
+private:
+	static constexpr size_t kPacketIdCount = 0x10000;
+	// The index holds entry positions plus one, so that all 0x10000 positions fit beside the empty mark.
+	static constexpr uint32_t kEmpty = 0;
+
+	std::vector<uint32_t> index;
+	std::vector<Entry> entries;
+};
+
+}
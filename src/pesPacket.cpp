@@ -1,20 +1,21 @@
 #include "pesPacket.h"
-#include "stream.h"
+#include <cstring>
 
 namespace {
 
-	void writePts(MmtTlv::Common::WriteStream &stream, int fourbits, int64_t pts)
+	uint8_t* writePts(uint8_t* output, int fourbits, int64_t pts)
 	{
 		int val;
 
 		val  = fourbits << 4 | (((pts >> 30) & 0x07) << 1) | 1;
-		stream.put8U(val);
+		*output++ = static_cast<uint8_t>(val);
 		val  = (((pts >> 15) & 0x7fff) << 1) | 1;
-		stream.put8U(val >> 8);
-		stream.put8U(val);
+		*output++ = static_cast<uint8_t>(val >> 8);
+		*output++ = static_cast<uint8_t>(val);
 		val  = (((pts) & 0x7fff) << 1) | 1;
-		stream.put8U(val >> 8);
-		stream.put8U(val);
+		*output++ = static_cast<uint8_t>(val >> 8);
+		*output++ = static_cast<uint8_t>(val);
+		return output;
 	}
 
 }
@@ -25,11 +26,26 @@ bool PESPacket::pack(std::vector<uint8_t>& output)
 		return false;
 	}
 
-	MmtTlv::Common::WriteStream stream;
+	uint8_t header[kMaxHeaderSize];
+	size_t headerSize = packHeader(header, payload->size());
+
+	output.resize(headerSize + payload->size());
+	memcpy(output.data(), header, headerSize);
+	if (payload->size()) {
+		memcpy(output.data() + headerSize, payload->data(), payload->size());
+	}
+	return true;
+}
+
+size_t PESPacket::packHeader(uint8_t* output, size_t payloadSize) const
+{
+	uint8_t* p = output;
 
 	// packet_start_code_prefix
-	stream.write({0x00, 0x00, 0x01});
-	stream.put8U(streamId);
+	*p++ = 0x00;
+	*p++ = 0x00;
+	*p++ = 0x01;
+	*p++ = streamId;
 
 	uint8_t flags = 0;
 	uint8_t headerLength = 0;
@@ -38,31 +54,29 @@ bool PESPacket::pack(std::vector<uint8_t>& output)
 		headerLength += 5;
 		flags |= 0b10000000;
 	}
-	
+
 	if (dts != NOPTS_VALUE && pts != NOPTS_VALUE && dts != pts) {
 		headerLength += 5;
 		flags |= 0b01000000;
 	}
 
-	size_t length = payload->size() + headerLength + 3;
+	size_t length = payloadSize + headerLength + 3;
 	if (length > 0xffff) {
 		length = 0;
 	}
 
-	stream.putBe16U(static_cast<uint16_t>(length));
-	stream.put8U(2 << 6 /* reserved */ | dataAlignmentIndicator << 2);
-	stream.put8U(flags);
-	stream.put8U(headerLength);
+	*p++ = static_cast<uint8_t>(length >> 8);
+	*p++ = static_cast<uint8_t>(length);
+	*p++ = 2 << 6 /* reserved */ | dataAlignmentIndicator << 2;
+	*p++ = flags;
+	*p++ = headerLength;
 
 	if (pts != NOPTS_VALUE) {
-		writePts(stream, flags >> 6, pts);
+		p = writePts(p, flags >> 6, pts);
 	}
 	if (dts != NOPTS_VALUE && pts != NOPTS_VALUE && dts != pts) {
-		writePts(stream, 1, dts);
+		p = writePts(p, 1, dts);
 	}
 
-	stream.write(std::span<const uint8_t>{payload->data(), payload->size()});
-
-	output = stream.getData();
-	return true;
+	return p - output;
 }
\ No newline at end of file
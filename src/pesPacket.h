@@ -1,4 +1,5 @@
 #pragma once
+#include <cstddef>
 #include <cstdint>
 #include <vector>
 
@@ -40,7 +41,11 @@ constexpr uint8_t componentTagToStreamId(uint8_t tag) {
 
 class PESPacket {
 public:
+	// packet_start_code_prefix(3) + stream_id(1) + PES_packet_length(2) + flags(3) + PTS(5) + DTS(5)
+	static constexpr size_t kMaxHeaderSize = 19;
+
 	bool pack(std::vector<uint8_t>& output);
+	size_t packHeader(uint8_t* output, size_t payloadSize) const;
 	void setPts(uint64_t pts) { this->pts = pts; }
 	void setDts(uint64_t dts) { this->dts = dts; }
 	void setStreamId(uint8_t streamId) { this->streamId = streamId; };
@@ -49,6 +54,7 @@ public:
 	uint64_t getDts() const { return dts; }
 	uint8_t setStreamId() const { return streamId; }
 	void setPayload(const std::vector<uint8_t>* payload) { this->payload = payload; }
+	const std::vector<uint8_t>* getPayload() const { return payload; }
 	bool getDataAlignmentIndicator() const { return dataAlignmentIndicator; }
 
 
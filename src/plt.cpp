@@ -2,9 +2,10 @@
 
 namespace MmtTlv {
 
-bool Plt::unpack(Common::ReadStream& stream)
+bool Plt::unpack(Common::ReadStream& input)
 {
 	try {
+		Common::ReadStream stream = keepSection(input, peekTableSize(input));
 		if (!MmtTableBase::unpack(stream)) {
 			return false;
 		}
@@ -13,12 +14,12 @@ bool Plt::unpack(Common::ReadStream& stream)
 		length = stream.getBe16U();
 		numOfPackage = stream.get8U();
 
+		entries.reserve(numOfPackage);
 		for (int i = 0; i < numOfPackage; i++) {
-			Entry item;
+			Entry& item = entries.emplace_back();
 			if (!item.unpack(stream)) {
 				return false;
 			}
-			entries.push_back(item);
 		}
 	}
 	catch (const std::out_of_range&) {
@@ -36,8 +37,7 @@ bool Plt::Entry::unpack(Common::ReadStream& stream)
 			return false;
 		}
 
-		mmtPackageIdByte.resize(mmtPackageIdLength);
-		stream.read(mmtPackageIdByte.data(), mmtPackageIdLength);
+		mmtPackageIdByte = stream.getSpan(mmtPackageIdLength);
 		if (!locationInfos.unpack(stream)) {
 			return false;
 		}
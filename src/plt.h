@@ -1,5 +1,7 @@
 #pragma once
-#include <list>
+#include <memory_resource>
+#include <span>
+#include <vector>
 #include "mmtTableBase.h"
 #include "mmtGeneralLocationInfo.h"
 
@@ -15,14 +17,14 @@ public:
 		bool unpack(Common::ReadStream& stream);
 
 		uint8_t mmtPackageIdLength;
-		std::vector<uint8_t> mmtPackageIdByte;
+		std::span<const uint8_t> mmtPackageIdByte;
 		MmtGeneralLocationInfo locationInfos;
 	};
 
 	uint8_t version;
 	uint16_t length;
 	uint8_t numOfPackage;
-	std::list<Entry> entries;
+	std::pmr::vector<Entry> entries{ arena.getResource() };
 };
 
 }
\ No newline at end of file
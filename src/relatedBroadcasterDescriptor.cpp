@@ -19,11 +19,10 @@ bool RelatedBroadcasterDescriptor::unpack(Common::ReadStream& stream)
         numOfOriginalNetworkId = (uint8 & 0b11110000) >> 4;
 
 		for (int i = 0; i < numOfBroadcasterId; i++) {
-			BroadcasterId broadcasterId;
+			BroadcasterId& broadcasterId = broadcasterIds.emplace_back();
 			if (!broadcasterId.unpack(nstream)) {
 				return false;
 			}
-			broadcasterIds.push_back(broadcasterId);
 		}
 		
 		for (int i = 0; i < numOfAffiliationId; i++) {
@@ -1,12 +1,15 @@
 #pragma once
 #include "mmtDescriptorBase.h"
-#include <list>
+#include <memory_resource>
+#include <vector>
 
 namespace MmtTlv {
 
 class RelatedBroadcasterDescriptor
 	: public MmtDescriptorTemplate<0x803E> {
 public:
+	explicit RelatedBroadcasterDescriptor(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+		: broadcasterIds(resource), affiliationIds(resource), originalNetworkIds(resource) {}
 	bool unpack(Common::ReadStream& stream) override;
 	
 	class BroadcasterId {
@@ -21,9 +24,9 @@ public:
 	uint8_t numOfAffiliationId;
 	uint8_t numOfOriginalNetworkId;
 
-	std::list<BroadcasterId> broadcasterIds;
-	std::list<uint8_t> affiliationIds;
-	std::list<uint16_t> originalNetworkIds;
+	std::pmr::vector<BroadcasterId> broadcasterIds;
+	std::pmr::vector<uint8_t> affiliationIds;
+	std::pmr::vector<uint16_t> originalNetworkIds;
 
 };
 
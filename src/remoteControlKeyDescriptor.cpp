@@ -11,11 +11,10 @@ bool RemoteControlKeyDescriptor::unpack(Common::ReadStream& stream)
 
         numOfRemoteControlKeyId = stream.get8U();
         for (int i = 0; i < numOfRemoteControlKeyId; i++) {
-            Entry item;
+            Entry& item = entries.emplace_back();
             if (!item.unpack(stream)) {
                 return false;
             }
-            entries.push_back(item);
         }
 	}
 	catch (const std::out_of_range&) {
@@ -1,11 +1,14 @@
 #pragma once
 #include "tlvDescriptorBase.h"
-#include <list>
+#include <memory_resource>
+#include <vector>
 
 namespace MmtTlv {
 
 class RemoteControlKeyDescriptor : public TlvDescriptorTemplate<0xCD> {
 public:
+    explicit RemoteControlKeyDescriptor(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : entries(resource) {}
     bool unpack(Common::ReadStream& stream);
     
     class Entry {
@@ -17,7 +20,7 @@ public:
     };
 
     uint8_t numOfRemoteControlKeyId;
-    std::list<Entry> entries;
+    std::pmr::vector<Entry> entries;
 };
 
 }
\ No newline at end of file
@@ -1,25 +1,9 @@
 ﻿#include "remuxerHandler.h"
 #include "accessControlDescriptor.h"
 #include "contentCopyControlDescriptor.h"
-#include "mhAudioComponentDescriptor.h"
-#include "mhContentDescriptor.h"
 #include "mhEit.h"
-#include "mhEventGroupDescriptor.h"
-#include "mhExtendedEventDescriptor.h"
-#include "mhLinkageDescriptor.h"
-#include "mhLogoTransmissionDescriptor.h"
-#include "mhParentalRatingDescriptor.h"
-#include "mhSeriesDescriptor.h"
-#include "mhShortEventDescriptor.h"
-#include "mhSiParameterDescriptor.h"
 #include "mhStreamIdentificationDescriptor.h"
 #include "mmtTableBase.h"
-#include "multimediaServiceInformationDescriptor.h"
-#include "networkNameDescriptor.h"
-#include "relatedBroadcasterDescriptor.h"
-#include "serviceListDescriptor.h"
-#include "videoComponentDescriptor.h"
-#include "mhServiceDescriptor.h"
 #include "descriptorConverter.h"
 #include "mhBit.h"
 #include "mhAit.h"
@@ -30,6 +14,7 @@
 #include "nit.h"
 #include "plt.h"
 #include "pesPacket.h"
+#include "tsPacketizer.h"
 #include "adtsConverter.h"
 #include "mmtTlvDemuxer.h"
 #include "timebase.h"
@@ -38,45 +23,11 @@
 #include "ntp.h"
 #include "pugixml.hpp"
 #include "b24SubtitleConvertor.h"
+#include "aribUtil.h"
+#include "crc32.h"
 
 namespace {
 
-    int convertRunningStatus(int runningStatus) {
-        /*
-           MMT
-           0 undefined
-           1 In non-operation
-           2 It will start within several seconds
-            (ex: video recording use)
-           3 Out of operation
-           4 In operation
-           5 – 7 Reserved for use in the future
-
-           MPEG2 TS
-           GST_MPEGTS_RUNNING_STATUS_UNDEFINED (0)
-           GST_MPEGTS_RUNNING_STATUS_NOT_RUNNING (1)
-           GST_MPEGTS_RUNNING_STATUS_STARTS_IN_FEW_SECONDS (2)
-           GST_MPEGTS_RUNNING_STATUS_PAUSING (3)
-           GST_MPEGTS_RUNNING_STATUS_RUNNING (4)
-           GST_MPEGTS_RUNNING_STATUS_OFF_AIR (5)
-       */
-
-        switch (runningStatus) {
-        case 0:
-            return 0;
-        case 1:
-            return 1;
-        case 2:
-            return 2;
-        case 3:
-            return 5;
-        case 4:
-            return 4;
-        default:
-            return 0;
-        }
-    }
-
     int assetType2streamType(uint32_t assetType)
     {
         int stream_type = 0;
@@ -95,131 +46,69 @@ namespace {
         return stream_type;
     }
 
-    uint8_t convertTableId(uint8_t mmtTableId) {
-        switch (mmtTableId) {
-        case MmtTlv::MmtTableId::Mpt:
-            return 0x02;
-        case MmtTlv::MmtTableId::Plt:
-            return 0x00;
-        case MmtTlv::MmtTableId::MhEitPf:
-            return 0x4E;
-        case MmtTlv::MmtTableId::MhEitS_0:
-        case MmtTlv::MmtTableId::MhEitS_1:
-        case MmtTlv::MmtTableId::MhEitS_2:
-        case MmtTlv::MmtTableId::MhEitS_3:
-        case MmtTlv::MmtTableId::MhEitS_4:
-        case MmtTlv::MmtTableId::MhEitS_5:
-        case MmtTlv::MmtTableId::MhEitS_6:
-        case MmtTlv::MmtTableId::MhEitS_7:
-        case MmtTlv::MmtTableId::MhEitS_8:
-        case MmtTlv::MmtTableId::MhEitS_9:
-        case MmtTlv::MmtTableId::MhEitS_10:
-        case MmtTlv::MmtTableId::MhEitS_11:
-        case MmtTlv::MmtTableId::MhEitS_12:
-        case MmtTlv::MmtTableId::MhEitS_13:
-        case MmtTlv::MmtTableId::MhEitS_14:
-        case MmtTlv::MmtTableId::MhEitS_15:
-            return 0x50;
-        case MmtTlv::MmtTableId::MhTot:
-            return 0x73;
-        case MmtTlv::MmtTableId::MhBit:
-            return 0xC4;
-        case MmtTlv::MmtTableId::MhSdtActual:
-            return 0x42;
-        case MmtTlv::MmtTableId::MhCdt:
-            return 0xC8;
-        }
-
-        return 0xFF;
-    }
-
 } // anonymous namespace
 
-void RemuxerHandler::onVideoData(const std::shared_ptr<MmtTlv::MmtStream> mmtStream, const std::shared_ptr<struct MmtTlv::MfuData>& mfuData)
+void RemuxerHandler::onVideoData(const std::shared_ptr<MmtTlv::MmtStream>& mmtStream, MmtTlv::MfuData&& mfuData)
 {
-    writeStream(mmtStream, mfuData, mfuData->data);
+    writeStream(mmtStream, mfuData, mfuData.data);
 }
 
-void RemuxerHandler::onAudioData(const std::shared_ptr<MmtTlv::MmtStream> mmtStream, const std::shared_ptr<struct MmtTlv::MfuData>& mfuData)
+void RemuxerHandler::onAudioData(const std::shared_ptr<MmtTlv::MmtStream>& mmtStream, MmtTlv::MfuData&& mfuData)
 {
-    // ADTS conversion for 22.2ch is not implemented.
-    if (mmtStream->Is22_2chAudio()) {
-        writeStream(mmtStream, mfuData, mfuData->data);
+    if (config.disableADTSConversion) {
+        writeStream(mmtStream, mfuData, mfuData.data);
         return;
     }
 
-    if (config.disableADTSConversion) {
-        writeStream(mmtStream, mfuData, mfuData->data);
-        return;
+    // One converter per stream keeps the parsed StreamMuxConfig from frame to frame
+    ADTSConverter& converter = adtsConverters[mmtStream->getMpeg2PacketId()];
+    const bool muxConfigSupported = converter.isMuxConfigSupported();
+    const bool unpacked = converter.unpack(mfuData.data.data(), mfuData.data.size());
+
+    // The stream type changes, so the PMTs go out again with a new version at the next MPT
+    if (converter.isMuxConfigSupported() != muxConfigSupported) {
+        audioStreamTypeRevision++;
     }
 
-    ADTSConverter converter;
-    std::vector<uint8_t> output;
-    if (!converter.convert(mfuData->data.data(), mfuData->data.size(), output)) {
+    if (!unpacked) {
+        // A StreamMuxConfig that ADTS cannot carry keeps its frames as LATM, signalled as such in the PMT
+        if (!converter.isMuxConfigSupported()) {
+            writeStream(mmtStream, mfuData, mfuData.data);
+        }
         return;
     }
 
-    writeStream(mmtStream, mfuData, output);
+    writePes(mmtStream->getMpeg2PacketId(), makeStreamPes(mmtStream, mfuData), converter.getOutputSize(),
+        [&converter](uint8_t* destination, size_t offset, size_t size) { converter.write(destination, offset, size); },
+        mfuData.keyframe);
 }
 
-void RemuxerHandler::onSubtitleData(const std::shared_ptr<MmtTlv::MmtStream> mmtStream, const std::shared_ptr<struct MmtTlv::MfuData>& mfuData)
+void RemuxerHandler::onSubtitleData(const std::shared_ptr<MmtTlv::MmtStream>& mmtStream, MmtTlv::MfuData&& mfuData)
 {
-    std::list<B24SubtiteOutput> output;
-    B24SubtiteConvertor::convert(mfuData->data, output);
-
-    if (output.empty()) {
-        return;
-    }
-    
-    {
-        B24::CaptionManagementData captionManagementData;
-        B24::CaptionManagementData::Langage langage;
-        langage.dmf = 0b1010;
-        langage.languageCode = "jpn";
-        langage.format = 0b1000;
-
-        captionManagementData.langages.push_back(langage);
-
-        B24::DataGroup dataGroup;
-        dataGroup.setGroupData(captionManagementData);
-
-        B24::PESData pesData(dataGroup);
-        pesData.SetPESType(B24::PESData::PESType::Synchronized);
-
-        std::vector<uint8_t> packedPesData;
-        pesData.pack(packedPesData);
-
-        B24SubtiteOutput subtitleOutput;
-        subtitleOutput.pesData = packedPesData;
-        subtitleOutput.begin = output.begin()->begin;
-        subtitleOutput.end = 0;
-        writeSubtitle(mmtStream, subtitleOutput);
-    }
-    
-
-    for (const auto& pesData : output) {
-        writeSubtitle(mmtStream, pesData);
-    }
+    // Converted on the worker thread; the PTS is taken now, the packets are written at a later PCR
+    subtitleWorker.submit({ mmtStream->getMpeg2PacketId(), componentTagToStreamId(mmtStream->getComponentTag()),
+        lastPcr / 300, std::move(mfuData.data) });
 }
 
-void RemuxerHandler::onApplicationData(const std::shared_ptr<MmtTlv::MmtStream> mmtStream, const std::shared_ptr<struct MmtTlv::MfuData>& mfuData)
+void RemuxerHandler::onApplicationData(const std::shared_ptr<MmtTlv::MmtStream>& mmtStream, MmtTlv::MfuData&& mfuData)
 {
 }
 
-void RemuxerHandler::writeStream(const std::shared_ptr<MmtTlv::MmtStream> mmtStream, const std::shared_ptr<struct MmtTlv::MfuData>& mfuData, const std::vector<uint8_t>& streamData)
+void RemuxerHandler::writeStream(const std::shared_ptr<MmtTlv::MmtStream>& mmtStream, const MmtTlv::MfuData& mfuData, const std::vector<uint8_t>& streamData)
 {
-    constexpr AVRational tsTimeBase = { 1, 90000 };
-    const AVRational timeBase = { mmtStream->timeBase.num, mmtStream->timeBase.den };
+    writePes(mmtStream->getMpeg2PacketId(), makeStreamPes(mmtStream, mfuData), streamData.data(), streamData.size(), mfuData.keyframe);
+}
 
+PESPacket RemuxerHandler::makeStreamPes(const std::shared_ptr<MmtTlv::MmtStream>& mmtStream, const MmtTlv::MfuData& mfuData) const
+{
     uint64_t tsPts = MmtTlv::NOPTS_VALUE;
     uint64_t tsDts = MmtTlv::NOPTS_VALUE;
 
-    if ((mfuData->pts != MmtTlv::NOPTS_VALUE && mfuData->dts != MmtTlv::NOPTS_VALUE) && timeBase.den > 0) {
-        tsPts = av_rescale_q(mfuData->pts, timeBase, tsTimeBase);
-        tsDts = av_rescale_q(mfuData->dts, timeBase, tsTimeBase);
+    if ((mfuData.pts != MmtTlv::NOPTS_VALUE && mfuData.dts != MmtTlv::NOPTS_VALUE) && mmtStream->timeBase.den > 0) {
+        tsPts = mmtStream->rescaleTo90kHz(mfuData.pts);
+        tsDts = mmtStream->rescaleTo90kHz(mfuData.dts);
     }
 
-    std::vector<uint8_t> pesOutput;
     PESPacket pes;
     pes.setPts(tsPts);
     pes.setDts(tsDts);
@@ -228,186 +117,95 @@ void RemuxerHandler::writeStream(const std::shared_ptr<MmtTlv::MmtStream> mmtStr
         mmtStream->getAssetType() == MmtTlv::AssetType::mp4a) {
         pes.setDataAlignmentIndicator(true);
     }
-    pes.setPayload(&streamData);
-    pes.pack(pesOutput);
-
-    size_t payloadLength = pesOutput.size();
-    int i = 0;
-    while (payloadLength > 0) {
-        ts::TSPacket packet;
-        packet.init(mmtStream->getMpeg2PacketId(), mapCC[mmtStream->getMpeg2PacketId()] & 0xF, 0);
-        ++mapCC[mmtStream->getMpeg2PacketId()];
-
-        if (i == 0) {
-            packet.setPUSI();
-            if (mfuData->keyframe) {
-                packet.setRandomAccessIndicator(true);
-            }
-        }
-
-        const size_t chunkSize = std::min(payloadLength, static_cast<size_t>(188 - packet.getHeaderSize()));
-        packet.setPayloadSize(chunkSize);
-        memcpy(packet.b + packet.getHeaderSize(), pesOutput.data() + (pesOutput.size() - payloadLength), chunkSize);
-        payloadLength -= chunkSize;
 
-        output.insert(output.end(), packet.b, packet.b + packet.getHeaderSize() + packet.getPayloadSize());
-        ++i;
-    }
+    return pes;
 }
 
-void RemuxerHandler::writeSubtitle(const std::shared_ptr<MmtTlv::MmtStream> mmtStream, const B24SubtiteOutput& subtitle)
+void RemuxerHandler::writeSubtitles(bool wait)
 {
-    std::vector<uint8_t> pesOutput;
-    PESPacket pes;
-    pes.setPts(lastPcr / 300);
-    pes.setStreamId(componentTagToStreamId(mmtStream->getComponentTag()));
-    pes.setPayload(&subtitle.pesData);
-    pes.pack(pesOutput);
+    subtitleWorker.takeResults(subtitleResults, wait);
 
-    size_t payloadLength = pesOutput.size();
-    int i = 0;
-    while (payloadLength > 0) {
-        ts::TSPacket packet;
-        packet.init(mmtStream->getMpeg2PacketId(), mapCC[mmtStream->getMpeg2PacketId()] & 0xF, 0);
-        ++mapCC[mmtStream->getMpeg2PacketId()];
+    for (const auto& result : subtitleResults) {
+        PESPacket pes;
+        pes.setPts(result.pts);
+        pes.setStreamId(result.streamId);
 
-        if (i == 0) {
-            packet.setPUSI();
+        for (const auto& subtitle : result.subtitles) {
+            writePes(result.pid, pes, subtitle.pesData.data(), subtitle.pesData.size(), false);
         }
-
-        const size_t chunkSize = std::min(payloadLength, static_cast<size_t>(188 - packet.getHeaderSize()));
-        packet.setPayloadSize(chunkSize);
-        memcpy(packet.b + packet.getHeaderSize(), pesOutput.data() + (pesOutput.size() - payloadLength), chunkSize);
-        payloadLength -= chunkSize;
-
-        output.insert(output.end(), packet.b, packet.b + packet.getHeaderSize() + packet.getPayloadSize());
-        ++i;
     }
-
-
-
+    subtitleResults.clear();
 }
 
-void RemuxerHandler::onMhBit(const std::shared_ptr<MmtTlv::MhBit>& mhBit)
+void RemuxerHandler::writePes(uint16_t pid, const PESPacket& pes, const uint8_t* payload, size_t payloadSize, bool randomAccess)
 {
-    ts::BIT tsBit(mhBit->versionNumber, mhBit->currentNextIndicator);
-    tsBit.original_network_id = mhBit->originalNetworkId;
-
-    for (const auto& descriptor : mhBit->descriptors.list) {
-        switch (descriptor->getDescriptorTag()) {
-        case MmtTlv::MhSiParameterDescriptor::kDescriptorTag:
-        {
-            auto mmtDescriptor = std::dynamic_pointer_cast<MmtTlv::MhSiParameterDescriptor>(descriptor);
-            ts::SIParameterDescriptor tsDescriptor;
-            tsDescriptor.parameter_version = mmtDescriptor->parameterVersion;
-
-            struct tm tm;
-            EITDecodeMjd(mmtDescriptor->updateTime, &tm.tm_year, &tm.tm_mon, &tm.tm_mday);
-
-            try {
-                tsDescriptor.update_time = ts::Time(tm.tm_year, tm.tm_mon, tm.tm_mday, 0, 0);
-            }
-            catch (const ts::Time::TimeError&) {
-                return;
-            }
-
-            for (const auto& entry : mmtDescriptor->entries) {
-                ts::SIParameterDescriptor::Entry tsEntry;
-                tsEntry.table_id = convertTableId(entry.tableId);
-                if (tsEntry.table_id == 0xFF) {
-                    continue;
-                }
+    writePes(pid, pes, payloadSize,
+        [payload](uint8_t* destination, size_t offset, size_t size) { memcpy(destination, payload + offset, size); },
+        randomAccess);
+}
 
-                tsEntry.table_description.resize(entry.tableDescriptionByte.size());
-                memcpy(tsEntry.table_description.data(), entry.tableDescriptionByte.data(), entry.tableDescriptionByte.size());
-                tsDescriptor.entries.push_back(tsEntry);
-            }
+template<typename PayloadWriter>
+void RemuxerHandler::writePes(uint16_t pid, const PESPacket& pes, size_t payloadSize, PayloadWriter&& writePayload, bool randomAccess)
+{
+    TsPidState& state = pidStates[pid];
+    size_t packetCount = TsPacketizer::writePes(output, pid, state.continuityCounter, pes, payloadSize,
+        std::forward<PayloadWriter>(writePayload), randomAccess);
+    pidStates.addPackets(state, packetCount);
+    ++state.pesCount;
+}
 
-            tsBit.descs.add(duck, tsDescriptor);
-            break;
-        }
+template<typename Table>
+void RemuxerHandler::convertSi(uint64_t sectionKey, uint64_t signature, const std::shared_ptr<Table>& table)
+{
+    if (config.useSiWorker) {
+        auto it = siInFlight.find(sectionKey);
+        if (it != siInFlight.end() && it->second == signature) {
+            return;
         }
-    }
-
-    for (const auto& broadcaster : mhBit->broadcasters) {
-        auto& tsBroadcaster = tsBit.broadcasters[broadcaster.broadcasterId];
-
-        for (const auto& descriptor : broadcaster.descriptors.list) {
-            switch (descriptor->getDescriptorTag()) {
-            case MmtTlv::RelatedBroadcasterDescriptor::kDescriptorTag:
-            {
-                auto mmtDescriptor = std::dynamic_pointer_cast<MmtTlv::RelatedBroadcasterDescriptor>(descriptor);
-                ts::ExtendedBroadcasterDescriptor tsDescriptor;
-                tsDescriptor.broadcaster_type = 1;
-                tsDescriptor.terrestrial_broadcaster_id = mhBit->originalNetworkId;
 
-                for (const auto affiliationId : mmtDescriptor->affiliationIds) {
-                    tsDescriptor.affiliation_ids.emplace_back(affiliationId);
-                }
-
-                for (const auto& broadcasterId : mmtDescriptor->broadcasterIds) {
-                    tsDescriptor.broadcasters.emplace_back(broadcasterId.networkId, broadcasterId.broadcasterId);
-                }
-
-                tsBroadcaster.descs.add(duck, tsDescriptor);
-                break;
-            }
-            case MmtTlv::MhSiParameterDescriptor::kDescriptorTag:
-            {
-                auto mmtDescriptor = std::dynamic_pointer_cast<MmtTlv::MhSiParameterDescriptor>(descriptor);
-                ts::SIParameterDescriptor tsDescriptor;
-                tsDescriptor.parameter_version = mmtDescriptor->parameterVersion;
-
-                struct tm tm;
-                EITDecodeMjd(mmtDescriptor->updateTime, &tm.tm_year, &tm.tm_mon, &tm.tm_mday);
-
-                try {
-                    tsDescriptor.update_time = ts::Time(tm.tm_year, tm.tm_mon, tm.tm_mday, 0, 0);
-                }
-                catch (const ts::Time::TimeError&) {
-                    return;
-                }
-
-                for (const auto& entry : mmtDescriptor->entries) {
-                    ts::SIParameterDescriptor::Entry tsEntry;
-                    tsEntry.table_id = convertTableId(entry.tableId);
-                    if (tsEntry.table_id == 0xFF) {
-                        continue;
-                    }
-
-                    tsEntry.table_description.resize(entry.tableDescriptionByte.size());
-                    memcpy(tsEntry.table_description.data(), entry.tableDescriptionByte.data(), entry.tableDescriptionByte.size());
-                    tsDescriptor.entries.push_back(tsEntry);
-                }
-
-                tsBroadcaster.descs.add(duck, tsDescriptor);
-                break;
-            }
-            }
+        if (siWorker.submit({ sectionKey, signature, std::shared_ptr<const Table>(table) })) {
+            siInFlight[sectionKey] = signature;
+            return;
         }
 
-        tsBit.broadcasters[broadcaster.broadcasterId] = tsBroadcaster;
+        // The queue is full: converting here keeps the delay bounded, and the result on the worker is dropped
+        siInFlight.erase(sectionKey);
     }
 
-    ts::BinaryTable table;
-    tsBit.serialize(duck, table);
+    std::vector<uint8_t> packets = siConverter.convert(*table);
+    if (!packets.empty()) {
+        sectionScheduler.update(sectionKey, signature, nullptr, std::move(packets));
+    }
+}
 
-    ts::OneShotPacketizer packetizer(duck, ts::PID_BIT);
-    for (size_t i = 0; i < table.sectionCount(); i++) {
-        const ts::SectionPtr& section = table.sectionAt(i);
-        section->setSectionNumber(mhBit->sectionNumber);
-        section->setLastSectionNumber(mhBit->lastSectionNumber);
+void RemuxerHandler::writeSi(bool wait)
+{
+    siWorker.takeResults(siResults, wait);
 
-        packetizer.addSection(section);
-        ts::TSPacketVector packets;
-        packetizer.getPackets(packets);
-        for (auto& packet : packets) {
-            packet.setCC(mapCC[ts::PID_BIT] & 0xF);
-            mapCC[ts::PID_BIT]++;
+    for (auto& result : siResults) {
+        // Results overtaken by a newer version of their section, or converted inline meanwhile, are dropped
+        auto it = siInFlight.find(result.key);
+        if (it == siInFlight.end() || it->second != result.signature) {
+            continue;
+        }
+        siInFlight.erase(it);
 
-            output.insert(output.end(), packet.b, packet.b + packet.getHeaderSize() + packet.getPayloadSize());
+        if (!result.packets.empty()) {
+            sectionScheduler.update(result.key, result.signature, nullptr, std::move(result.packets));
         }
     }
+    siResults.clear();
+}
+
+void RemuxerHandler::onMhBit(const std::shared_ptr<MmtTlv::MhBit>& mhBit)
+{
+    const uint64_t sectionKey = TsSectionScheduler::makeKey(ts::PID_BIT, 0xC4, mhBit->originalNetworkId, mhBit->sectionNumber);
+    const uint64_t signature = TsSectionScheduler::makeSignature(mhBit->versionNumber, mhBit->crc32);
+    if (sectionScheduler.repeat(sectionKey, signature)) {
+        return;
+    }
+
+    convertSi(sectionKey, signature, mhBit);
 }
 
 void RemuxerHandler::onMhAit(const std::shared_ptr<MmtTlv::MhAit>& mhAit)
@@ -420,154 +218,18 @@ void RemuxerHandler::onMhEit(const std::shared_ptr<MmtTlv::MhEit>& mhEit)
     tsid = mhEit->tlvStreamId;
 
     if (mhEit->isPf() && mhEit->sectionNumber == 0 && mhEit->events.size() > 0) {
-        struct tm startTime = EITConvertStartTime(mhEit->events.begin()->get()->startTime);
+        struct tm startTime = EITConvertStartTime(mhEit->events.front().startTime);
         eitPresentStartTime = mktime(&startTime);
     }
 
-    ts::EIT tsEit(true, mhEit->isPf(), 0, mhEit->versionNumber, true, mhEit->serviceId, mhEit->tlvStreamId, mhEit->originalNetworkId);
-    for (const auto& mhEvent : mhEit->events) {
-        ts::EIT::Event tsEvent(&tsEit);
-
-        struct tm startTime = EITConvertStartTime(mhEvent->startTime);
-        try {
-            tsEvent.start_time = ts::Time(startTime.tm_year + 1900, startTime.tm_mon + 1, startTime.tm_mday,
-                startTime.tm_hour, startTime.tm_min, startTime.tm_sec);
-        }
-        catch (const ts::Time::TimeError&) {
-            continue;
-        }
-
-        tsEvent.duration = std::chrono::seconds(EITConvertDuration(mhEvent->duration));
-        tsEvent.running_status = convertRunningStatus(mhEvent->runningStatus);
-        tsEvent.event_id = mhEvent->eventId;
-
-        for (const auto& descriptor : mhEvent->descriptors.list) {
-            switch (descriptor->getDescriptorTag()) {
-            case MmtTlv::MhShortEventDescriptor::kDescriptorTag:
-            {
-                auto mmtDescriptor = std::dynamic_pointer_cast<MmtTlv::MhShortEventDescriptor>(descriptor);
-                auto tsDescriptor = DescriptorConverter<MmtTlv::MhShortEventDescriptor>::convert(*mmtDescriptor);
-                if (tsDescriptor) {
-                    tsEvent.descs.add(tsDescriptor->data(), tsDescriptor->size());
-                }
-                break;
-            }
-            case MmtTlv::MhExtendedEventDescriptor::kDescriptorTag:
-            {
-                auto mmtDescriptor = std::dynamic_pointer_cast<MmtTlv::MhExtendedEventDescriptor>(descriptor);
-                auto tsDescriptor = DescriptorConverter<MmtTlv::MhExtendedEventDescriptor>::convert(*mmtDescriptor);
-                if (tsDescriptor) {
-                    tsEvent.descs.add(tsDescriptor->data(), tsDescriptor->size());
-                }
-                break;
-            }
-            case MmtTlv::MhAudioComponentDescriptor::kDescriptorTag:
-            {
-                auto mmtDescriptor = std::dynamic_pointer_cast<MmtTlv::MhAudioComponentDescriptor>(descriptor);
-                auto tsDescriptor = DescriptorConverter<MmtTlv::MhAudioComponentDescriptor>::convert(*mmtDescriptor);
-
-                tsEvent.descs.add(duck, tsDescriptor);
-                break;
-            }
-            case MmtTlv::VideoComponentDescriptor::kDescriptorTag:
-            {
-                auto mmtDescriptor = std::dynamic_pointer_cast<MmtTlv::VideoComponentDescriptor>(descriptor);
-                auto tsDescriptor = DescriptorConverter<MmtTlv::VideoComponentDescriptor>::convert(*mmtDescriptor);
-
-                tsEvent.descs.add(duck, tsDescriptor);
-                break;
-            }
-            case MmtTlv::MhContentDescriptor::kDescriptorTag:
-            {
-                auto mmtDescriptor = std::dynamic_pointer_cast<MmtTlv::MhContentDescriptor>(descriptor);
-                auto tsDescriptor = DescriptorConverter<MmtTlv::MhContentDescriptor>::convert(*mmtDescriptor);
-
-                tsEvent.descs.add(duck, tsDescriptor);
-                break;
-            }
-            case MmtTlv::MhLinkageDescriptor::kDescriptorTag:
-            {
-                auto mmtDescriptor = std::dynamic_pointer_cast<MmtTlv::MhLinkageDescriptor>(descriptor);
-                auto tsDescriptor = DescriptorConverter<MmtTlv::MhLinkageDescriptor>::convert(*mmtDescriptor);
-
-                tsEvent.descs.add(duck, tsDescriptor);
-                break;
-            }
-            case MmtTlv::MhEventGroupDescriptor::kDescriptorTag:
-            {
-                auto mmtDescriptor = std::dynamic_pointer_cast<MmtTlv::MhEventGroupDescriptor>(descriptor);
-                auto tsDescriptor = DescriptorConverter<MmtTlv::MhEventGroupDescriptor>::convert(*mmtDescriptor);
-
-                tsEvent.descs.add(duck, tsDescriptor);
-                break;
-            }
-            case MmtTlv::MhParentalRatingDescriptor::kDescriptorTag:
-            {
-                auto mmtDescriptor = std::dynamic_pointer_cast<MmtTlv::MhParentalRatingDescriptor>(descriptor);
-                auto tsDescriptor = DescriptorConverter<MmtTlv::MhParentalRatingDescriptor>::convert(*mmtDescriptor);
-
-                tsEvent.descs.add(duck, tsDescriptor);
-                break;
-            }
-            case MmtTlv::MhSeriesDescriptor::kDescriptorTag:
-            {
-                auto mmtDescriptor = std::dynamic_pointer_cast<MmtTlv::MhSeriesDescriptor>(descriptor);
-                auto tsDescriptor = DescriptorConverter<MmtTlv::MhSeriesDescriptor>::convert(*mmtDescriptor);
-
-                tsEvent.descs.add(duck, tsDescriptor);
-                break;
-            }
-            case MmtTlv::ContentCopyControlDescriptor::kDescriptorTag:
-            {
-                auto mmtDescriptor = std::dynamic_pointer_cast<MmtTlv::ContentCopyControlDescriptor>(descriptor);
-                auto tsDescriptor = DescriptorConverter<MmtTlv::ContentCopyControlDescriptor>::convert(*mmtDescriptor);
-
-                tsEvent.descs.add(duck, tsDescriptor);
-                break;
-            }
-            case MmtTlv::MultimediaServiceInformationDescriptor::kDescriptorTag:
-            {
-                auto mmtDescriptor = std::dynamic_pointer_cast<MmtTlv::MultimediaServiceInformationDescriptor>(descriptor);
-                auto tsDescriptor = DescriptorConverter<MmtTlv::MultimediaServiceInformationDescriptor>::convert(*mmtDescriptor);
-
-                tsEvent.descs.add(duck, tsDescriptor);
-                break;
-            }
-            }
-        }
-
-        tsEit.events[tsEvent.event_id] = tsEvent;
+    const uint8_t tableId = SiConverter::convertEitTableId(*mhEit);
+    const uint64_t sectionKey = TsSectionScheduler::makeKey(ts::PID_EIT, tableId, mhEit->serviceId, mhEit->sectionNumber);
+    const uint64_t signature = TsSectionScheduler::makeSignature(mhEit->versionNumber, mhEit->crc32);
+    if (sectionScheduler.repeat(sectionKey, signature)) {
+        return;
     }
 
-    // EITs table ID range in MMT/TLV:   0x8C ~ 0x9B
-    // EITs table ID range in MPEG-2 TS: 0x50 ~ 0x5F
-    tsEit.last_table_id = mhEit->lastTableId - 0x8C + 0x50;
-
-    ts::BinaryTable table;
-    tsEit.serialize(duck, table);
-
-    ts::OneShotPacketizer packetizer(duck, ts::PID_EIT);
-    for (size_t i = 0; i < table.sectionCount(); i++) {
-        const ts::SectionPtr& section = table.sectionAt(i);
-        if (mhEit->isPf()) {
-            section.get()->setTableId(0x4E);
-        }
-        else {
-            section.get()->setTableId(mhEit->getTableId() - 0x8C + 0x50);
-        }
-        section.get()->setSectionNumber(mhEit->sectionNumber);
-        section.get()->setLastSectionNumber(mhEit->lastSectionNumber);
-
-        packetizer.addSection(section);
-        ts::TSPacketVector packets;
-        packetizer.getPackets(packets);
-        for (auto& packet : packets) {
-            packet.setCC(mapCC[ts::PID_EIT] & 0xF);
-            mapCC[ts::PID_EIT]++;
-
-            output.insert(output.end(), packet.b, packet.b + packet.getHeaderSize() + packet.getPayloadSize());
-        }
-    }
+    convertSi(sectionKey, signature, mhEit);
 }
 
 void RemuxerHandler::onMhSdtActual(const std::shared_ptr<MmtTlv::MhSdt>& mhSdt)
@@ -578,56 +240,13 @@ void RemuxerHandler::onMhSdtActual(const std::shared_ptr<MmtTlv::MhSdt>& mhSdt)
 
     tsid = mhSdt->tlvStreamId;
 
-    ts::SDT tsSdt(true, mhSdt->versionNumber, mhSdt->currentNextIndicator, mhSdt->tlvStreamId, mhSdt->originalNetworkId);
-    for (const auto& service : mhSdt->services) {
-        ts::SDT::ServiceEntry tsService(&tsSdt);
-        tsService.EITs_present = service->eitScheduleFlag;
-        tsService.EITpf_present = service->eitPresentFollowingFlag;
-        tsService.running_status = convertRunningStatus(service->runningStatus);
-        tsService.CA_controlled = service->freeCaMode;
-
-        for (const auto& descriptor : service->descriptors.list) {
-            switch (descriptor->getDescriptorTag()) {
-            case MmtTlv::MhServiceDescriptor::kDescriptorTag:
-            {
-                auto mmtDescriptor = std::dynamic_pointer_cast<MmtTlv::MhServiceDescriptor>(descriptor);
-                auto tsDescriptor = DescriptorConverter<MmtTlv::MhServiceDescriptor>::convert(*mmtDescriptor);
-
-                tsService.descs.add(duck, tsDescriptor);
-                break;
-            }
-            case MmtTlv::MhLogoTransmissionDescriptor::kDescriptorTag:
-            {
-                auto mmtDescriptor = std::dynamic_pointer_cast<MmtTlv::MhLogoTransmissionDescriptor>(descriptor);
-                auto tsDescriptor = DescriptorConverter<MmtTlv::MhLogoTransmissionDescriptor>::convert(*mmtDescriptor);
-
-                tsService.descs.add(duck, tsDescriptor);
-                break;
-            }
-            }
-        }
-        tsSdt.services[service->serviceId] = tsService;
+    const uint64_t sectionKey = TsSectionScheduler::makeKey(ts::PID_SDT, 0x42, mhSdt->tlvStreamId, mhSdt->sectionNumber);
+    const uint64_t signature = TsSectionScheduler::makeSignature(mhSdt->versionNumber, mhSdt->crc32);
+    if (sectionScheduler.repeat(sectionKey, signature)) {
+        return;
     }
 
-    ts::BinaryTable table;
-    tsSdt.serialize(duck, table);
-
-    ts::OneShotPacketizer packetizer(duck, ts::PID_SDT);
-    for (size_t i = 0; i < table.sectionCount(); i++) {
-        const ts::SectionPtr& section = table.sectionAt(i);
-        section.get()->setSectionNumber(mhSdt->sectionNumber);
-        section.get()->setLastSectionNumber(mhSdt->lastSectionNumber);
-
-        packetizer.addSection(section);
-        ts::TSPacketVector packets;
-        packetizer.getPackets(packets);
-        for (auto& packet : packets) {
-            packet.setCC(mapCC[ts::PID_SDT] & 0xF);
-            mapCC[ts::PID_SDT]++;
-
-            output.insert(output.end(), packet.b, packet.b + packet.getHeaderSize() + packet.getPayloadSize());
-        }
-    }
+    convertSi(sectionKey, signature, mhSdt);
 }
 
 void RemuxerHandler::onPlt(const std::shared_ptr<MmtTlv::Plt>& plt)
@@ -635,7 +254,17 @@ void RemuxerHandler::onPlt(const std::shared_ptr<MmtTlv::Plt>& plt)
     if (tsid == -1)
         return;
 
+    // PLT carries no CRC, so an unchanged section is recognized by the demuxer handing out the same table again
+    const uint64_t sectionKey = TsSectionScheduler::makeKey(ts::PID_PAT, 0x00, tsid, 0);
+    const uint64_t signature = TsSectionScheduler::makeSignature(plt->version % 32);
+    if (sectionScheduler.repeat(sectionKey, signature, plt.get())) {
+        return;
+    }
+
     ts::PAT pat(plt->version % 32, true, tsid);
+    for (const auto& [serviceId, pmtPid] : mapService2Pid) {
+        sectionScheduler.remove(pmtPid);
+    }
     mapService2Pid.clear();
 
     int i = 0;
@@ -658,21 +287,53 @@ void RemuxerHandler::onPlt(const std::shared_ptr<MmtTlv::Plt>& plt)
     ts::BinaryTable table;
     pat.serialize(duck, table);
 
-    ts::OneShotPacketizer packetizer(duck, ts::PID_PAT);
-
-    for (size_t i = 0; i < table.sectionCount(); i++) {
-        const ts::SectionPtr& section = table.sectionAt(i);
-        packetizer.addSection(section);
+    // A PAT kept under another transport_stream_id would go on repeating beside this one
+    sectionScheduler.remove(ts::PID_PAT);
+    sectionScheduler.update(sectionKey, signature, plt, siConverter.packetizeTable(ts::PID_PAT, table));
+}
 
-        ts::TSPacketVector packets;
-        packetizer.getPackets(packets);
-        for (auto& packet : packets) {
-            packet.setCC(mapCC[ts::PID_PAT] & 0xF);
-            mapCC[ts::PID_PAT]++;
+// CRC of the parts of the MPT that the PMT is built from. The MPT changes with every MPU through the
+// timestamps in its asset descriptors, which the PMT leaves out.
+uint32_t RemuxerHandler::getPmtSourceCrc(const MmtTlv::Mpt& mpt) const
+{
+    uint32_t crc = 0xFFFFFFFF;
+    auto add = [&crc](const auto& value) {
+        crc = MmtTlv::Common::crc32Mpeg2(reinterpret_cast<const uint8_t*>(&value), sizeof(value), crc);
+    };
 
-            output.insert(output.end(), packet.b, packet.b + packet.getHeaderSize() + packet.getPayloadSize());
+    int streamIndex = 0;
+    for (const auto& asset : mpt.assets) {
+        add(asset.assetType);
+        for (const auto& locationInfo : asset.locationInfos) {
+            add(locationInfo.locationType);
+            if (locationInfo.locationType == 0) {
+                const auto& mmtStream = demuxer.getStreamByIndex(streamIndex++);
+                add(mmtStream ? mmtStream->getComponentTag() : -1);
+            }
         }
-    }
+
+        asset.descriptors.visit([&](const MmtTlv::MhStreamIdentificationDescriptor& mmtDescriptor) {
+            add(mmtDescriptor.componentTag);
+        });
+    }
+
+    mpt.descriptors.visit(MmtTlv::Overloaded{
+        [&](const MmtTlv::AccessControlDescriptor& mmtDescriptor) {
+            add(mmtDescriptor.caSystemId);
+            crc = MmtTlv::Common::crc32Mpeg2(mmtDescriptor.privateData.data(), mmtDescriptor.privateData.size(), crc);
+        },
+        [&](const MmtTlv::ContentCopyControlDescriptor& mmtDescriptor) {
+            add(mmtDescriptor.digitalRecordingControlData);
+            add(mmtDescriptor.maximumBitrateFlag ? mmtDescriptor.maximumBitrate : -1);
+            for (const auto& component : mmtDescriptor.components) {
+                add(component.componentTag);
+                add(component.digitalRecordingControlData);
+                add(component.maximumBitrateFlag ? component.maximumBitrate : -1);
+            }
+        },
+    });
+
+    return crc;
 }
 
 void RemuxerHandler::onMpt(const std::shared_ptr<MmtTlv::Mpt>& mpt)
@@ -693,7 +354,14 @@ void RemuxerHandler::onMpt(const std::shared_ptr<MmtTlv::Mpt>& mpt)
 
     pid = it->second;
 
-    ts::PMT tsPmt(mpt->version % 32, true, serviceId, PCR_PID);
+    const uint64_t sectionKey = TsSectionScheduler::makeKey(pid, 0x02, serviceId, 0);
+    const uint8_t version = (mpt->version + audioStreamTypeRevision) % 32;
+    const uint64_t signature = TsSectionScheduler::makeSignature(version, getPmtSourceCrc(*mpt));
+    if (sectionScheduler.repeat(sectionKey, signature)) {
+        return;
+    }
+
+    ts::PMT tsPmt(version, true, serviceId, PCR_PID);
 
     // For VLC to recognize as ARIB standard
     ts::CADescriptor caDescriptor(5, 0x0901);
@@ -703,8 +371,8 @@ void RemuxerHandler::onMpt(const std::shared_ptr<MmtTlv::Mpt>& mpt)
     for (auto& asset : mpt->assets) {
         for (int i = 0; i < asset.locationCount; i++) {
             if (asset.locationInfos[i].locationType == 0) {
-                const auto& mmtStream = demuxer.mapStreamByStreamIdx[streamIndex];
-                if (mmtStream->getComponentTag() == -1) {
+                const auto& mmtStream = demuxer.getStreamByIndex(streamIndex);
+                if (!mmtStream || mmtStream->getComponentTag() == -1) {
                     streamIndex++;
                     continue;
                 }
@@ -715,8 +383,8 @@ void RemuxerHandler::onMpt(const std::shared_ptr<MmtTlv::Mpt>& mpt)
                 }
 
                 if (streamType == StreamType::AUDIO_AAC) {
-                    // ADTS conversion for 22.2ch is not implemented.
-                    if (mmtStream->Is22_2chAudio()) {
+                    auto converter = adtsConverters.find(mmtStream->getMpeg2PacketId());
+                    if (converter != adtsConverters.end() && !converter->second.isMuxConfigSupported()) {
                         streamType = StreamType::AUDIO_AAC_LATM;
                     }
                 }
@@ -736,18 +404,11 @@ void RemuxerHandler::onMpt(const std::shared_ptr<MmtTlv::Mpt>& mpt)
                     stream.descs.add(duck, descriptor);
                 }
 
-                for (const auto& descriptor : asset.descriptors.list) {
-                    switch (descriptor->getDescriptorTag()) {
-                    case MmtTlv::MhStreamIdentificationDescriptor::kDescriptorTag:
-                    {
-                        auto mmtDescriptor = std::dynamic_pointer_cast<MmtTlv::MhStreamIdentificationDescriptor>(descriptor);
-                        auto tsDescriptor = DescriptorConverter<MmtTlv::MhStreamIdentificationDescriptor>::convert(*mmtDescriptor);
+                asset.descriptors.visit([&](const MmtTlv::MhStreamIdentificationDescriptor& mmtDescriptor) {
+                    auto tsDescriptor = DescriptorConverter<MmtTlv::MhStreamIdentificationDescriptor>::convert(mmtDescriptor);
 
-                        stream.descs.add(duck, tsDescriptor);
-                        break;
-                    }
-                    }
-                }
+                    stream.descs.add(duck, tsDescriptor);
+                });
 
                 tsPmt.streams[mmtStream->getMpeg2PacketId()] = stream;
                 streamIndex++;
@@ -755,45 +416,23 @@ void RemuxerHandler::onMpt(const std::shared_ptr<MmtTlv::Mpt>& mpt)
         }
     }
 
-    for (const auto& descriptor : mpt->descriptors.list) {
-        switch (descriptor->getDescriptorTag()) {
-        case MmtTlv::AccessControlDescriptor::kDescriptorTag:
-        {
-            auto mmtDescriptor = std::dynamic_pointer_cast<MmtTlv::AccessControlDescriptor>(descriptor);
-            auto tsDescriptor = DescriptorConverter<MmtTlv::AccessControlDescriptor>::convert(*mmtDescriptor);
+    mpt->descriptors.visit(MmtTlv::Overloaded{
+        [&](const MmtTlv::AccessControlDescriptor& mmtDescriptor) {
+            auto tsDescriptor = DescriptorConverter<MmtTlv::AccessControlDescriptor>::convert(mmtDescriptor);
 
             tsPmt.descs.add(duck, tsDescriptor);
-            break;
-        }
-        case MmtTlv::ContentCopyControlDescriptor::kDescriptorTag:
-        {
-            auto mmtDescriptor = std::dynamic_pointer_cast<MmtTlv::ContentCopyControlDescriptor>(descriptor);
-            auto tsDescriptor = DescriptorConverter<MmtTlv::ContentCopyControlDescriptor>::convert(*mmtDescriptor);
+        },
+        [&](const MmtTlv::ContentCopyControlDescriptor& mmtDescriptor) {
+            auto tsDescriptor = DescriptorConverter<MmtTlv::ContentCopyControlDescriptor>::convert(mmtDescriptor);
 
             tsPmt.descs.add(duck, tsDescriptor);
-            break;
-        }
-        }
-    }
+        },
+    });
 
     ts::BinaryTable table;
     tsPmt.serialize(duck, table);
 
-    ts::OneShotPacketizer packetizer(duck, pid);
-
-    for (size_t i = 0; i < table.sectionCount(); i++) {
-        const ts::SectionPtr& section = table.sectionAt(i);
-        packetizer.addSection(section);
-
-        ts::TSPacketVector packets;
-        packetizer.getPackets(packets);
-        for (auto& packet : packets) {
-            packet.setCC(mapCC[pid] & 0xF);
-            mapCC[pid]++;
-
-            output.insert(output.end(), packet.b, packet.b + packet.getHeaderSize() + packet.getPayloadSize());
-        }
-    }
+    sectionScheduler.update(sectionKey, signature, nullptr, siConverter.packetizeTable(pid, table));
 }
 
 void RemuxerHandler::onMhTot(const std::shared_ptr<MmtTlv::MhTot>& mhTot)
@@ -815,8 +454,7 @@ void RemuxerHandler::onMhTot(const std::shared_ptr<MmtTlv::MhTot>& mhTot)
         ts::TSPacketVector packets;
         packetizer.getPackets(packets);
         for (auto& packet : packets) {
-            packet.setCC(mapCC[ts::PID_TOT] & 0xF);
-            mapCC[ts::PID_TOT]++;
+            packet.setCC(pidStates.nextContinuityCounter(ts::PID_TOT));
 
             output.insert(output.end(), packet.b, packet.b + packet.getHeaderSize() + packet.getPayloadSize());
         }
@@ -825,107 +463,102 @@ void RemuxerHandler::onMhTot(const std::shared_ptr<MmtTlv::MhTot>& mhTot)
 
 void RemuxerHandler::onMhCdt(const std::shared_ptr<MmtTlv::MhCdt>& mhCdt)
 {
-    ts::CDT cdt(mhCdt->versionNumber, mhCdt->currentNextIndicator);
-    cdt.original_network_id = mhCdt->originalNetworkId;
-    cdt.download_data_id = mhCdt->downloadDataId;
-    cdt.data_type = mhCdt->dataType;
-    cdt.data_module.resize(mhCdt->dataModuleByte.size());
-    memcpy(cdt.data_module.data(), mhCdt->dataModuleByte.data(), mhCdt->dataModuleByte.size());
-
-    ts::BinaryTable table;
-    cdt.serialize(duck, table);
-    ts::OneShotPacketizer packetizer(duck, ts::PID_CDT);
-
-    for (size_t i = 0; i < table.sectionCount(); i++) {
-        const ts::SectionPtr& section = table.sectionAt(i);
-        section.get()->setSectionNumber(mhCdt->sectionNumber);
-        section.get()->setLastSectionNumber(mhCdt->lastSectionNumber);
-        packetizer.addSection(section);
-
-        ts::TSPacketVector packets;
-        packetizer.getPackets(packets);
-        for (auto& packet : packets) {
-            packet.setCC(mapCC[ts::PID_CDT] & 0xF);
-            mapCC[ts::PID_CDT]++;
-
-            output.insert(output.end(), packet.b, packet.b + packet.getHeaderSize() + packet.getPayloadSize());
-        }
+    const uint64_t sectionKey = TsSectionScheduler::makeKey(ts::PID_CDT, 0xC8, mhCdt->downloadDataId, mhCdt->sectionNumber);
+    const uint64_t signature = TsSectionScheduler::makeSignature(mhCdt->versionNumber, mhCdt->crc32);
+    if (sectionScheduler.repeat(sectionKey, signature)) {
+        return;
     }
+
+    convertSi(sectionKey, signature, mhCdt);
 }
 
 void RemuxerHandler::onNit(const std::shared_ptr<MmtTlv::Nit>& nit)
 {
-    ts::NIT tsNit(true, nit->versionNumber, nit->currentNextIndicator, nit->networkId);
-
-    for (const auto& descriptor : nit->descriptors.list) {
-        switch (descriptor->getDescriptorTag()) {
-        case MmtTlv::NetworkNameDescriptor::kDescriptorTag:
-        {
-            auto mmtDescriptor = std::dynamic_pointer_cast<MmtTlv::NetworkNameDescriptor>(descriptor);
-            auto tsDescriptor = DescriptorConverter<MmtTlv::NetworkNameDescriptor>::convert(*mmtDescriptor);
-
-            tsNit.descs.add(duck, tsDescriptor);
-            break;
-        }
-        }
-    }
-
-    for (const auto& item : nit->entries) {
-        ts::TransportStreamId tsid(item.tlvStreamId, item.originalNetworkId);
-        tsNit.transports[tsid];
-
-        for (auto& descriptor : item.descriptors.list) {
-            switch (descriptor->getDescriptorTag()) {
-            case MmtTlv::ServiceListDescriptor::kDescriptorTag:
-            {
-                auto mmtDescriptor = std::dynamic_pointer_cast<MmtTlv::ServiceListDescriptor>(descriptor);
-                auto tsDescriptor = DescriptorConverter<MmtTlv::ServiceListDescriptor>::convert(*mmtDescriptor);
-
-                tsNit.transports[tsid].descs.add(duck, tsDescriptor);
-                break;
-            }
-            }
-        }
+    const uint64_t sectionKey = TsSectionScheduler::makeKey(ts::PID_NIT, 0x40, nit->networkId, nit->sectionNumber);
+    const uint64_t signature = TsSectionScheduler::makeSignature(nit->versionNumber, nit->crc32);
+    if (sectionScheduler.repeat(sectionKey, signature)) {
+        return;
     }
 
-    ts::BinaryTable table;
-    tsNit.serialize(duck, table);
-    ts::OneShotPacketizer packetizer(duck, ts::PID_NIT);
-
-    for (size_t i = 0; i < table.sectionCount(); i++) {
-        const ts::SectionPtr& section = table.sectionAt(i);
-        section->setSectionNumber(nit->sectionNumber);
-        section->setLastSectionNumber(nit->lastSectionNumber);
-        packetizer.addSection(section);
-
-        ts::TSPacketVector packets;
-        packetizer.getPackets(packets);
-        for (auto& packet : packets) {
-            packet.setCC(mapCC[ts::PID_NIT] & 0xF);
-            mapCC[ts::PID_NIT]++;
-
-            output.insert(output.end(), packet.b, packet.b + packet.getHeaderSize() + packet.getPayloadSize());
-        }
-    }
+    convertSi(sectionKey, signature, nit);
 }
 
 void RemuxerHandler::onNtp(const std::shared_ptr<MmtTlv::NTPv4>& ntp)
 {
     ts::TSPacket packet;
-    packet.init(PCR_PID, mapCC[PCR_PID] & 0xF, 0);
-    mapCC[PCR_PID]++;
+    packet.init(PCR_PID, pidStates.nextContinuityCounter(PCR_PID), 0);
 
     // Add 0.1 seconds to resolve the playback issue in VLC
     packet.setPCR(ntp->transmit_timestamp.toPcrValue() + 2700000, true);
     output.insert(output.end(), packet.b, packet.b + packet.getHeaderSize() + packet.getPayloadSize());
 
     lastPcr = ntp->transmit_timestamp.toPcrValue();
+    pidStates.setPcr(lastPcr);
+    // The PCR only advances here, so no section is repeated more often than NTP arrives
+    sectionScheduler.poll(lastPcr);
+
+    // SI and subtitles converted since the previous PCR go out right behind this one
+    writeSi(false);
+    writeSubtitles(false);
+}
+
+void RemuxerHandler::setRepetitionIntervals(const Config& config)
+{
+    sectionScheduler.setInterval(0x00, config.patInterval);
+    sectionScheduler.setInterval(0x02, config.pmtInterval);
+    sectionScheduler.setInterval(0x40, config.nitInterval);
+    sectionScheduler.setInterval(0x42, config.sdtInterval);
+    sectionScheduler.setInterval(0x4E, config.eitPfInterval);
+    for (uint8_t tableId = 0x50; tableId <= 0x5F; tableId++) {
+        sectionScheduler.setInterval(tableId, config.eitScheduleInterval);
+    }
+    sectionScheduler.setInterval(0xC4, config.bitInterval);
+    sectionScheduler.setInterval(0xC8, config.cdtInterval);
+}
+
+void RemuxerHandler::printStatistics() const
+{
+    pidStates.print();
+
+    const AribEncodeCacheStatistics aribEncodeCache = getAribEncodeCacheStatistics();
+    std::ostringstream oss;
+    oss << " - Entries: " << aribEncodeCache.size;
+    oss << ", Hits: " << aribEncodeCache.hitCount;
+    oss << ", Misses: " << aribEncodeCache.missCount;
+    oss << ", HitRate: " << std::fixed << std::setprecision(1) << aribEncodeCache.getHitRate() * 100 << "%";
+    std::cerr << "ARIB Encode Cache:" << std::endl;
+    std::cerr << oss.str() << std::endl;
+
+    const SiConversionStatistics siConversion = SiConverter::getStatistics();
+    oss.str("");
+    oss << " - Dropped Events: " << siConversion.droppedEventCount;
+    oss << ", Dropped Services: " << siConversion.droppedServiceCount;
+    std::cerr << "SI Conversion:" << std::endl;
+    std::cerr << oss.str() << std::endl;
 }
 
 void RemuxerHandler::clear()
 {
     mapService2Pid.clear();
-    mapCC.clear();
+    pidStates.clear();
+    sectionScheduler.clear();
     tsid = -1;
     streamCount = 0;
+    siWorker.discard();
+    siInFlight.clear();
+    subtitleWorker.discard();
+    adtsConverters.clear();
+    audioStreamTypeRevision = 0;
+}
+
+void RemuxerHandler::flush()
+{
+    writeSi(true);
+    writeSubtitles(true);
+}
+
+void RemuxerHandler::release()
+{
+    siWorker.stop();
+    subtitleWorker.stop();
 }
@@ -1,7 +1,15 @@
 #pragma once
 #include <tsduck.h>
 #include "demuxerHandler.h"
+#include "adtsConverter.h"
 #include "b24SubtitleConvertor.h"
+#include "siConverter.h"
+#include "siWorker.h"
+#include "subtitleWorker.h"
+#include "pesPacket.h"
+#include "tsPidState.h"
+#include "tsSectionScheduler.h"
+#include <deque>
 #include <unordered_map>
 
 namespace StreamType {
@@ -34,24 +42,26 @@ class MhSdt;
 class MhTot;
 class Nit;
 class MmtStream;
-class MmtTlvDemuxer;
+class MmtTlvDemuxerBase;
 class NTPv4;
 
 }
 
+class Config;
+
 constexpr uint16_t PCR_PID = 0x01FF;
 
-class RemuxerHandler : public MmtTlv::DemuxerHandler {
+class RemuxerHandler final : public MmtTlv::DemuxerHandler {
 public:
-	RemuxerHandler(MmtTlv::MmtTlvDemuxer& demuxer, std::vector<uint8_t>& output)
+	RemuxerHandler(MmtTlv::MmtTlvDemuxerBase& demuxer, std::vector<uint8_t>& output)
 		: demuxer(demuxer), output(output) {
 	}
 
 	// MPU data
-	void onVideoData(const std::shared_ptr<MmtTlv::MmtStream> mmtStream, const std::shared_ptr<struct MmtTlv::MfuData>& mfuData) override;
-	void onAudioData(const std::shared_ptr<MmtTlv::MmtStream> mmtStream, const std::shared_ptr<struct MmtTlv::MfuData>& mfuData) override;
-	void onSubtitleData(const std::shared_ptr<MmtTlv::MmtStream> mmtStream, const std::shared_ptr<struct MmtTlv::MfuData>& mfuData) override;
-	void onApplicationData(const std::shared_ptr<MmtTlv::MmtStream> mmtStream, const std::shared_ptr<struct MmtTlv::MfuData>& mfuData) override;
+	void onVideoData(const std::shared_ptr<MmtTlv::MmtStream>& mmtStream, MmtTlv::MfuData&& mfuData) override;
+	void onAudioData(const std::shared_ptr<MmtTlv::MmtStream>& mmtStream, MmtTlv::MfuData&& mfuData) override;
+	void onSubtitleData(const std::shared_ptr<MmtTlv::MmtStream>& mmtStream, MmtTlv::MfuData&& mfuData) override;
+	void onApplicationData(const std::shared_ptr<MmtTlv::MmtStream>& mmtStream, MmtTlv::MfuData&& mfuData) override;
 
 	// MMT message
 	void onMhBit(const std::shared_ptr<MmtTlv::MhBit>& mhCdt) override;
@@ -70,16 +80,42 @@ public:
 	// IPv6
 	void onNtp(const std::shared_ptr<MmtTlv::NTPv4>& ntp) override;
 
+	void setRepetitionIntervals(const Config& config);
+	void printStatistics() const;
 	void clear();
 
-private:
-	void writeStream(const std::shared_ptr<MmtTlv::MmtStream> mmtStream, const std::shared_ptr<MmtTlv::MfuData>& mfuData, const std::vector<uint8_t>& data);
-	void writeSubtitle(const std::shared_ptr<MmtTlv::MmtStream> mmtStream, const B24SubtiteOutput& subtitle);
+	// Waits for the subtitles and SI still being converted and writes them; called at the end of the input.
+	void flush();
+	// Stops the conversion threads.
+	void release();
 
-	MmtTlv::MmtTlvDemuxer& demuxer;
+private:
+	void writeStream(const std::shared_ptr<MmtTlv::MmtStream>& mmtStream, const MmtTlv::MfuData& mfuData, const std::vector<uint8_t>& data);
+	PESPacket makeStreamPes(const std::shared_ptr<MmtTlv::MmtStream>& mmtStream, const MmtTlv::MfuData& mfuData) const;
+	uint32_t getPmtSourceCrc(const MmtTlv::Mpt& mpt) const;
+	void writeSubtitles(bool wait);
+	template<typename Table>
+	void convertSi(uint64_t sectionKey, uint64_t signature, const std::shared_ptr<Table>& table);
+	void writeSi(bool wait);
+	void writePes(uint16_t pid, const PESPacket& pes, const uint8_t* payload, size_t payloadSize, bool randomAccess);
+	template<typename PayloadWriter>
+	void writePes(uint16_t pid, const PESPacket& pes, size_t payloadSize, PayloadWriter&& writePayload, bool randomAccess);
+
+	MmtTlv::MmtTlvDemuxerBase& demuxer;
 	std::vector<uint8_t>& output;
 	std::unordered_map<uint16_t, uint16_t> mapService2Pid;
-	std::unordered_map<uint16_t, uint8_t> mapCC;
+	TsPidStateTable pidStates;
+	TsSectionScheduler sectionScheduler{pidStates, output};
+	SiConverter siConverter;
+	SiWorker siWorker;
+	std::deque<SiResult> siResults;
+	// Signature of each section on the SI worker, so a section repeated meanwhile is not queued twice
+	std::unordered_map<uint64_t, uint64_t> siInFlight;
+	std::unordered_map<uint16_t, ADTSConverter> adtsConverters;
+	// Added to the MPT version of the PMTs, raised when an audio stream switches between ADTS and LATM
+	uint8_t audioStreamTypeRevision{};
+	SubtitleWorker subtitleWorker;
+	std::deque<SubtitleResult> subtitleResults;
 	int tsid{-1};
 	int streamCount{};
 
@@ -0,0 +1,127 @@
+#include "sectionCache.h"
+#include "mmtTableBase.h"
+
+namespace MmtTlv {
+
+namespace {
+
+	uint64_t fnv1a(const uint8_t* data, size_t size)
+	{
+		uint64_t hash = 0xcbf29ce484222325;
+		for (size_t i = 0; i < size; i++) {
+			hash ^= data[i];
+			hash *= 0x100000001b3;
+		}
+		return hash;
+	}
+
+	uint64_t makeId(uint16_t packetId, uint8_t tableId, uint16_t extension, uint8_t sectionNumber)
+	{
+		return static_cast<uint64_t>(packetId) << 40 |
+			static_cast<uint64_t>(tableId) << 32 |
+			static_cast<uint64_t>(extension) << 16 |
+			sectionNumber;
+	}
+
+}
+
+bool SectionCache::readKey(uint16_t packetId, const uint8_t* data, size_t size, SectionKey& key)
+{
+	if (size < 4) {
+		return false;
+	}
+
+	uint8_t tableId = data[0];
+	switch (tableId) {
+	case MmtTableId::Mpt:
+	case MmtTableId::Plt:
+	{
+		// table_id, version, length(16)
+		size_t sectionSize = 4 + (data[2] << 8 | data[3]);
+		if (size < sectionSize) {
+			return false;
+		}
+
+		// The MMT package ID is the service ID in ARIB STD-B60, so its last two bytes tell MPTs apart
+		uint16_t extension = 0;
+		if (tableId == MmtTableId::Mpt && sectionSize >= 6) {
+			uint8_t packageIdLength = data[5];
+			if (packageIdLength >= 2 && sectionSize >= 6 + static_cast<size_t>(packageIdLength)) {
+				extension = data[6 + packageIdLength - 2] << 8 | data[6 + packageIdLength - 1];
+			}
+		}
+
+		key.id = makeId(packetId, tableId, extension, 0);
+		key.version = data[1];
+		key.checksum = fnv1a(data, sectionSize);
+		key.size = sectionSize;
+		return true;
+	}
+	case MmtTableId::MhEitPf:
+	case MmtTableId::MhEitS_0:
+	case MmtTableId::MhEitS_1:
+	case MmtTableId::MhEitS_2:
+	case MmtTableId::MhEitS_3:
+	case MmtTableId::MhEitS_4:
+	case MmtTableId::MhEitS_5:
+	case MmtTableId::MhEitS_6:
+	case MmtTableId::MhEitS_7:
+	case MmtTableId::MhEitS_8:
+	case MmtTableId::MhEitS_9:
+	case MmtTableId::MhEitS_10:
+	case MmtTableId::MhEitS_11:
+	case MmtTableId::MhEitS_12:
+	case MmtTableId::MhEitS_13:
+	case MmtTableId::MhEitS_14:
+	case MmtTableId::MhEitS_15:
+	case MmtTableId::MhSdtActual:
+	case MmtTableId::MhBit:
+	case MmtTableId::MhCdt:
+	{
+		// table_id, section_syntax_indicator + section_length(12), table_id_extension(16),
+		// version_number + current_next_indicator, section_number, ..., CRC_32
+		size_t sectionSize = 3 + ((data[1] & 0x0F) << 8 | data[2]);
+		if (sectionSize < 12 || size < sectionSize) {
+			return false;
+		}
+
+		const uint8_t* crc = data + sectionSize - 4;
+		key.id = makeId(packetId, tableId, data[3] << 8 | data[4], data[6]);
+		key.version = (data[5] & 0b00111110) >> 1;
+		key.checksum = static_cast<uint64_t>(crc[0]) << 24 | crc[1] << 16 | crc[2] << 8 | crc[3];
+		key.size = sectionSize;
+		return true;
+	}
+	default:
+		return false;
+	}
+}
+
+const std::shared_ptr<MmtTableBase>* SectionCache::find(const SectionKey& key) const
+{
+	auto it = entries.find(key.id);
+	if (it == entries.end()) {
+		return nullptr;
+	}
+
+	const Entry& entry = it->second;
+	if (entry.version != key.version || entry.checksum != key.checksum) {
+		return nullptr;
+	}
+	return &entry.table;
+}
+
+void SectionCache::store(const SectionKey& key, const std::shared_ptr<MmtTableBase>& table)
+{
+	Entry& entry = entries[key.id];
+	entry.version = key.version;
+	entry.checksum = key.checksum;
+	entry.table = table;
+}
+
+void SectionCache::clear()
+{
+	entries.clear();
+}
+
+}
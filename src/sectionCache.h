@@ -0,0 +1,42 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+
+namespace MmtTlv {
+
+class MmtTableBase;
+
+// Identity of one MMT-SI section, read from its header without unpacking it.
+// Tables with a CRC_32 (MH-EIT, MH-SDT, MH-BIT, MH-CDT) are identified by that CRC;
+// MPT and PLT carry none, so a hash of the whole section stands in for it.
+struct SectionKey {
+	uint64_t id;
+	uint8_t version;
+	uint64_t checksum;
+	size_t size;
+};
+
+// Remembers the last table unpacked for each section so that repeated, unchanged
+// sections can be recognized from their header and skipped before any allocation.
+class SectionCache {
+public:
+	// Returns false when the table is not cached or the header is incomplete.
+	static bool readKey(uint16_t packetId, const uint8_t* data, size_t size, SectionKey& key);
+
+	// Returns the table unpacked from an identical section, or nullptr.
+	const std::shared_ptr<MmtTableBase>* find(const SectionKey& key) const;
+	void store(const SectionKey& key, const std::shared_ptr<MmtTableBase>& table);
+	void clear();
+
+private:
+	struct Entry {
+		uint8_t version;
+		uint64_t checksum;
+		std::shared_ptr<MmtTableBase> table;
+	};
+
+	std::unordered_map<uint64_t, Entry> entries;
+};
+
+}
@@ -11,11 +11,10 @@ bool ServiceListDescriptor::unpack(Common::ReadStream& stream)
 
         Common::ReadStream nstream(stream, descriptorLength);
         while (!nstream.isEof()) {
-            Entry item;
+            Entry& item = services.emplace_back();
             if (!item.unpack(nstream)) {
                 return false;
             }
-            services.push_back(item);
         }
         stream.skip(descriptorLength);
 	}
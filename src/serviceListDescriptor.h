@@ -1,11 +1,14 @@
 #pragma once
 #include "tlvDescriptorBase.h"
-#include <list>
+#include <memory_resource>
+#include <vector>
 
 namespace MmtTlv {
 
 class ServiceListDescriptor : public TlvDescriptorTemplate<0x41> {
 public:
+    explicit ServiceListDescriptor(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : services(resource) {}
     bool unpack(Common::ReadStream& stream);
 
     class Entry {
@@ -15,7 +18,7 @@ public:
         uint8_t serviceType;
     };
 
-    std::list<Entry> services;
+    std::pmr::vector<Entry> services;
 };
 
 }
\ No newline at end of file
@@ -0,0 +1,386 @@
+﻿#include "siConverter.h"
+#include "contentCopyControlDescriptor.h"
+#include "mhAudioComponentDescriptor.h"
+#include "mhContentDescriptor.h"
+#include "mhEventGroupDescriptor.h"
+#include "mhExtendedEventDescriptor.h"
+#include "mhLinkageDescriptor.h"
+#include "mhLogoTransmissionDescriptor.h"
+#include "mhParentalRatingDescriptor.h"
+#include "mhSeriesDescriptor.h"
+#include "mhServiceDescriptor.h"
+#include "mhShortEventDescriptor.h"
+#include "mhSiParameterDescriptor.h"
+#include "multimediaServiceInformationDescriptor.h"
+#include "networkNameDescriptor.h"
+#include "relatedBroadcasterDescriptor.h"
+#include "serviceListDescriptor.h"
+#include "videoComponentDescriptor.h"
+#include "descriptorConverter.h"
+#include "mhBit.h"
+#include "mhCdt.h"
+#include "mhEit.h"
+#include "mhSdt.h"
+#include "mmtTableBase.h"
+#include "nit.h"
+#include "timeUtil.h"
+#include "tsPacketizer.h"
+#include <atomic>
+
+namespace {
+
+    // Instances convert on the remuxer thread and on the SI worker thread
+    std::atomic<uint64_t> droppedEventCount{0};
+    std::atomic<uint64_t> droppedServiceCount{0};
+
+    int convertRunningStatus(int runningStatus) {
+        /*
+           MMT
+           0 undefined
+           1 In non-operation
+           2 It will start within several seconds
+            (ex: video recording use)
+           3 Out of operation
+           4 In operation
+           5 – 7 Reserved for use in the future
+
+           MPEG2 TS
+           GST_MPEGTS_RUNNING_STATUS_UNDEFINED (0)
+           GST_MPEGTS_RUNNING_STATUS_NOT_RUNNING (1)
+           GST_MPEGTS_RUNNING_STATUS_STARTS_IN_FEW_SECONDS (2)
+           GST_MPEGTS_RUNNING_STATUS_PAUSING (3)
+           GST_MPEGTS_RUNNING_STATUS_RUNNING (4)
+           GST_MPEGTS_RUNNING_STATUS_OFF_AIR (5)
+       */
+
+        switch (runningStatus) {
+        case 0:
+            return 0;
+        case 1:
+            return 1;
+        case 2:
+            return 2;
+        case 3:
+            return 5;
+        case 4:
+            return 4;
+        default:
+            return 0;
+        }
+    }
+
+    uint8_t convertTableId(uint8_t mmtTableId) {
+        switch (mmtTableId) {
+        case MmtTlv::MmtTableId::Mpt:
+            return 0x02;
+        case MmtTlv::MmtTableId::Plt:
+            return 0x00;
+        case MmtTlv::MmtTableId::MhEitPf:
+            return 0x4E;
+        case MmtTlv::MmtTableId::MhEitS_0:
+        case MmtTlv::MmtTableId::MhEitS_1:
+        case MmtTlv::MmtTableId::MhEitS_2:
+        case MmtTlv::MmtTableId::MhEitS_3:
+        case MmtTlv::MmtTableId::MhEitS_4:
+        case MmtTlv::MmtTableId::MhEitS_5:
+        case MmtTlv::MmtTableId::MhEitS_6:
+        case MmtTlv::MmtTableId::MhEitS_7:
+        case MmtTlv::MmtTableId::MhEitS_8:
+        case MmtTlv::MmtTableId::MhEitS_9:
+        case MmtTlv::MmtTableId::MhEitS_10:
+        case MmtTlv::MmtTableId::MhEitS_11:
+        case MmtTlv::MmtTableId::MhEitS_12:
+        case MmtTlv::MmtTableId::MhEitS_13:
+        case MmtTlv::MmtTableId::MhEitS_14:
+        case MmtTlv::MmtTableId::MhEitS_15:
+            return 0x50;
+        case MmtTlv::MmtTableId::MhTot:
+            return 0x73;
+        case MmtTlv::MmtTableId::MhBit:
+            return 0xC4;
+        case MmtTlv::MmtTableId::MhSdtActual:
+            return 0x42;
+        case MmtTlv::MmtTableId::MhCdt:
+            return 0xC8;
+        }
+
+        return 0xFF;
+    }
+
+} // anonymous namespace
+
+std::vector<uint8_t> SiConverter::convert(const MmtTlv::MhBit& mhBit)
+{
+    ts::BIT tsBit(mhBit.versionNumber, mhBit.currentNextIndicator);
+    tsBit.original_network_id = mhBit.originalNetworkId;
+
+    // An update_time that is not a valid date drops the whole section
+    bool validTime = true;
+    mhBit.descriptors.visit([&](const MmtTlv::MhSiParameterDescriptor& mmtDescriptor) {
+        ts::SIParameterDescriptor tsDescriptor;
+        tsDescriptor.parameter_version = mmtDescriptor.parameterVersion;
+
+        struct tm tm;
+        EITDecodeMjd(mmtDescriptor.updateTime, &tm.tm_year, &tm.tm_mon, &tm.tm_mday);
+
+        try {
+            tsDescriptor.update_time = ts::Time(tm.tm_year, tm.tm_mon, tm.tm_mday, 0, 0);
+        }
+        catch (const ts::Time::TimeError&) {
+            validTime = false;
+            return;
+        }
+
+        for (const auto& entry : mmtDescriptor.entries) {
+            ts::SIParameterDescriptor::Entry tsEntry;
+            tsEntry.table_id = convertTableId(entry.tableId);
+            if (tsEntry.table_id == 0xFF) {
+                continue;
+            }
+
+            tsEntry.table_description.resize(entry.tableDescriptionByte.size());
+            memcpy(tsEntry.table_description.data(), entry.tableDescriptionByte.data(), entry.tableDescriptionByte.size());
+            tsDescriptor.entries.push_back(tsEntry);
+        }
+
+        tsBit.descs.add(duck, tsDescriptor);
+    });
+
+    if (!validTime) {
+        return {};
+    }
+
+    for (const auto& broadcaster : mhBit.broadcasters) {
+        auto& tsBroadcaster = tsBit.broadcasters[broadcaster.broadcasterId];
+
+        broadcaster.descriptors.visit(MmtTlv::Overloaded{
+            [&](const MmtTlv::RelatedBroadcasterDescriptor& mmtDescriptor) {
+                ts::ExtendedBroadcasterDescriptor tsDescriptor;
+                tsDescriptor.broadcaster_type = 1;
+                tsDescriptor.terrestrial_broadcaster_id = mhBit.originalNetworkId;
+
+                for (const auto affiliationId : mmtDescriptor.affiliationIds) {
+                    tsDescriptor.affiliation_ids.emplace_back(affiliationId);
+                }
+
+                for (const auto& broadcasterId : mmtDescriptor.broadcasterIds) {
+                    tsDescriptor.broadcasters.emplace_back(broadcasterId.networkId, broadcasterId.broadcasterId);
+                }
+
+                tsBroadcaster.descs.add(duck, tsDescriptor);
+            },
+            [&](const MmtTlv::MhSiParameterDescriptor& mmtDescriptor) {
+                ts::SIParameterDescriptor tsDescriptor;
+                tsDescriptor.parameter_version = mmtDescriptor.parameterVersion;
+
+                struct tm tm;
+                EITDecodeMjd(mmtDescriptor.updateTime, &tm.tm_year, &tm.tm_mon, &tm.tm_mday);
+
+                try {
+                    tsDescriptor.update_time = ts::Time(tm.tm_year, tm.tm_mon, tm.tm_mday, 0, 0);
+                }
+                catch (const ts::Time::TimeError&) {
+                    validTime = false;
+                    return;
+                }
+
+                for (const auto& entry : mmtDescriptor.entries) {
+                    ts::SIParameterDescriptor::Entry tsEntry;
+                    tsEntry.table_id = convertTableId(entry.tableId);
+                    if (tsEntry.table_id == 0xFF) {
+                        continue;
+                    }
+
+                    tsEntry.table_description.resize(entry.tableDescriptionByte.size());
+                    memcpy(tsEntry.table_description.data(), entry.tableDescriptionByte.data(), entry.tableDescriptionByte.size());
+                    tsDescriptor.entries.push_back(tsEntry);
+                }
+
+                tsBroadcaster.descs.add(duck, tsDescriptor);
+            },
+        });
+
+        if (!validTime) {
+            return {};
+        }
+
+        tsBit.broadcasters[broadcaster.broadcasterId] = tsBroadcaster;
+    }
+
+    ts::BinaryTable table;
+    tsBit.serialize(duck, table);
+
+    for (size_t i = 0; i < table.sectionCount(); i++) {
+        const ts::SectionPtr& section = table.sectionAt(i);
+        section->setSectionNumber(mhBit.sectionNumber);
+        section->setLastSectionNumber(mhBit.lastSectionNumber);
+    }
+
+    return packetizeTable(ts::PID_BIT, table);
+}
+
+uint8_t SiConverter::convertEitTableId(const MmtTlv::MhEit& mhEit)
+{
+    // EITs table ID range in MMT/TLV:   0x8C ~ 0x9B
+    // EITs table ID range in MPEG-2 TS: 0x50 ~ 0x5F
+    return mhEit.isPf() ? 0x4E : mhEit.getTableId() - 0x8C + 0x50;
+}
+
+SiConversionStatistics SiConverter::getStatistics()
+{
+    return SiConversionStatistics{ droppedEventCount.load(), droppedServiceCount.load() };
+}
+
+std::vector<uint8_t> SiConverter::convert(const MmtTlv::MhEit& mhEit)
+{
+    sectionWriter.begin(convertEitTableId(mhEit), mhEit.serviceId, mhEit.versionNumber, true, mhEit.sectionNumber, mhEit.lastSectionNumber);
+    sectionWriter.putUInt16(mhEit.tlvStreamId); // transport_stream_id
+    sectionWriter.putUInt16(mhEit.originalNetworkId);
+    sectionWriter.putUInt8(mhEit.segmentLastSectionNumber);
+    sectionWriter.putUInt8(mhEit.isPf() ? 0x4E : mhEit.lastTableId - 0x8C + 0x50);
+
+    for (const auto& mhEvent : mhEit.events) {
+        const size_t eventPosition = sectionWriter.size();
+
+        // start_time (MJD + BCD) and duration (BCD) have the same coding in both
+        sectionWriter.putUInt16(mhEvent.eventId);
+        sectionWriter.putUInt40(mhEvent.startTime);
+        sectionWriter.putUInt24(mhEvent.duration);
+        const size_t descriptorsPosition = sectionWriter.beginLength(
+            convertRunningStatus(mhEvent.runningStatus) << 1 | (mhEvent.freeCaMode ? 1 : 0));
+
+        mhEvent.descriptors.visit(DescriptorWriter<
+            MmtTlv::MhShortEventDescriptor,
+            MmtTlv::MhExtendedEventDescriptor,
+            MmtTlv::MhAudioComponentDescriptor,
+            MmtTlv::VideoComponentDescriptor,
+            MmtTlv::MhContentDescriptor,
+            MmtTlv::MhLinkageDescriptor,
+            MmtTlv::MhEventGroupDescriptor,
+            MmtTlv::MhParentalRatingDescriptor,
+            MmtTlv::MhSeriesDescriptor,
+            MmtTlv::ContentCopyControlDescriptor,
+            MmtTlv::MultimediaServiceInformationDescriptor
+        >(sectionWriter));
+
+        sectionWriter.endLength(descriptorsPosition);
+
+        // Events that would overflow the section are left out
+        if (!sectionWriter.fits()) {
+            sectionWriter.truncate(eventPosition);
+            droppedEventCount += mhEit.events.size() - (&mhEvent - mhEit.events.data());
+            break;
+        }
+    }
+
+    return packetizeSection(ts::PID_EIT, sectionWriter.finish());
+}
+
+std::vector<uint8_t> SiConverter::convert(const MmtTlv::MhSdt& mhSdt)
+{
+    sectionWriter.begin(0x42, mhSdt.tlvStreamId, mhSdt.versionNumber, mhSdt.currentNextIndicator, mhSdt.sectionNumber, mhSdt.lastSectionNumber);
+    sectionWriter.putUInt16(mhSdt.originalNetworkId);
+    sectionWriter.putUInt8(0xFF); // reserved_future_use
+
+    for (const auto& service : mhSdt.services) {
+        const size_t servicePosition = sectionWriter.size();
+
+        sectionWriter.putUInt16(service.serviceId);
+        sectionWriter.putUInt8(0xFC | (service.eitScheduleFlag ? 0x02 : 0x00) | (service.eitPresentFollowingFlag ? 0x01 : 0x00));
+        const size_t descriptorsPosition = sectionWriter.beginLength(
+            convertRunningStatus(service.runningStatus) << 1 | (service.freeCaMode ? 1 : 0));
+
+        service.descriptors.visit(DescriptorWriter<
+            MmtTlv::MhServiceDescriptor,
+            MmtTlv::MhLogoTransmissionDescriptor
+        >(sectionWriter));
+
+        sectionWriter.endLength(descriptorsPosition);
+
+        if (!sectionWriter.fits()) {
+            sectionWriter.truncate(servicePosition);
+            droppedServiceCount += mhSdt.services.size() - (&service - mhSdt.services.data());
+            break;
+        }
+    }
+
+    return packetizeSection(ts::PID_SDT, sectionWriter.finish());
+}
+
+std::vector<uint8_t> SiConverter::convert(const MmtTlv::MhCdt& mhCdt)
+{
+    ts::CDT cdt(mhCdt.versionNumber, mhCdt.currentNextIndicator);
+    cdt.original_network_id = mhCdt.originalNetworkId;
+    cdt.download_data_id = mhCdt.downloadDataId;
+    cdt.data_type = mhCdt.dataType;
+    cdt.data_module.resize(mhCdt.dataModuleByte.size());
+    memcpy(cdt.data_module.data(), mhCdt.dataModuleByte.data(), mhCdt.dataModuleByte.size());
+
+    ts::BinaryTable table;
+    cdt.serialize(duck, table);
+    for (size_t i = 0; i < table.sectionCount(); i++) {
+        const ts::SectionPtr& section = table.sectionAt(i);
+        section.get()->setSectionNumber(mhCdt.sectionNumber);
+        section.get()->setLastSectionNumber(mhCdt.lastSectionNumber);
+    }
+
+    return packetizeTable(ts::PID_CDT, table);
+}
+
+std::vector<uint8_t> SiConverter::convert(const MmtTlv::Nit& nit)
+{
+    ts::NIT tsNit(true, nit.versionNumber, nit.currentNextIndicator, nit.networkId);
+
+    nit.descriptors.visit([&](const MmtTlv::NetworkNameDescriptor& mmtDescriptor) {
+        auto tsDescriptor = DescriptorConverter<MmtTlv::NetworkNameDescriptor>::convert(mmtDescriptor);
+
+        tsNit.descs.add(duck, tsDescriptor);
+    });
+
+    for (const auto& item : nit.entries) {
+        ts::TransportStreamId tsid(item.tlvStreamId, item.originalNetworkId);
+        tsNit.transports[tsid];
+
+        item.descriptors.visit([&](const MmtTlv::ServiceListDescriptor& mmtDescriptor) {
+            auto tsDescriptor = DescriptorConverter<MmtTlv::ServiceListDescriptor>::convert(mmtDescriptor);
+
+            tsNit.transports[tsid].descs.add(duck, tsDescriptor);
+        });
+    }
+
+    ts::BinaryTable table;
+    tsNit.serialize(duck, table);
+    for (size_t i = 0; i < table.sectionCount(); i++) {
+        const ts::SectionPtr& section = table.sectionAt(i);
+        section->setSectionNumber(nit.sectionNumber);
+        section->setLastSectionNumber(nit.lastSectionNumber);
+    }
+
+    return packetizeTable(ts::PID_NIT, table);
+}
+
+std::vector<uint8_t> SiConverter::packetizeTable(uint16_t pid, const ts::BinaryTable& table)
+{
+    std::vector<uint8_t> packetData;
+    ts::OneShotPacketizer packetizer(duck, pid);
+
+    // Each section is flushed on its own, continuity counters are filled in when the packets are sent
+    for (size_t i = 0; i < table.sectionCount(); i++) {
+        packetizer.addSection(table.sectionAt(i));
+
+        ts::TSPacketVector packets;
+        packetizer.getPackets(packets);
+        for (auto& packet : packets) {
+            packetData.insert(packetData.end(), packet.b, packet.b + packet.getHeaderSize() + packet.getPayloadSize());
+        }
+    }
+
+    return packetData;
+}
+
+std::vector<uint8_t> SiConverter::packetizeSection(uint16_t pid, const std::vector<uint8_t>& section)
+{
+    std::vector<uint8_t> packetData;
+    TsPacketizer::writeSection(packetData, pid, section.data(), section.size());
+    return packetData;
+}
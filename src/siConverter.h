@@ -0,0 +1,46 @@
+#pragma once
+#include <tsduck.h>
+#include <cstdint>
+#include <vector>
+#include "tsSectionWriter.h"
+
+namespace MmtTlv {
+
+class MhBit;
+class MhCdt;
+class MhEit;
+class MhSdt;
+class Nit;
+
+}
+
+struct SiConversionStatistics {
+	uint64_t droppedEventCount;
+	uint64_t droppedServiceCount;
+};
+
+// Converts MMT-SI and TLV-SI tables to MPEG-2 TS sections, split into TS packets whose continuity
+// counters are filled in when they are sent. Each instance has its own tsduck context and section
+// buffer, so an instance can be used by a thread other than the remuxer's.
+class SiConverter {
+public:
+	// Each returns the packets of the converted section, or nothing if the section is dropped.
+	std::vector<uint8_t> convert(const MmtTlv::MhBit& mhBit);
+	std::vector<uint8_t> convert(const MmtTlv::MhCdt& mhCdt);
+	std::vector<uint8_t> convert(const MmtTlv::MhEit& mhEit);
+	std::vector<uint8_t> convert(const MmtTlv::MhSdt& mhSdt);
+	std::vector<uint8_t> convert(const MmtTlv::Nit& nit);
+
+	// Table ID of the EIT that an MH-EIT converts to
+	static uint8_t convertEitTableId(const MmtTlv::MhEit& mhEit);
+
+	// Events and services left out of full sections by all instances
+	static SiConversionStatistics getStatistics();
+
+	std::vector<uint8_t> packetizeTable(uint16_t pid, const ts::BinaryTable& table);
+	std::vector<uint8_t> packetizeSection(uint16_t pid, const std::vector<uint8_t>& section);
+
+private:
+	TsSectionWriter sectionWriter;
+	ts::DuckContext duck;
+};
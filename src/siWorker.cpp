@@ -0,0 +1,23 @@
+#include "siWorker.h"
+#include <exception>
+#include <iostream>
+#include "mhBit.h"
+#include "mhCdt.h"
+#include "mhEit.h"
+#include "mhSdt.h"
+#include "nit.h"
+
+std::optional<SiResult> SiWorker::convert(SiJob& job)
+{
+	SiResult result{ job.key, job.signature, {} };
+
+	try {
+		result.packets = std::visit([this](const auto& table) { return converter.convert(*table); }, job.table);
+	}
+	catch (const std::exception& e) {
+		std::cerr << "Failed to convert SI: " << e.what() << std::endl;
+	}
+
+	// An empty result still comes back, so the remuxer knows the section is no longer in flight
+	return result;
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <variant>
+#include <vector>
+#include "siConverter.h"
+#include "workerThread.h"
+
+struct SiJob {
+	using Table = std::variant<
+		std::shared_ptr<const MmtTlv::MhBit>,
+		std::shared_ptr<const MmtTlv::MhCdt>,
+		std::shared_ptr<const MmtTlv::MhEit>,
+		std::shared_ptr<const MmtTlv::MhSdt>,
+		std::shared_ptr<const MmtTlv::Nit>
+	>;
+
+	// Section key and signature in TsSectionScheduler
+	uint64_t key;
+	uint64_t signature;
+	Table table;
+};
+
+struct SiResult {
+	uint64_t key;
+	uint64_t signature;
+	std::vector<uint8_t> packets;
+};
+
+// Converts SI tables on a thread of lower priority, so that EIT schedule bursts do not hold up
+// the demuxer thread that also writes video and audio. The queue is bounded: when it is full,
+// submit refuses the table and the caller converts it inline instead.
+class SiWorker : public WorkerThread<SiJob, SiResult> {
+public:
+	static constexpr size_t kMaxQueuedJobs = 64;
+
+	SiWorker()
+		: WorkerThread([this](SiJob& job) { return convert(job); }, kMaxQueuedJobs, true) {
+	}
+
+	// The thread uses converter, so it is stopped before converter goes away
+	~SiWorker() {
+		stop();
+	}
+
+private:
+	std::optional<SiResult> convert(SiJob& job);
+
+	SiConverter converter;
+};
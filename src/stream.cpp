@@ -22,6 +22,13 @@ ReadStream::ReadStream(const std::vector<uint8_t>& buffer, uint32_t size)
     this->size = size;
 }
 
+ReadStream::ReadStream(std::span<const uint8_t> buffer)
+    : buffer(buffer)
+{
+    this->hasSize = true;
+    this->size = buffer.size();
+}
+
 ReadStream::ReadStream(ReadStream& stream, uint32_t size)
     : buffer(stream.buffer)
 {
@@ -2,6 +2,7 @@
 #include <stdexcept>
 #include <vector>
 #include <span>
+#include <string_view>
 #include <cstring>
 #include "swap.h"
 
@@ -13,6 +14,7 @@ class ReadStream final {
 public:
     explicit ReadStream(const std::vector<uint8_t>& data);
     explicit ReadStream(const std::vector<uint8_t>& data, uint32_t size);
+    explicit ReadStream(std::span<const uint8_t> data);
     explicit ReadStream(ReadStream& stream, uint32_t size);
     explicit ReadStream(ReadStream& stream);
 
@@ -25,6 +27,7 @@ public:
     bool isEof() const { return size == cur; }
     size_t leftBytes() const { return size - cur; }
     size_t getCur() const { return cur; }
+    const uint8_t* getCurrentData() const { return buffer.data() + cur; }
 
     void setCur(size_t cur) {
         if (size < cur) {
@@ -62,12 +65,23 @@ public:
     }
 
     size_t peek(std::span<uint8_t> data) {
+        return peek(data.data(), data.size());
+    }
+
+    // Views of the next size bytes. They point into the buffer being read and are valid as long as it is.
+    std::span<const uint8_t> getSpan(size_t size) {
         if (this->size < cur + size) {
             throw std::out_of_range("Access out of bounds");
         }
 
-        std::copy(buffer.begin() + cur, buffer.begin() + cur + buffer.size(), data.begin());
-        return size;
+        std::span<const uint8_t> data = buffer.subspan(cur, size);
+        cur += size;
+        return data;
+    }
+
+    std::string_view getStringView(size_t size) {
+        std::span<const uint8_t> data = getSpan(size);
+        return { reinterpret_cast<const char*>(data.data()), data.size() };
     }
 
     uint8_t get8U() {
@@ -119,7 +133,7 @@ public:
     }
 
 private:
-    const std::vector<uint8_t>& buffer;
+    std::span<const uint8_t> buffer;
     bool hasSize = false;
     mutable size_t size = 0;
     mutable size_t cur = 0;
@@ -42,6 +42,7 @@ std::optional<MfuData> SubtitleMfuDataProcessor::process(const std::shared_ptr<M
     }
 
     MfuData mfuData;
+    mfuData.data = mmtStream->getFrameBufferPool().acquire();
     mfuData.data.resize(dataSize);
     stream.read(mfuData.data.data(), dataSize);
 
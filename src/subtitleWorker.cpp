@@ -0,0 +1,49 @@
+#include "subtitleWorker.h"
+#include <exception>
+#include <iostream>
+
+namespace {
+
+	B24SubtiteOutput makeCaptionManagementData(uint64_t begin)
+	{
+		B24::CaptionManagementData captionManagementData;
+		B24::CaptionManagementData::Langage langage;
+		langage.dmf = 0b1010;
+		langage.languageCode = "jpn";
+		langage.format = 0b1000;
+
+		captionManagementData.langages.push_back(langage);
+
+		B24::DataGroup dataGroup;
+		dataGroup.setGroupData(captionManagementData);
+
+		B24::PESData pesData(dataGroup);
+		pesData.SetPESType(B24::PESData::PESType::Synchronized);
+
+		std::vector<uint8_t> packedPesData;
+		pesData.pack(packedPesData);
+
+		return B24SubtiteOutput(std::move(packedPesData), begin, 0);
+	}
+
+}
+
+std::optional<SubtitleResult> SubtitleWorker::convert(SubtitleJob& job)
+{
+	SubtitleResult result{ job.pid, job.streamId, job.pts, {} };
+
+	try {
+		B24SubtiteConvertor::convert(job.ttml, result.subtitles);
+	}
+	catch (const std::exception& e) {
+		std::cerr << "Failed to convert subtitle: " << e.what() << std::endl;
+		return std::nullopt;
+	}
+
+	if (result.subtitles.empty()) {
+		return std::nullopt;
+	}
+
+	result.subtitles.push_front(makeCaptionManagementData(result.subtitles.front().begin));
+	return result;
+}
@@ -0,0 +1,35 @@
+#pragma once
+#include <cstdint>
+#include <list>
+#include <optional>
+#include <vector>
+#include "b24SubtitleConvertor.h"
+#include "workerThread.h"
+
+struct SubtitleJob {
+	uint16_t pid;
+	uint8_t streamId;
+	uint64_t pts;
+	std::vector<uint8_t> ttml;
+};
+
+struct SubtitleResult {
+	uint16_t pid;
+	uint8_t streamId;
+	uint64_t pts;
+	// Caption management data first, then the caption statements
+	std::list<B24SubtiteOutput> subtitles;
+};
+
+// Converts TTML subtitles to B24 PES data on a thread of its own, so that parsing and ARIB encoding
+// of captions do not hold up the demuxer thread and the A/V streams written behind them.
+// Jobs are converted one at a time in submission order, so results come back in PTS order.
+class SubtitleWorker : public WorkerThread<SubtitleJob, SubtitleResult> {
+public:
+	SubtitleWorker()
+		: WorkerThread(convert) {
+	}
+
+private:
+	static std::optional<SubtitleResult> convert(SubtitleJob& job);
+};
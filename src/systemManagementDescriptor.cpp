@@ -13,8 +13,7 @@ bool SystemManagementDescriptor::unpack(Common::ReadStream& stream)
     
         systemManagementId = nstream.getBe16U();
 
-        additionalIdentificationInfo.resize(nstream.leftBytes());
-        nstream.read(additionalIdentificationInfo.data(), nstream.leftBytes());
+        additionalIdentificationInfo = nstream.getSpan(nstream.leftBytes());
 
         stream.skip(descriptorLength);
 	}
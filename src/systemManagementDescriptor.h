@@ -1,5 +1,6 @@
 #pragma once
 #include "tlvDescriptorBase.h"
+#include <span>
 #include <list>
 
 namespace MmtTlv {
@@ -9,7 +10,7 @@ public:
     bool unpack(Common::ReadStream& stream);
 
     uint16_t systemManagementId;
-    std::vector<uint8_t> additionalIdentificationInfo;
+    std::span<const uint8_t> additionalIdentificationInfo;
 };
 
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 #include "timebase.h"
 #include <climits>
 #include <stdexcept>
+#include <numeric>
 
 int64_t av_rescale_rnd(int64_t a, int64_t b, int64_t c, enum AVRounding rnd) {
     int64_t r = 0;
@@ -72,3 +73,38 @@ int64_t av_rescale_q(int64_t a, AVRational bq, AVRational cq)
 {
     return av_rescale_q_rnd(a, bq, cq, AV_ROUND_NEAR_INF);
 }
+
+Rescaler::Rescaler(int64_t b, int64_t c)
+{
+    if (b > 0 && c > 0) {
+        int64_t g = std::gcd(b, c);
+        b /= g;
+        c /= g;
+    }
+
+    this->b = b;
+    this->c = c;
+    r = c / 2;
+    fitsInt = b <= INT_MAX && c <= INT_MAX;
+}
+
+int64_t Rescaler::rescale(int64_t a) const
+{
+    if (a < 0 && a != INT64_MIN) {
+        return -rescale(-a);
+    }
+
+    if (!fitsInt) {
+        return av_rescale(a, b, c);
+    }
+
+    if (c == 0) {
+        return 0;
+    }
+
+    if (a <= INT_MAX) {
+        return (a * b + r) / c;
+    }
+
+    return a / c * b + (a % c * b + r) / c;
+}
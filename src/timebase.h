@@ -20,4 +20,20 @@ int64_t av_rescale(int64_t a, int64_t b, int64_t c);
 
 int64_t av_rescale_q_rnd(int64_t a, AVRational bq, AVRational cq, enum AVRounding rnd);
 
-int64_t av_rescale_q(int64_t a, AVRational bq, AVRational cq);
\ No newline at end of file
+int64_t av_rescale_q(int64_t a, AVRational bq, AVRational cq);
+
+// Rescales by a fixed ratio b / c with the same rounding as av_rescale().
+// The ratio is reduced once up front so that the common case never takes the 128-bit path.
+class Rescaler {
+public:
+    Rescaler() = default;
+    Rescaler(int64_t b, int64_t c);
+
+    int64_t rescale(int64_t a) const;
+
+private:
+    int64_t b{1};
+    int64_t c{1};
+    int64_t r{0};
+    bool fitsInt{true};
+};
\ No newline at end of file
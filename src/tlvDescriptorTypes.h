@@ -0,0 +1,20 @@
+#pragma once
+#include "descriptorTypeList.h"
+#include "tlvDescriptorBase.h"
+
+#include "serviceListDescriptor.h"
+#include "remoteControlKeyDescriptor.h"
+#include "networkNameDescriptor.h"
+#include "systemManagementDescriptor.h"
+
+namespace MmtTlv {
+
+// TLV-SI descriptors that can be visited; others are skipped by their length
+using TlvDescriptorTypes = DescriptorTypeList<
+	ServiceListDescriptor,
+	RemoteControlKeyDescriptor,
+	NetworkNameDescriptor,
+	SystemManagementDescriptor
+>;
+
+}
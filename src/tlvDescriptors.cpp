@@ -1,30 +1,29 @@
 #include "tlvDescriptors.h"
-#include "tlvDescriptorFactory.h"
 
 namespace MmtTlv {
 
 bool TlvDescriptors::unpack(Common::ReadStream& stream)
 {
-	list.clear();
-	while (!stream.isEof()) {
-		uint8_t descriptorTag = stream.peek8U();
-		auto it = TlvDescriptorFactory::create(descriptorTag);
-		if (it == nullptr) {
-			TlvDescriptorBase base;
-			if (!base.unpack(stream)) {
-				return false;
-			}
-			stream.skip(base.getDescriptorLength());
-		}
-		else {
- 			if (!it->unpack(stream)) {
-				return false;
-			}
-			list.push_back(std::move(it));
+	try {
+		Common::ReadStream walk(stream);
+		while (!walk.isEof()) {
+			walk.skip(peekDescriptorSize(walk));
 		}
+
+		loop = stream.getSpan(stream.leftBytes());
 	}
+	catch (const std::out_of_range&) {
+		return false;
+	}
+
 	return true;
 }
 
+size_t TlvDescriptors::peekDescriptorSize(Common::ReadStream& stream)
+{
+	Common::ReadStream header(stream);
+	header.skip(1);
+	return 2 + header.get8U();
+}
 
-}
\ No newline at end of file
+}
@@ -14,6 +14,8 @@
 #pragma once
 #include "tsCharset.h"
 
+class AribEncoder;
+
 namespace ts {
     //!
     //! Definition of the ARIB STD-B24 character set (ISDB Japan).
@@ -56,6 +58,9 @@ namespace ts {
         // Give it access to the decoding tables.
         friend class ARIBCharsetCodeGenerator;
 
+        // dantto4k: builds its direct-indexed lookup from the encoding table.
+        friend class ::AribEncoder;
+
         // Control codes. See ARIB STD-B24, part 2, table 7-14.
         static constexpr uint8_t NUL  = 0x00;
         static constexpr uint8_t BEL  = 0x07;
@@ -0,0 +1,61 @@
+#include "tsPacketizer.h"
+
+size_t TsPacketizer::writeSection(std::vector<uint8_t>& output, uint16_t pid, const uint8_t* section, size_t sectionSize)
+{
+	// The pointer_field takes the first payload byte
+	const size_t totalSize = sectionSize + 1;
+	const size_t packetCount = (totalSize + TS_PAYLOAD_SIZE - 1) / TS_PAYLOAD_SIZE;
+
+	const size_t offset = output.size();
+	output.resize(offset + packetCount * TS_PACKET_SIZE, 0xFF);
+	uint8_t* packet = output.data() + offset;
+
+	size_t written = 0;
+	for (size_t i = 0; i < packetCount; ++i) {
+		const bool first = i == 0;
+		packet[0] = 0x47;
+		packet[1] = (first ? 0x40 : 0x00) | ((pid >> 8) & 0x1F);
+		packet[2] = pid & 0xFF;
+		packet[3] = 0x10;
+
+		uint8_t* p = packet + TS_HEADER_SIZE;
+		size_t left = TS_PAYLOAD_SIZE;
+		if (first) {
+			*p++ = 0; // pointer_field
+			--left;
+		}
+
+		const size_t chunkSize = std::min(sectionSize - written, left);
+		memcpy(p, section + written, chunkSize);
+		written += chunkSize;
+
+		packet += TS_PACKET_SIZE;
+	}
+
+	return packetCount;
+}
+
+uint8_t* TsPacketizer::writeHeader(uint8_t* packet, uint16_t pid, uint8_t& continuityCounter,
+	bool pusi, bool randomAccess, size_t payloadSize)
+{
+	// Everything that is not payload goes to the adaptation field, including stuffing.
+	const size_t adaptationFieldSize = TS_PAYLOAD_SIZE - payloadSize;
+
+	packet[0] = 0x47;
+	packet[1] = (pusi ? 0x40 : 0x00) | ((pid >> 8) & 0x1F);
+	packet[2] = pid & 0xFF;
+	packet[3] = (adaptationFieldSize ? 0x30 : 0x10) | (continuityCounter & 0x0F);
+	++continuityCounter;
+
+	uint8_t* p = packet + TS_HEADER_SIZE;
+	if (adaptationFieldSize) {
+		*p++ = static_cast<uint8_t>(adaptationFieldSize - 1); // adaptation_field_length
+		if (adaptationFieldSize > 1) {
+			*p++ = randomAccess ? 0x40 : 0x00;
+			memset(p, 0xFF, adaptationFieldSize - 2);
+			p += adaptationFieldSize - 2;
+		}
+	}
+
+	return p;
+}
@@ -0,0 +1,83 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include "pesPacket.h"
+
+constexpr size_t TS_PACKET_SIZE = 188;
+constexpr size_t TS_HEADER_SIZE = 4;
+constexpr size_t TS_PAYLOAD_SIZE = TS_PACKET_SIZE - TS_HEADER_SIZE;
+
+// Packetizes PES packets directly into 188-byte TS packets appended to the output buffer.
+// The PES header and the payload are copied once, straight into their final position.
+class TsPacketizer {
+public:
+	static size_t writePes(std::vector<uint8_t>& output, uint16_t pid, uint8_t& continuityCounter,
+		const PESPacket& pes, const uint8_t* payload, size_t payloadSize, bool randomAccess = false) {
+		return writePes(output, pid, continuityCounter, pes, payloadSize,
+			[payload](uint8_t* destination, size_t offset, size_t size) { memcpy(destination, payload + offset, size); },
+			randomAccess);
+	}
+
+	// Same with the payload produced by writePayload(destination, offset, size), which writes bytes
+	// [offset, offset + size) of the payload, so a converter can write its output into the packets.
+	template<typename PayloadWriter>
+	static size_t writePes(std::vector<uint8_t>& output, uint16_t pid, uint8_t& continuityCounter,
+		const PESPacket& pes, size_t payloadSize, PayloadWriter&& writePayload, bool randomAccess = false);
+
+	// Packetizes one PSI/SI section behind a zero pointer_field, stuffed with 0xFF after its end.
+	// Continuity counters are left at 0 for the section scheduler to fill in when the packets are sent.
+	static size_t writeSection(std::vector<uint8_t>& output, uint16_t pid, const uint8_t* section, size_t sectionSize);
+
+private:
+	static uint8_t* writeHeader(uint8_t* packet, uint16_t pid, uint8_t& continuityCounter,
+		bool pusi, bool randomAccess, size_t payloadSize);
+};
+
+template<typename PayloadWriter>
+size_t TsPacketizer::writePes(std::vector<uint8_t>& output, uint16_t pid, uint8_t& continuityCounter,
+	const PESPacket& pes, size_t payloadSize, PayloadWriter&& writePayload, bool randomAccess)
+{
+	uint8_t pesHeader[PESPacket::kMaxHeaderSize];
+	const size_t pesHeaderSize = pes.packHeader(pesHeader, payloadSize);
+	const size_t totalSize = pesHeaderSize + payloadSize;
+
+	// The first packet loses 2 bytes to the adaptation field carrying random_access_indicator.
+	const size_t firstPayloadSize = TS_PAYLOAD_SIZE - (randomAccess ? 2 : 0);
+	size_t packetCount = 1;
+	if (totalSize > firstPayloadSize) {
+		packetCount += (totalSize - firstPayloadSize + TS_PAYLOAD_SIZE - 1) / TS_PAYLOAD_SIZE;
+	}
+
+	const size_t offset = output.size();
+	output.resize(offset + packetCount * TS_PACKET_SIZE);
+	uint8_t* packet = output.data() + offset;
+
+	size_t written = 0;
+	for (size_t i = 0; i < packetCount; ++i) {
+		const bool first = i == 0;
+		const size_t chunkSize = std::min(totalSize - written, first ? firstPayloadSize : TS_PAYLOAD_SIZE);
+
+		uint8_t* p = writeHeader(packet, pid, continuityCounter, first, first && randomAccess, chunkSize);
+
+		size_t left = chunkSize;
+		if (written < pesHeaderSize) {
+			const size_t headerChunk = std::min(pesHeaderSize - written, left);
+			memcpy(p, pesHeader + written, headerChunk);
+			p += headerChunk;
+			written += headerChunk;
+			left -= headerChunk;
+		}
+
+		if (left) {
+			writePayload(p, written - pesHeaderSize, left);
+			written += left;
+		}
+
+		packet += TS_PACKET_SIZE;
+	}
+
+	return packetCount;
+}
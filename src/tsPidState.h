@@ -0,0 +1,89 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+constexpr uint16_t TS_PID_COUNT = 0x2000;
+
+// Per-PID state of the TS muxer, shared by the A/V and the SI emitters.
+struct TsPidState {
+	static constexpr uint64_t kNoPcr = UINT64_MAX;
+
+	uint8_t continuityCounter{0};
+	uint64_t packetCount{0};
+	uint64_t pesCount{0};
+	uint64_t firstPcr{kNoPcr};
+	uint64_t lastPcr{kNoPcr};
+
+	bool isUsed() const { return packetCount != 0; }
+	uint64_t getByteCount() const { return packetCount * 188; }
+
+	// Average output bitrate in bits per second over the PCR span this PID has been emitted in.
+	double getBitrate() const {
+		if (firstPcr == kNoPcr || lastPcr <= firstPcr) {
+			return 0;
+		}
+		return static_cast<double>(getByteCount()) * 8 * 27000000 / static_cast<double>(lastPcr - firstPcr);
+	}
+};
+
+// Flat table of TsPidState indexed by PID, so the per-packet lookup is a single array access.
+class TsPidStateTable {
+public:
+	TsPidStateTable() : states(TS_PID_COUNT) {}
+
+	TsPidState& operator[](uint16_t pid) { return states[pid & (TS_PID_COUNT - 1)]; }
+	const TsPidState& operator[](uint16_t pid) const { return states[pid & (TS_PID_COUNT - 1)]; }
+
+	// Returns the continuity counter for the next packet on pid and accounts for it.
+	uint8_t nextContinuityCounter(uint16_t pid) {
+		TsPidState& state = (*this)[pid];
+		addPackets(state, 1);
+		return state.continuityCounter++ & 0x0F;
+	}
+
+	void addPackets(TsPidState& state, uint64_t count) {
+		state.packetCount += count;
+		if (currentPcr != TsPidState::kNoPcr) {
+			if (state.firstPcr == TsPidState::kNoPcr) {
+				state.firstPcr = currentPcr;
+			}
+			state.lastPcr = currentPcr;
+		}
+	}
+
+	void setPcr(uint64_t pcr) { currentPcr = pcr; }
+	uint64_t getPcr() const { return currentPcr; }
+
+	void clear() {
+		std::fill(states.begin(), states.end(), TsPidState{});
+		currentPcr = TsPidState::kNoPcr;
+	}
+
+	void print() const {
+		std::cerr << "TS Output:" << std::endl;
+		for (size_t pid = 0; pid < states.size(); ++pid) {
+			const TsPidState& state = states[pid];
+			if (!state.isUsed()) {
+				continue;
+			}
+
+			std::ostringstream oss;
+			oss << " - PID: 0x" << std::setw(4) << std::setfill('0') << std::hex << std::uppercase << pid << std::dec;
+			oss << ", Packets: " << state.packetCount;
+			oss << ", Bytes: " << state.getByteCount();
+			if (state.pesCount) {
+				oss << ", PES: " << state.pesCount;
+			}
+			oss << ", Bitrate: " << std::fixed << std::setprecision(1) << state.getBitrate() / 1000 << "kbps";
+			std::cerr << oss.str() << std::endl;
+		}
+	}
+
+private:
+	std::vector<TsPidState> states;
+	uint64_t currentPcr{TsPidState::kNoPcr};
+};
@@ -0,0 +1,73 @@
+#include "tsSectionScheduler.h"
+#include "tsPacketizer.h"
+
+bool TsSectionScheduler::repeat(uint64_t key, uint64_t signature, const void* source)
+{
+	auto it = entries.find(key);
+	if (it == entries.end()) {
+		return false;
+	}
+
+	Entry& entry = it->second;
+	if (entry.signature != signature || (source && entry.source.get() != source)) {
+		return false;
+	}
+
+	if (intervals[getTableId(key)] == 0) {
+		send(getPid(key), entry);
+	}
+	return true;
+}
+
+void TsSectionScheduler::update(uint64_t key, uint64_t signature, std::shared_ptr<const void> source, std::vector<uint8_t>&& packets)
+{
+	Entry& entry = entries[key];
+	entry.signature = signature;
+	entry.source = std::move(source);
+	entry.packets = std::move(packets);
+	send(getPid(key), entry);
+}
+
+void TsSectionScheduler::poll(uint64_t pcr)
+{
+	currentPcr = pcr;
+
+	for (auto& [key, entry] : entries) {
+		uint32_t interval = intervals[getTableId(key)];
+		if (interval == 0) {
+			continue;
+		}
+
+		// Also resend after the clock went backwards, e.g. on an NTP discontinuity
+		if (entry.lastSentPcr == TsPidState::kNoPcr || pcr < entry.lastSentPcr ||
+			pcr - entry.lastSentPcr >= static_cast<uint64_t>(interval) * 27000) {
+			send(getPid(key), entry);
+		}
+	}
+}
+
+void TsSectionScheduler::send(uint16_t pid, Entry& entry)
+{
+	size_t offset = output.size();
+	output.insert(output.end(), entry.packets.begin(), entry.packets.end());
+
+	for (size_t i = offset; i < output.size(); i += TS_PACKET_SIZE) {
+		uint8_t& flags = output[i + 3];
+		flags = (flags & 0xF0) | pidStates.nextContinuityCounter(pid);
+	}
+
+	entry.lastSentPcr = currentPcr;
+}
+
+void TsSectionScheduler::remove(uint16_t pid)
+{
+	auto first = entries.lower_bound(makeKey(pid, 0, 0, 0));
+	auto last = entries.lower_bound(makeKey(pid + 1, 0, 0, 0));
+	entries.erase(first, last);
+}
+
+void TsSectionScheduler::clear()
+{
+	entries.clear();
+	currentPcr = TsPidState::kNoPcr;
+}
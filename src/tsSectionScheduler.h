@@ -0,0 +1,63 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <vector>
+#include "tsPidState.h"
+
+// Cache of converted PSI/SI sections, already split into TS packets, and the scheduler that repeats them.
+// A section is converted again only when its signature (version, CRC, or the source table) changes;
+// in between, its packets are resent at the repetition interval configured for its table ID.
+class TsSectionScheduler {
+public:
+	TsSectionScheduler(TsPidStateTable& pidStates, std::vector<uint8_t>& output)
+		: pidStates(pidStates), output(output) {
+	}
+
+	static uint64_t makeKey(uint16_t pid, uint8_t tableId, uint16_t tableIdExtension, uint8_t sectionNumber) {
+		return static_cast<uint64_t>(pid) << 32 | static_cast<uint64_t>(tableId) << 24 |
+			static_cast<uint64_t>(tableIdExtension) << 8 | sectionNumber;
+	}
+
+	static uint64_t makeSignature(uint8_t version, uint32_t crc32 = 0) {
+		return static_cast<uint64_t>(crc32) << 8 | version;
+	}
+
+	// Interval between two transmissions of the same section, in milliseconds.
+	// 0 sends the cached packets each time the source section arrives again.
+	void setInterval(uint8_t tableId, uint32_t intervalMs) { intervals[tableId] = intervalMs; }
+
+	// Returns true when the cached conversion is still current, so the caller can skip converting.
+	// source identifies the unpacked table for tables that carry no CRC and may be null otherwise.
+	bool repeat(uint64_t key, uint64_t signature, const void* source = nullptr);
+
+	// Replaces the cached packets of a section and sends them right away.
+	void update(uint64_t key, uint64_t signature, std::shared_ptr<const void> source, std::vector<uint8_t>&& packets);
+
+	// Sends every section whose repetition interval has elapsed at pcr (27 MHz).
+	void poll(uint64_t pcr);
+
+	void remove(uint16_t pid);
+	void clear();
+
+private:
+	struct Entry {
+		uint64_t signature;
+		std::shared_ptr<const void> source;
+		std::vector<uint8_t> packets;
+		uint64_t lastSentPcr{TsPidState::kNoPcr};
+	};
+
+	static uint16_t getPid(uint64_t key) { return static_cast<uint16_t>(key >> 32); }
+	static uint8_t getTableId(uint64_t key) { return static_cast<uint8_t>(key >> 24); }
+
+	void send(uint16_t pid, Entry& entry);
+
+	TsPidStateTable& pidStates;
+	std::vector<uint8_t>& output;
+	// Ordered by PID, so PAT goes out ahead of NIT, SI and the PMTs within one poll
+	std::map<uint64_t, Entry> entries;
+	std::array<uint32_t, 256> intervals{};
+	uint64_t currentPcr{TsPidState::kNoPcr};
+};
@@ -0,0 +1,91 @@
+#include "tsSectionWriter.h"
+#include "crc32.h"
+
+void TsSectionWriter::begin(uint8_t tableId, uint16_t tableIdExtension, uint8_t versionNumber, bool currentNextIndicator,
+	uint8_t sectionNumber, uint8_t lastSectionNumber)
+{
+	data.clear();
+	putUInt8(tableId);
+	putUInt16(0xF000); // section_syntax_indicator, private_indicator, reserved, section_length (patched)
+	putUInt16(tableIdExtension);
+	putUInt8(0xC0 | (versionNumber & 0x1F) << 1 | (currentNextIndicator ? 1 : 0));
+	putUInt8(sectionNumber);
+	putUInt8(lastSectionNumber);
+}
+
+void TsSectionWriter::putUInt16(uint16_t value)
+{
+	data.push_back(static_cast<uint8_t>(value >> 8));
+	data.push_back(static_cast<uint8_t>(value));
+}
+
+void TsSectionWriter::putUInt24(uint32_t value)
+{
+	data.push_back(static_cast<uint8_t>(value >> 16));
+	data.push_back(static_cast<uint8_t>(value >> 8));
+	data.push_back(static_cast<uint8_t>(value));
+}
+
+void TsSectionWriter::putUInt40(uint64_t value)
+{
+	data.push_back(static_cast<uint8_t>(value >> 32));
+	data.push_back(static_cast<uint8_t>(value >> 24));
+	data.push_back(static_cast<uint8_t>(value >> 16));
+	data.push_back(static_cast<uint8_t>(value >> 8));
+	data.push_back(static_cast<uint8_t>(value));
+}
+
+void TsSectionWriter::putBytes(const void* bytes, size_t size)
+{
+	const uint8_t* p = static_cast<const uint8_t*>(bytes);
+	data.insert(data.end(), p, p + size);
+}
+
+size_t TsSectionWriter::beginLength(uint8_t highBits)
+{
+	const size_t position = data.size();
+	putUInt16(static_cast<uint16_t>(highBits & 0x0F) << 12);
+	return position;
+}
+
+void TsSectionWriter::endLength(size_t position)
+{
+	const size_t length = data.size() - position - 2;
+	data[position] = (data[position] & 0xF0) | ((length >> 8) & 0x0F);
+	data[position + 1] = static_cast<uint8_t>(length);
+}
+
+size_t TsSectionWriter::beginDescriptor(uint8_t tag)
+{
+	const size_t position = data.size();
+	putUInt8(tag);
+	putUInt8(0); // descriptor_length (patched)
+	return position;
+}
+
+bool TsSectionWriter::endDescriptor(size_t position)
+{
+	const size_t length = data.size() - position - 2;
+	if (length > 0xFF) {
+		data.resize(position);
+		return false;
+	}
+
+	data[position + 1] = static_cast<uint8_t>(length);
+	return true;
+}
+
+const std::vector<uint8_t>& TsSectionWriter::finish()
+{
+	// section_length counts everything after itself, CRC_32 included
+	const size_t sectionLength = data.size() - 3 + 4;
+	data[1] = (data[1] & 0xF0) | ((sectionLength >> 8) & 0x0F);
+	data[2] = static_cast<uint8_t>(sectionLength);
+
+	const uint32_t crc = MmtTlv::Common::crc32Mpeg2(data.data(), data.size());
+	data.push_back(static_cast<uint8_t>(crc >> 24));
+	data.push_back(static_cast<uint8_t>(crc >> 16));
+	data.push_back(static_cast<uint8_t>(crc >> 8));
+	data.push_back(static_cast<uint8_t>(crc));
+	return data;
+}
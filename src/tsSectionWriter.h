@@ -0,0 +1,46 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Writes one MPEG-2 long-form section straight into a byte buffer, without building table objects.
+// Length fields are patched in place once their content is written, and finish() appends the CRC_32.
+class TsSectionWriter {
+public:
+	// Maximum size of a private section (EIT, SDT...), header and CRC_32 included
+	static constexpr size_t kMaxSectionSize = 4096;
+
+	// Starts a new section with the private indicator set, as DVB and ARIB SI tables have it.
+	void begin(uint8_t tableId, uint16_t tableIdExtension, uint8_t versionNumber, bool currentNextIndicator,
+		uint8_t sectionNumber, uint8_t lastSectionNumber);
+
+	void putUInt8(uint8_t value) { data.push_back(value); }
+	void putUInt16(uint16_t value);
+	void putUInt24(uint32_t value);
+	void putUInt40(uint64_t value);
+	void putBytes(const void* bytes, size_t size);
+	// Overwrites a byte already written, e.g. an 8-bit length
+	void patchUInt8(size_t position, uint8_t value) { data[position] = value; }
+
+	// Reserves a 12-bit length field below 4 other bits, like descriptors_loop_length
+	// after running_status and free_CA_mode.
+	size_t beginLength(uint8_t highBits = 0xF);
+	void endLength(size_t position);
+
+	// Reserves the tag and length of a descriptor. A descriptor whose payload exceeds
+	// 255 bytes cannot be written: endDescriptor() drops it again and returns false.
+	size_t beginDescriptor(uint8_t tag);
+	bool endDescriptor(size_t position);
+
+	size_t size() const { return data.size(); }
+	// Rolls the section back to an earlier size, e.g. to drop an entry that does not fit
+	void truncate(size_t size) { data.resize(size); }
+	// True while the section, CRC_32 included, does not exceed kMaxSectionSize
+	bool fits() const { return data.size() + 4 <= kMaxSectionSize; }
+
+	// Patches section_length, appends the CRC_32 and returns the complete section.
+	const std::vector<uint8_t>& finish();
+
+private:
+	std::vector<uint8_t> data;
+};
@@ -43,53 +43,104 @@ namespace {
         return hours * 3600 * 1000ULL + minutes * 60 * 1000ULL + seconds * 1000ULL + millis;
     }
 
+    std::shared_ptr<const TTMLHead> parseHead(const pugi::xml_node& head) {
+        auto output = std::make_shared<TTMLHead>();
+
+        for (pugi::xml_node p : head.child("layout").children("region")) {
+            TTMLRegion region;
+            region.id = p.attribute("xml:id").value();
+            if (p.attribute("tts:extent")) {
+                region.extent = TTMLCssValueParser::parsePair(p.attribute("tts:extent").value());
+            }
+            if (p.attribute("tts:origin")) {
+                region.origin = TTMLCssValueParser::parsePair(p.attribute("tts:origin").value());
+            }
+            output->regions.emplace(region.id, std::move(region));
+        }
+
+        for (pugi::xml_node p : head.child("styling").children("style")) {
+            TTMLStyle style;
+            style.id = p.attribute("xml:id").value();
+            if (p.attribute("tts:fontSize")) {
+                style.fontSize = TTMLCssValueParser::parsePair(p.attribute("tts:fontSize").value());
+            }
+            if (p.attribute("tts:lineHeight")) {
+                style.lineHeight = TTMLCssValueParser::parse(p.attribute("tts:lineHeight").value());
+            }
+            if (p.attribute("tts:fontWeight")) {
+                style.fontWeight = TTMLCssValueParser::parse(p.attribute("tts:fontWeight").value());
+            }
+            if (p.attribute("tts:fontStyle")) {
+                style.fontStyle = TTMLCssValueParser::parse(p.attribute("tts:fontStyle").value());
+            }
+            if (p.attribute("tts:color")) {
+                style.color = TTMLCssValueParser::parse(p.attribute("tts:color").value());
+            }
+            if (p.attribute("tts:backgroundColor")) {
+                style.backgroundColor = TTMLCssValueParser::parse(p.attribute("tts:backgroundColor").value());
+            }
+
+            output->styles.emplace(style.id, std::move(style));
+        }
+
+        return output;
+    }
+
+    // Bytes from <head to </head>, or empty if the document has no head
+    std::string_view findHeadBytes(std::string_view document) {
+        size_t begin = document.find("<head");
+        if (begin == std::string_view::npos) {
+            return {};
+        }
+        size_t end = document.find("</head>", begin);
+        if (end == std::string_view::npos) {
+            return {};
+        }
+        return document.substr(begin, end + 7 - begin);
+    }
+
+    // Per thread, so each converting thread keeps its own head and parse buffer
+    struct ParserCache {
+        std::string headBytes;
+        std::shared_ptr<const TTMLHead> head;
+        std::vector<char> buffer;
+    };
+
+    thread_local ParserCache cache;
+
 }
 
 TTML TTMLPaser::parse(const std::vector<uint8_t>& input)
 {
     TTML output;
+
+    // pugixml parses in place, so the document is copied into a reused buffer instead of one it allocates
+    cache.buffer.assign(input.begin(), input.end());
+    std::string_view headBytes = findHeadBytes(std::string_view(cache.buffer.data(), cache.buffer.size()));
+    bool headCached = cache.head && !headBytes.empty() && headBytes == cache.headBytes;
+
+    // Copied before parsing in place overwrites the buffer
+    std::string newHeadBytes;
+    if (!headCached) {
+        newHeadBytes = headBytes;
+    }
+
     pugi::xml_document doc;
-    pugi::xml_parse_result result = doc.load_buffer(input.data(), input.size());
+    pugi::xml_parse_result result = doc.load_buffer_inplace(cache.buffer.data(), cache.buffer.size(),
+        pugi::parse_default, pugi::encoding_utf8);
     if (result.status != pugi::status_ok) {
         return {};
     }
 
-    for (pugi::xml_node p : doc.child("tt").child("head").child("layout").children("region")) {
-        TTMLRegion region;
-        region.id = p.attribute("xml:id").value();
-        if (p.attribute("tts:extent")) {
-            region.extent = TTMLCssValueParser::parsePair(p.attribute("tts:extent").value());
-        }
-        if (p.attribute("tts:origin")) {
-            region.origin = TTMLCssValueParser::parsePair(p.attribute("tts:origin").value());
-        }
-        output.regions.push_back(region);
+    // The head and its bytes are cached together once parsed, so a head that fails to parse leaves no stale pair
+    if (!headCached) {
+        std::shared_ptr<const TTMLHead> head = parseHead(doc.child("tt").child("head"));
+        cache.headBytes = std::move(newHeadBytes);
+        cache.head = std::move(head);
     }
+    output.head = cache.head;
 
-    for (pugi::xml_node p : doc.child("tt").child("head").child("styling").children("style")) {
-        TTMLStyle style;
-        style.id = p.attribute("xml:id").value();
-        if (p.attribute("tts:fontSize")) {
-            style.fontSize = TTMLCssValueParser::parsePair(p.attribute("tts:fontSize").value());
-        }
-        if (p.attribute("tts:lineHeight")) {
-            style.lineHeight = TTMLCssValueParser::parse(p.attribute("tts:lineHeight").value());
-        }
-        if (p.attribute("tts:fontWeight")) {
-            style.fontWeight = TTMLCssValueParser::parse(p.attribute("tts:fontWeight").value());
-        }
-        if (p.attribute("tts:fontStyle")) {
-            style.fontStyle = TTMLCssValueParser::parse(p.attribute("tts:fontStyle").value());
-        }
-        if (p.attribute("tts:color")) {
-            style.color = TTMLCssValueParser::parse(p.attribute("tts:color").value());
-        }
-        if (p.attribute("tts:backgroundColor")) {
-            style.backgroundColor = TTMLCssValueParser::parse(p.attribute("tts:backgroundColor").value());
-        }
-
-        output.styles.push_back(style);
-    }
+    static const TTMLRegion emptyRegion;
 
     for (pugi::xml_node div : doc.child("tt").child("body").children("div")) {
         if (!div.attribute("begin")) {
@@ -103,28 +154,23 @@ TTML TTMLPaser::parse(const std::vector<uint8_t>& input)
         }
 
         for (pugi::xml_node p : div.children("p")) {
-            std::string regionId = p.attribute("region").value();
-            auto region = std::find_if(output.regions.begin(), output.regions.end(), [regionId](const TTMLRegion& r) {
-                return r.id == regionId;
-                });
+            auto region = output.head->regions.find(std::string_view(p.attribute("region").value()));
 
-            TTMLPTag pTag;
+            TTMLPTag& pTag = divTag.pTags.emplace_back();
             pTag.id = p.attribute("xml:id").value();
-            pTag.region = *region;
+            pTag.region = region != output.head->regions.end() ? region->second : emptyRegion;
 
             for (pugi::xml_node span : p.children("span")) {
-                TTMLSpanTag spanTag;
+                TTMLSpanTag& spanTag = pTag.spanTags.emplace_back();
                 spanTag.id = span.attribute("xml:id").value();
                 spanTag.text = span.text().get();
 
-                std::string styleStr = span.attribute("style").value();
-                std::istringstream styleStream(styleStr);
-                std::string styleId;
-                while (styleStream >> styleId) {
-                    auto style = std::find_if(output.styles.begin(), output.styles.end(), [styleId](const TTMLStyle& s) {
-                        return s.id == styleId;
-                        });
-                    if (style != output.styles.end()) {
+                std::string_view styleIds = span.attribute("style").value();
+                for (std::string_view styleId = TTMLCssValueParser::nextToken(styleIds); !styleId.empty();
+                    styleId = TTMLCssValueParser::nextToken(styleIds)) {
+                    auto it = output.head->styles.find(styleId);
+                    if (it != output.head->styles.end()) {
+                        const TTMLStyle* style = &it->second;
                         if (style->fontSize.has_value()) {
                             spanTag.style.fontSize = style->fontSize;
                         }
@@ -145,14 +191,10 @@ TTML TTMLPaser::parse(const std::vector<uint8_t>& input)
                         }
                     }
                 }
-
-                pTag.spanTags.push_back(spanTag);
             }
-
-            divTag.pTags.push_back(pTag);
         }
 
-        output.divTags.push_back(divTag);
+        output.divTags.push_back(std::move(divTag));
     }
 
 	return output;
@@ -1,18 +1,20 @@
 #pragma once
+#include <charconv>
+#include <cstdint>
 #include <iostream>
 #include <string>
-#include <regex>
+#include <string_view>
 #include <stdexcept>
 #include <variant>
 #include <memory>
-#include <set>
 #include <list>
 #include <optional>
-#include <sstream>
+#include <unordered_map>
+#include <vector>
 
 class TTMLCssValueLength {
 public:
-    TTMLCssValueLength(float v, const std::string& u) : value(v), unit(u) {}
+    TTMLCssValueLength(float v, std::string_view u) : value(v), unit(u) {}
 
     float value;
     std::string unit;
@@ -23,12 +25,13 @@ class TTMLCssValueColor {
 public:
     TTMLCssValueColor(uint8_t r, uint8_t g, uint8_t b, uint8_t a) : r(r), g(g), b(b), a(a) {}
 
-    TTMLCssValueColor(const std::string& hex) {
-        if (hex.size() != 9 || hex[0] != '#') {
+    TTMLCssValueColor(std::string_view hex) {
+        uint32_t value = 0;
+        if (hex.size() != 9 || hex[0] != '#' ||
+            std::from_chars(hex.data() + 1, hex.data() + hex.size(), value, 16).ptr != hex.data() + hex.size()) {
             throw std::invalid_argument("Invalid color format. Expected format: #RRGGBBAA");
         }
 
-        unsigned long value = std::stoul(hex.substr(1), nullptr, 16);
         r = static_cast<uint8_t>((value >> 24) & 0xFF);
         g = static_cast<uint8_t>((value >> 16) & 0xFF);
         b = static_cast<uint8_t>((value >> 8) & 0xFF);
@@ -43,7 +46,7 @@ public:
 
 class TTMLCssValueKeyword {
 public:
-    TTMLCssValueKeyword(const std::string& k) : keyword(k) {}
+    TTMLCssValueKeyword(std::string_view k) : keyword(k) {}
 
     std::string keyword;
 };
@@ -81,33 +84,39 @@ public:
 
 using TTMLCssValuePair = std::pair<TTMLCssValue, TTMLCssValue>;
 
+// Scans CSS values by hand: a number with an optional px/em/rem/% unit, #RRGGBBAA or a keyword
 class TTMLCssValueParser {
 public:
-    static TTMLCssValue parse(const std::string& input) {
+    static TTMLCssValue parse(std::string_view input) {
         try {
-            if (input.find("px") != std::string::npos || input.find("em") != std::string::npos ||
-                input.find("rem") != std::string::npos || input.find("%") != std::string::npos) {
-                std::regex regex(R"(^([+-]?\d*\.?\d+)(px|em|rem|%)$)");
-                std::smatch match;
-                if (std::regex_match(input, match, regex)) {
-                    return TTMLCssValue(TTMLCssValueLength(std::stof(match[1]), match[2]));
-                }
-                else {
-                    throw std::invalid_argument("Invalid length value: " + input);
-                }
-            }
-
-            if (input.find("#") == 0) {
+            if (!input.empty() && input[0] == '#') {
                 return TTMLCssValue(TTMLCssValueColor(input));
             }
 
-            static const std::set<std::string> validKeywords = { "bold", "italic", "normal", "none" };
-            if (validKeywords.find(input) != validKeywords.end()) {
+            if (input == "bold" || input == "italic" || input == "normal" || input == "none") {
                 return TTMLCssValue(TTMLCssValueKeyword(input));
             }
 
-            return TTMLCssValue(TTMLCssValueNumber(std::stof(input)));
+            // from_chars does not take a leading '+'
+            std::string_view number = input;
+            if (!number.empty() && number[0] == '+') {
+                number.remove_prefix(1);
+            }
+
+            float value = 0;
+            auto [end, ec] = std::from_chars(number.data(), number.data() + number.size(), value, std::chars_format::fixed);
+            if (ec != std::errc()) {
+                throw std::invalid_argument("Invalid value: " + std::string(input));
+            }
 
+            std::string_view unit(end, number.data() + number.size() - end);
+            if (unit.empty()) {
+                return TTMLCssValue(TTMLCssValueNumber(value));
+            }
+            if (unit == "px" || unit == "em" || unit == "rem" || unit == "%") {
+                return TTMLCssValue(TTMLCssValueLength(value, unit));
+            }
+            throw std::invalid_argument("Invalid length value: " + std::string(input));
         }
         catch (const std::invalid_argument& e) {
             std::cerr << e.what() << std::endl;
@@ -115,17 +124,34 @@ public:
         }
     }
 
-    static TTMLCssValuePair parsePair(const std::string& input) {
-        std::istringstream iss(input);
-        std::string token1, token2;
-        if (!(iss >> token1 >> token2)) {
-            throw std::invalid_argument("Failed to parse TTML value pair from: " + input);
+    static TTMLCssValuePair parsePair(std::string_view input) {
+        std::string_view token1 = nextToken(input);
+        std::string_view token2 = nextToken(input);
+        if (token1.empty() || token2.empty()) {
+            throw std::invalid_argument("Failed to parse TTML value pair from: " + std::string(input));
         }
         TTMLCssValue value1 = parse(token1);
         TTMLCssValue value2 = parse(token2);
         return std::make_pair(value1, value2);
     }
 
+    // Takes the next whitespace separated token from input; empty at the end
+    static std::string_view nextToken(std::string_view& input) {
+        constexpr std::string_view whitespace = " \t\r\n";
+        size_t begin = input.find_first_not_of(whitespace);
+        if (begin == std::string_view::npos) {
+            input = {};
+            return {};
+        }
+        size_t end = input.find_first_of(whitespace, begin);
+        if (end == std::string_view::npos) {
+            end = input.size();
+        }
+        std::string_view token = input.substr(begin, end - begin);
+        input.remove_prefix(end);
+        return token;
+    }
+
 };
 
 class TTMLRegion {
@@ -167,11 +193,26 @@ public:
     std::list<TTMLPTag> pTags;
 };
 
+// Regions and styles of <head>, looked up by xml:id.
+// ARIB TTML repeats the same head in every document, so the parser shares it between documents.
+class TTMLHead {
+public:
+    struct IdHash {
+        using is_transparent = void;
+        size_t operator()(std::string_view id) const { return std::hash<std::string_view>{}(id); }
+    };
+
+    template<typename T>
+    using IdMap = std::unordered_map<std::string, T, IdHash, std::equal_to<>>;
+
+    IdMap<TTMLRegion> regions;
+    IdMap<TTMLStyle> styles;
+};
+
 class TTML {
 public:
     std::list<TTMLDivTag> divTags;
-    std::list<TTMLRegion> regions;
-    std::list<TTMLStyle> styles;
+    std::shared_ptr<const TTMLHead> head;
 
 };
 
@@ -27,8 +27,7 @@ bool VideoComponentDescriptor::unpack(Common::ReadStream& stream)
 
         size_t textLength = nstream.leftBytes();
         if (textLength) {
-            text.resize(textLength);
-            nstream.read(text.data(), textLength);
+            text = nstream.getStringView(textLength);
         }
 
         stream.skip(descriptorLength);
@@ -1,5 +1,6 @@
 #pragma once
 #include "mmtDescriptorBase.h"
+#include <string_view>
 
 namespace MmtTlv {
 
@@ -17,7 +18,7 @@ public:
     uint16_t componentTag;
     uint8_t videoTransferCharacteristics;
     char language[4];
-    std::string text;
+    std::string_view text;
 
 
 };
@@ -1,10 +1,93 @@
 #include "videoMfuDataProcessor.h"
+#include <algorithm>
 #include "stream.h"
 
 namespace MmtTlv {
 
-constexpr uint8_t CRA_NUT = 0x15;
+constexpr uint8_t BLA_W_LP = 0x10;
+constexpr uint8_t RSV_IRAP_VCL23 = 0x17;
+constexpr uint8_t VPS_NUT = 0x20;
+constexpr uint8_t SPS_NUT = 0x21;
+constexpr uint8_t PPS_NUT = 0x22;
 constexpr uint8_t NAL_AUD = 0x23;
+constexpr uint8_t PREFIX_SEI_NUT = 0x27;
+
+namespace {
+
+    // Index into the parameter set cache: VPS, SPS, PPS, then HDR SEI, which other non-VCL NAL units are ranked with
+    constexpr size_t kSeiIndex = 3;
+
+    size_t getParameterSetIndex(int nalUnitType)
+    {
+        switch (nalUnitType) {
+        case VPS_NUT:   return 0;
+        case SPS_NUT:   return 1;
+        case PPS_NUT:   return 2;
+        default:        return kSeiIndex;
+        }
+    }
+
+    // BLA, IDR and CRA pictures, and the reserved IRAP types
+    bool isIrap(int nalUnitType)
+    {
+        return nalUnitType >= BLA_W_LP && nalUnitType <= RSV_IRAP_VCL23;
+    }
+
+    // True if every message of the SEI NAL unit describes HDR: mastering display colour volume,
+    // content light level or alternative transfer characteristics
+    bool isHdrSei(const uint8_t* nal, size_t size)
+    {
+        size_t i = 2;
+        int zeroCount = 0;
+        auto readByte = [&](uint8_t& value) {
+            // emulation_prevention_three_byte
+            if (zeroCount >= 2 && i < size && nal[i] == 0x03) {
+                i++;
+                zeroCount = 0;
+            }
+            if (i >= size) {
+                return false;
+            }
+            value = nal[i++];
+            zeroCount = value == 0 ? zeroCount + 1 : 0;
+            return true;
+        };
+
+        bool hasMessage = false;
+        while (!(i + 1 == size && nal[i] == 0x80)) {
+            uint8_t value;
+            uint32_t payloadType = 0;
+            do {
+                if (!readByte(value)) {
+                    return false;
+                }
+                payloadType += value;
+            } while (value == 0xFF);
+
+            uint32_t payloadSize = 0;
+            do {
+                if (!readByte(value)) {
+                    return false;
+                }
+                payloadSize += value;
+            } while (value == 0xFF);
+
+            if (payloadType != 137 && payloadType != 144 && payloadType != 147) {
+                return false;
+            }
+
+            for (uint32_t j = 0; j < payloadSize; j++) {
+                if (!readByte(value)) {
+                    return false;
+                }
+            }
+            hasMessage = true;
+        }
+
+        return hasMessage;
+    }
+
+}
 
 std::optional<MfuData> VideoMfuDataProcessor::process(const std::shared_ptr<MmtStream>& mmtStream, const std::vector<uint8_t>& data)
 {
@@ -25,27 +108,44 @@ std::optional<MfuData> VideoMfuDataProcessor::process(const std::shared_ptr<MmtS
     }
     
     int nalUnitType = ((uint8 >> 1) & 0b111111);
-    
+
+    if (nalUnitType == NAL_AUD) {
+        accessUnitHasSlice = false;
+    }
+
+    // The first slice of a random access picture must find the parameter sets before it
+    if (nalUnitType < 0x20 && !accessUnitHasSlice) {
+        if (isIrap(nalUnitType)) {
+            insertParameterSets();
+        }
+        accessUnitHasSlice = true;
+    }
+
+    size_t nalOffset = pendingData.size();
     appendPendingData(stream, size);
 
+    if (nalUnitType == NAL_AUD) {
+        parameterSetPosition = pendingData.size();
+    }
+    else {
+        cacheParameterSet(nalUnitType, nalOffset);
+    }
+
     if (nalUnitType < 0x20) {
         if (sliceSegmentCount >= (mmtStream->Is8KVideo() ? 3 : 0)) {
-            std::pair<int64_t, int64_t> ptsDts;
-            try {
-                ptsDts = mmtStream->getNextPtsDts();
-            }
-            catch (const std::out_of_range&) {
+            MfuData mfuData;
+            if (!assignNextTimestamp(*mmtStream, mfuData)) {
                 pendingData.clear();
+                endAccessUnit();
                 return std::nullopt;
             }
 
-            MfuData mfuData;
             mfuData.data = std::move(pendingData);
-            mfuData.pts = ptsDts.first;
-            mfuData.dts = ptsDts.second;
+            pendingData = mmtStream->getFrameBufferPool().acquire();
+            endAccessUnit();
             mfuData.streamIndex = mmtStream->getStreamIndex();
             
-            if (nalUnitType == CRA_NUT) {
+            if (isIrap(nalUnitType)) {
                 mfuData.keyframe = true;
             }
 
@@ -72,4 +172,56 @@ void VideoMfuDataProcessor::appendPendingData(Common::ReadStream& stream, int si
     stream.read(pendingData.data() + oldSize + 4, size);
 }
 
-}
\ No newline at end of file
+void VideoMfuDataProcessor::cacheParameterSet(int nalUnitType, size_t nalOffset)
+{
+    size_t index = getParameterSetIndex(nalUnitType);
+    if (index == kSeiIndex) {
+        if (nalUnitType != PREFIX_SEI_NUT ||
+            !isHdrSei(pendingData.data() + nalOffset + 4, pendingData.size() - nalOffset - 4)) {
+            return;
+        }
+    }
+
+    // An access unit may carry several of a kind, such as PPSs with different IDs; all of them are kept
+    CachedParameterSet& parameterSet = parameterSets[index];
+    if (!parameterSet.inAccessUnit) {
+        parameterSet.data.clear();
+        parameterSet.inAccessUnit = true;
+    }
+    parameterSet.data.insert(parameterSet.data.end(), pendingData.begin() + nalOffset, pendingData.end());
+}
+
+void VideoMfuDataProcessor::endAccessUnit()
+{
+    parameterSetPosition = 0;
+    for (auto& parameterSet : parameterSets) {
+        parameterSet.inAccessUnit = false;
+    }
+}
+
+void VideoMfuDataProcessor::insertParameterSets()
+{
+    // Only non-VCL NAL units are pending here, so this moves a few bytes at most
+    const size_t start = std::min(parameterSetPosition, pendingData.size());
+    for (size_t index = 0; index < parameterSets.size(); index++) {
+        const CachedParameterSet& parameterSet = parameterSets[index];
+        if (parameterSet.inAccessUnit || parameterSet.data.empty()) {
+            continue;
+        }
+
+        // In front of the first NAL unit of a later kind, so that an SPS carried by the access unit
+        // still comes before the cached PPSs that refer to it
+        size_t position = pendingData.size();
+        for (size_t i = start; i + 4 < pendingData.size(); i++) {
+            if (pendingData[i] == 0 && pendingData[i + 1] == 0 && pendingData[i + 2] == 0 && pendingData[i + 3] == 1 &&
+                getParameterSetIndex((pendingData[i + 4] >> 1) & 0b111111) > index) {
+                position = i;
+                break;
+            }
+        }
+
+        pendingData.insert(pendingData.begin() + position, parameterSet.data.begin(), parameterSet.data.end());
+    }
+}
+
+}
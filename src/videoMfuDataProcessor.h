@@ -1,4 +1,5 @@
 #pragma once
+#include <array>
 #include "mfuDataProcessorBase.h"
 
 namespace MmtTlv {
@@ -9,10 +10,26 @@ public:
 
 private:
 	void appendPendingData(Common::ReadStream& stream, int size);
+	void cacheParameterSet(int nalUnitType, size_t nalOffset);
+	void insertParameterSets();
+	// Called once pendingData has been handed on or dropped
+	void endAccessUnit();
 
 	std::vector<uint8_t> pendingData;
 	int sliceSegmentCount = 0;
 
+	// VPS, SPS, PPS and HDR SEI NAL units with start codes, as carried by the latest access unit that had them.
+	// They are put in front of random access pictures that come without them, so that decoding can start there.
+	struct CachedParameterSet {
+		std::vector<uint8_t> data;
+		// Carried by the current access unit, which replaces the cached one
+		bool inAccessUnit = false;
+	};
+	std::array<CachedParameterSet, 4> parameterSets;
+	// Where parameter sets go in pendingData: behind the access unit delimiter
+	size_t parameterSetPosition = 0;
+	bool accessUnitHasSlice = false;
+
 };
 
-}
\ No newline at end of file
+}
@@ -0,0 +1,20 @@
+#include "workerThread.h"
+#ifdef _WIN32
+#include <windows.h>
+#endif
+#ifdef __linux__
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+void lowerCurrentThreadPriority()
+{
+#ifdef _WIN32
+	SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_BELOW_NORMAL);
+#endif
+#ifdef __linux__
+	// On Linux the nice value applies to the thread given by its thread ID
+	setpriority(PRIO_PROCESS, static_cast<id_t>(syscall(SYS_gettid)), 10);
+#endif
+}
@@ -0,0 +1,135 @@
+#pragma once
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+// Lowers the scheduling priority of the calling thread below that of the demuxer thread.
+void lowerCurrentThreadPriority();
+
+// Runs jobs one at a time on a thread of its own and hands their results back in submission order.
+// The thread is started by the first job and stopped by stop(), which owners call before the process
+// unloads rather than leaving it to a static destructor.
+template<typename Job, typename Result>
+class WorkerThread {
+public:
+	// Returns the result of a job, or nothing if the job gives no output
+	using Process = std::function<std::optional<Result>(Job& job)>;
+
+	// maxQueuedJobs of 0 leaves the queue unbounded.
+	explicit WorkerThread(Process process, size_t maxQueuedJobs = 0, bool lowPriority = false)
+		: process(std::move(process)), maxQueuedJobs(maxQueuedJobs), lowPriority(lowPriority) {
+	}
+
+	~WorkerThread() {
+		stop();
+	}
+
+	WorkerThread(const WorkerThread&) = delete;
+	WorkerThread& operator=(const WorkerThread&) = delete;
+
+	// Queues a job; false if the queue is full and the job was not taken.
+	bool submit(Job&& job) {
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			if (maxQueuedJobs != 0 && jobs.size() >= maxQueuedJobs) {
+				return false;
+			}
+			if (!thread.joinable()) {
+				stopping = false;
+				thread = std::thread(&WorkerThread::run, this);
+			}
+			jobs.push_back(std::move(job));
+			++pendingCount;
+		}
+		jobReady.notify_one();
+		return true;
+	}
+
+	// Moves out the results so far in submission order.
+	// With wait set, blocks until every submitted job is done.
+	void takeResults(std::deque<Result>& output, bool wait) {
+		std::unique_lock<std::mutex> lock(mutex);
+		if (wait) {
+			jobDone.wait(lock, [this] { return pendingCount == 0; });
+		}
+		output.swap(results);
+		results.clear();
+	}
+
+	// Drops queued jobs and results that were not taken yet.
+	void discard() {
+		std::lock_guard<std::mutex> lock(mutex);
+		pendingCount -= jobs.size();
+		jobs.clear();
+		results.clear();
+		++generation;
+	}
+
+	void stop() {
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			if (!thread.joinable()) {
+				return;
+			}
+			stopping = true;
+		}
+		jobReady.notify_one();
+		thread.join();
+
+		std::lock_guard<std::mutex> lock(mutex);
+		pendingCount = 0;
+		jobs.clear();
+		results.clear();
+		jobDone.notify_all();
+	}
+
+private:
+	void run() {
+		if (lowPriority) {
+			lowerCurrentThreadPriority();
+		}
+
+		std::unique_lock<std::mutex> lock(mutex);
+		while (true) {
+			jobReady.wait(lock, [this] { return stopping || !jobs.empty(); });
+			if (stopping) {
+				return;
+			}
+
+			Job job = std::move(jobs.front());
+			jobs.pop_front();
+			const uint64_t jobGeneration = generation;
+
+			lock.unlock();
+			std::optional<Result> result = process(job);
+			lock.lock();
+
+			if (jobGeneration == generation && result) {
+				results.push_back(std::move(*result));
+			}
+			--pendingCount;
+			jobDone.notify_all();
+		}
+	}
+
+	Process process;
+	size_t maxQueuedJobs;
+	bool lowPriority;
+
+	std::mutex mutex;
+	std::condition_variable jobReady;
+	std::condition_variable jobDone;
+	std::deque<Job> jobs;
+	std::deque<Result> results;
+	// Queued jobs plus the one being processed
+	size_t pendingCount{};
+	// Bumped by discard so that a job processed meanwhile is not delivered
+	uint64_t generation{};
+	bool stopping{};
+	std::thread thread;
+};
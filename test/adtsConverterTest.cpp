@@ -0,0 +1,223 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+#include "adtsConverter.h"
+
+// Converts LOAS frames built here field by field, and checks the ADTS headers and the
+// program_config_element of 22.2ch against values worked out from ISO/IEC 14496-3 and 13818-7.
+
+namespace {
+
+    int failures = 0;
+
+    class BitWriter {
+    public:
+        void put(uint32_t value, int bits) {
+            while (bits--) {
+                if (position % 8 == 0) {
+                    bytes.push_back(0);
+                }
+                if ((value >> bits) & 1) {
+                    bytes.back() |= 0x80 >> (position % 8);
+                }
+                position++;
+            }
+        }
+
+        std::vector<uint8_t> bytes;
+
+    private:
+        size_t position{ 0 };
+    };
+
+    struct LoasFixture {
+        int channelConfiguration;
+        std::vector<std::vector<uint8_t>> payloads;
+    };
+
+    // AAC LC at 48 kHz, one program and layer, with a CRC and without other data
+    std::vector<uint8_t> loasFrame(const LoasFixture& fixture)
+    {
+        BitWriter writer;
+        writer.put(0, 1); // useSameStreamMux
+        writer.put(0, 1); // audioMuxVersion
+        writer.put(1, 1); // allStreamsSameTimeFraming
+        writer.put(static_cast<uint32_t>(fixture.payloads.size() - 1), 6); // numSubFrames
+        writer.put(0, 4); // numProgram
+        writer.put(0, 3); // numLayer
+        writer.put(2, 5); // audioObjectType: AAC LC
+        writer.put(3, 4); // samplingFrequencyIndex: 48 kHz
+        writer.put(fixture.channelConfiguration, 4);
+        writer.put(0, 1); // frameLengthFlag
+        writer.put(0, 1); // dependsOnCoreCoder
+        writer.put(0, 1); // extensionFlag
+        writer.put(0, 3); // frameLengthType
+        writer.put(0xFF, 8); // latmBufferFullness
+        writer.put(0, 1); // otherDataPresent
+        writer.put(1, 1); // crcCheckPresent
+        writer.put(0x5A, 8); // crcCheckSum
+
+        for (const auto& payload : fixture.payloads) {
+            size_t length = payload.size();
+            for (; length >= 255; length -= 255) {
+                writer.put(255, 8);
+            }
+            writer.put(static_cast<uint32_t>(length), 8);
+
+            for (uint8_t byte : payload) {
+                writer.put(byte, 8);
+            }
+        }
+
+        std::vector<uint8_t> frame;
+        frame.push_back(0x2B7 >> 3);
+        frame.push_back(static_cast<uint8_t>((0x2B7 & 0b111) << 5 | writer.bytes.size() >> 8));
+        frame.push_back(static_cast<uint8_t>(writer.bytes.size()));
+        frame.insert(frame.end(), writer.bytes.begin(), writer.bytes.end());
+        return frame;
+    }
+
+    std::vector<uint8_t> payload(size_t size, uint8_t seed)
+    {
+        std::vector<uint8_t> bytes(size);
+        for (size_t i = 0; i < size; i++) {
+            bytes[i] = static_cast<uint8_t>(seed + i * 7);
+        }
+        return bytes;
+    }
+
+    // ID_PCE and program_config_element of 22.2ch for AAC LC at 48 kHz: 7 front, 3 side, 4 back
+    // and 2 LFE elements, byte aligned, without a comment
+    const std::vector<uint8_t> k22_2chPce = {
+        0xA0, 0x9B, 0x9A, 0x40, 0x00, 0x21, 0x11, 0x50, 0xB7, 0x95, 0x47, 0x30, 0xD8, 0x80, 0x20, 0x00,
+    };
+
+    void fail(const char* name, const char* what)
+    {
+        std::printf("%s: %s\n", name, what);
+        failures++;
+    }
+
+    void check(const char* name, const LoasFixture& fixture)
+    {
+        const std::vector<uint8_t> input = loasFrame(fixture);
+        ADTSConverter converter;
+        if (!converter.unpack(input.data(), input.size())) {
+            fail(name, "frame not unpacked");
+            return;
+        }
+
+        const size_t pceSize = fixture.channelConfiguration == 13 ? k22_2chPce.size() : 0;
+        std::vector<uint8_t> expected;
+        for (const auto& payload : fixture.payloads) {
+            const size_t frameLength = 7 + pceSize + payload.size();
+            const int channelConfiguration = fixture.channelConfiguration == 13 ? 0 : fixture.channelConfiguration;
+
+            BitWriter header;
+            header.put(0xFFF, 12); // syncword
+            header.put(0, 1); // ID: MPEG-4
+            header.put(0, 2); // layer
+            header.put(1, 1); // protection_absent
+            header.put(1, 2); // profile: AAC LC
+            header.put(3, 4); // sampling_frequency_index
+            header.put(1, 1); // private_bit
+            header.put(channelConfiguration, 3);
+            header.put(1, 1); // original_copy
+            header.put(1, 1); // home
+            header.put(1, 1); // copyright_identification_bit
+            header.put(1, 1); // copyright_identification_start
+            header.put(static_cast<uint32_t>(frameLength), 13);
+            header.put(0x7FF, 11); // adts_buffer_fullness
+            header.put(0, 2); // number_of_raw_data_blocks_in_frame
+
+            expected.insert(expected.end(), header.bytes.begin(), header.bytes.end());
+            if (pceSize) {
+                expected.insert(expected.end(), k22_2chPce.begin(), k22_2chPce.end());
+            }
+            expected.insert(expected.end(), payload.begin(), payload.end());
+        }
+
+        if (converter.getOutputSize() != expected.size()) {
+            std::printf("%s: %zu bytes, expected %zu bytes\n", name, converter.getOutputSize(), expected.size());
+            failures++;
+            return;
+        }
+
+        std::vector<uint8_t> actual(expected.size());
+        converter.write(actual.data(), 0, actual.size());
+        for (size_t i = 0; i < expected.size(); i++) {
+            if (actual[i] != expected[i]) {
+                std::printf("%s: first difference at byte %zu: %02X, expected %02X\n", name, i, actual[i], expected[i]);
+                failures++;
+                return;
+            }
+        }
+
+        // TS packets take the frames in pieces of any size
+        for (size_t chunk : { 1, 7, 13, 184 }) {
+            std::vector<uint8_t> pieces(expected.size());
+            for (size_t offset = 0; offset < pieces.size(); offset += chunk) {
+                converter.write(pieces.data() + offset, offset, std::min(chunk, pieces.size() - offset));
+            }
+            if (pieces != expected) {
+                fail(name, "frames written in pieces differ");
+                return;
+            }
+        }
+    }
+
+    void checkUnsupported(const char* name, const LoasFixture& fixture)
+    {
+        ADTSConverter converter;
+        const std::vector<uint8_t> supported = loasFrame({ 2, { payload(100, 1) } });
+        const std::vector<uint8_t> input = loasFrame(fixture);
+
+        if (converter.unpack(input.data(), input.size()) || converter.isMuxConfigSupported()) {
+            fail(name, "StreamMuxConfig not refused");
+        }
+        if (converter.unpack(input.data(), input.size()) || converter.isMuxConfigSupported()) {
+            fail(name, "StreamMuxConfig not refused again");
+        }
+
+        // A supported StreamMuxConfig that follows is converted again
+        if (!converter.unpack(supported.data(), supported.size()) || !converter.isMuxConfigSupported()) {
+            fail(name, "supported StreamMuxConfig refused afterwards");
+        }
+    }
+
+}
+
+int main()
+{
+    check("mono", { 1, { payload(200, 1) } });
+    check("stereo", { 2, { payload(255, 2) } });
+    check("5.1ch", { 6, { payload(600, 3) } });
+    check("7.1ch", { 7, { payload(1, 4) } });
+    check("22.2ch", { 13, { payload(1500, 5) } });
+    check("2 subframes", { 2, { payload(300, 6), payload(17, 7) } });
+    check("22.2ch, 2 subframes", { 13, { payload(510, 8), payload(0, 9) } });
+
+    checkUnsupported("channelConfiguration 0", { 0, { payload(100, 1) } });
+    for (int channelConfiguration = 8; channelConfiguration <= 15; channelConfiguration++) {
+        if (channelConfiguration != 13) {
+            checkUnsupported("channelConfiguration 8-15", { channelConfiguration, { payload(100, 1) } });
+        }
+    }
+
+    // Frames that are merely broken leave the StreamMuxConfig as it was
+    ADTSConverter converter;
+    std::vector<uint8_t> broken = loasFrame({ 2, { payload(100, 1) } });
+    broken[0] ^= 0x01;
+    if (converter.unpack(broken.data(), broken.size()) || !converter.isMuxConfigSupported()) {
+        fail("broken sync word", "frame not refused, or StreamMuxConfig refused");
+    }
+
+    if (failures) {
+        std::printf("adtsConverterTest: %d failures\n", failures);
+        return 1;
+    }
+
+    std::printf("adtsConverterTest: passed\n");
+    return 0;
+}
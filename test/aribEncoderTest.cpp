@@ -0,0 +1,295 @@
+#include <tsduck.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "aribEncoder.h"
+#include "tsARIBCharset.h"
+
+// Compares AribEncoder with the encoder it replaced: gaiji substituted in the UTF-8 bytes,
+// then ts::UString::FromUTF8() and ts::ARIBCharset2::B24.
+
+namespace {
+
+    int failures = 0;
+
+    struct Gaiji {
+        const char* find;
+        const char* replacement;
+    };
+
+    // The substitutions of the replaced encoder, in its order
+    const Gaiji gaijiTable[] = {
+        // ARIB STD-B62
+        { "\U0001F19B", "[3D]" },
+        { "\U0001F19C", "[2nd Scr]" },
+        { "\U0001F19D", "[2K]" },
+        { "\U0001F19E", "[4K]" },
+        { "\U0001F19F", "[8K]" },
+        { "\U0001F1A0", "[5.1]" },
+        { "\U0001F1A1", "[7.1]" },
+        { "\U0001F1A2", "[22.2]" },
+        { "\U0001F1A3", "[60P]" },
+        { "\U0001F1A4", "[120P]" },
+        { "\U0001F1A5", "[\U0000FF44]" },
+        { "\U0001F1A6", "[HC]" },
+        { "\U0001F1A7", "[HDR]" },
+        { "\U0001F1A8", "[Hi-Res]" },
+        { "\U0001F1A9", "[Lossless]" },
+        { "\U0001F1AA", "[SHV]" },
+        { "\U0001F1AB", "[UHD]" },
+        { "\U0001F1AC", "[VOD]" },
+        { "\U0001F23B", "[\U0000914D]" },
+        { "\U000032FF", "\U00004EE4\U0000548C" },
+
+        // ARIB STD-B24 (Table 7-11 Addtional Kanji Characters)
+        { "\U00004EFF", "\U00005F77" },
+        { "\U0000509C", "\U00005FAD" },
+        { "\U0000FA6B", "\U00006075" },
+        { "\U00006CE0", "\U000051B7" },
+        { "\U0000FA4A", "\U00007422" },
+        { "\U00007575", "\U0000756B" },
+        { "\U0000FA6D", "\U00008218" },
+        { "\U000087EC", "\U00008749" },
+        { "\U00009DD7", "\U00009D0E" },
+        { "\U00009EB4", "\U00009EB9" },
+        { "\U00009EB5", "\U00009EBA" },
+        { "\U00009AD9", "\U00009AD8" },
+        { "\U0000FA10", "\U0000585A" },
+        { "\U0000FA11", "\U000057FC" },
+        { "\U0000FA45", "\U00006D77" },
+        { "\U0000FA46", "\U00006E1A" },
+        { "\U0000F9B6", "\U000079AE" },
+        { "\U00002F93", "\U000089D2" },
+    };
+
+    ts::UString substitute(std::string_view input)
+    {
+        std::string str(input);
+        for (const auto& gaiji : gaijiTable) {
+            const std::string_view find = gaiji.find;
+            size_t pos = 0;
+            while ((pos = str.find(find, pos)) != std::string::npos) {
+                str.replace(pos, find.size(), gaiji.replacement);
+                pos += 1;
+            }
+        }
+        return ts::UString::FromUTF8(str.data(), str.size());
+    }
+
+    // Code point as UTF-8, without checking that it is a valid scalar value
+    void appendUtf8(std::string& str, char32_t codePoint)
+    {
+        if (codePoint < 0x80) {
+            str += static_cast<char>(codePoint);
+        }
+        else if (codePoint < 0x800) {
+            str += static_cast<char>(0xC0 | codePoint >> 6);
+            str += static_cast<char>(0x80 | (codePoint & 0x3F));
+        }
+        else if (codePoint < 0x10000) {
+            str += static_cast<char>(0xE0 | codePoint >> 12);
+            str += static_cast<char>(0x80 | (codePoint >> 6 & 0x3F));
+            str += static_cast<char>(0x80 | (codePoint & 0x3F));
+        }
+        else {
+            str += static_cast<char>(0xF0 | codePoint >> 18);
+            str += static_cast<char>(0x80 | (codePoint >> 12 & 0x3F));
+            str += static_cast<char>(0x80 | (codePoint >> 6 & 0x3F));
+            str += static_cast<char>(0x80 | (codePoint & 0x3F));
+        }
+    }
+
+    void printBytes(const char* label, const uint8_t* data, size_t size)
+    {
+        std::printf("  %s:", label);
+        for (size_t i = 0; i < size; i++) {
+            std::printf(" %02X", data[i]);
+        }
+        std::printf("\n");
+    }
+
+    void report(const char* name, std::string_view input, const uint8_t* actual, size_t actualSize,
+        const uint8_t* expected, size_t expectedSize)
+    {
+        if (failures < 20) {
+            std::printf("%s: mismatch\n", name);
+            printBytes("input", reinterpret_cast<const uint8_t*>(input.data()), input.size());
+            printBytes("got", actual, actualSize);
+            printBytes("expected", expected, expectedSize);
+        }
+        failures++;
+    }
+
+    // Whole strings, with the output size limit of ts::Charset::encoded()
+    void check(const char* name, std::string_view input)
+    {
+        const ts::ByteBlock actual = AribEncoder::encode(input);
+        const ts::ByteBlock expected = ts::ARIBCharset2::B24.encoded(substitute(input));
+        if (actual != expected) {
+            report(name, input, actual.data(), actual.size(), expected.data(), expected.size());
+        }
+    }
+
+    // Every output buffer size up to the full encoding, where encoding stops at the first character that does not fit
+    void checkTruncation(const char* name, std::string_view input)
+    {
+        const ts::UString str = substitute(input);
+        const size_t fullSize = AribEncoder::getMaxEncodedSize(input.size());
+
+        for (size_t bufferSize = 0; bufferSize <= fullSize; bufferSize++) {
+            std::vector<uint8_t> actual(bufferSize + 1);
+            const size_t actualSize = AribEncoder::encode(input, actual.data(), bufferSize);
+
+            std::vector<uint8_t> expected(bufferSize + 1);
+            uint8_t* buffer = expected.data();
+            size_t left = bufferSize;
+            ts::ARIBCharset2::B24.encode(buffer, left, str);
+            const size_t expectedSize = bufferSize - left;
+
+            if (actualSize != expectedSize || !std::equal(actual.begin(), actual.begin() + actualSize, expected.begin())) {
+                std::printf("%s: buffer of %zu bytes\n", name, bufferSize);
+                report(name, input, actual.data(), actualSize, expected.data(), expectedSize);
+                return;
+            }
+        }
+    }
+
+}
+
+int main()
+{
+    check("empty", "");
+    check("ASCII", "Hello, World! 0123456789 ~\\|{}");
+    check("NUL", std::string_view("a\0b", 3));
+    check("hiragana", "\U00003042\U00003044\U00003046\U00003048\U0000304A\U00003093");
+    check("katakana", "\U000030A2\U000030A4\U000030A6\U000030F4\U000030FC");
+    check("half-width katakana", "\U0000FF71\U0000FF72\U0000FF9E\U0000FF9F\U0000FF61");
+    check("kanji", "\U00006771\U00004EAC\U00005927\U00005B66");
+    check("full-width", "\U0000FF21\U0000FF22\U0000FF10\U0000FF11\U0000FF01");
+    check("mixed", "NHK\U000030CB\U000030E5\U000030FC\U000030B9 7\U00006642 ABC\U00003042a\U00006F22b");
+
+    // Spaces take the size of the characters around them
+    check("spaces", " a b  c ");
+    check("ideographic spaces", "\U00003000\U00003042\U00003000\U00003000\U00006F22\U00003000");
+    check("spaces between sets", "a \U00003042 \U00003000b\U00003000 \U000030A2 1");
+
+    // Every gaiji on its own and between other characters
+    for (const auto& gaiji : gaijiTable) {
+        check("gaiji", gaiji.find);
+        check("gaiji in text", std::string("a") + gaiji.find + "\U00003042" + gaiji.find + gaiji.find + " ");
+    }
+    std::string allGaiji;
+    for (const auto& gaiji : gaijiTable) {
+        allGaiji += gaiji.find;
+    }
+    check("all gaiji", allGaiji);
+
+    // Outside the BMP: surrogate pairs, and surrogates encoded on their own (CESU-8) that tsduck pairs again
+    check("supplementary", "a\U00020158b\U0001F600c");
+    std::string surrogates = "a";
+    appendUtf8(surrogates, 0xD840);
+    appendUtf8(surrogates, 0xDD58);
+    surrogates += "b";
+    appendUtf8(surrogates, 0xD83C);
+    appendUtf8(surrogates, 0xDD9B);
+    appendUtf8(surrogates, 0xDC00);
+    surrogates += "c";
+    appendUtf8(surrogates, 0xD800);
+    check("lone surrogates", surrogates);
+
+    // Malformed UTF-8: stray continuation bytes, invalid lead bytes, overlong and truncated sequences,
+    // and gaiji bytes inside broken sequences
+    check("stray continuation", "a\x80\xBF" "b");
+    check("invalid lead", "a\xF8\xFC\xFE\xFF" "b");
+    check("overlong", "a\xC0\xAF\xE0\x80\xAF" "b");
+    check("truncated 2 bytes", "a\xC3");
+    check("truncated 3 bytes", "a\xE3\x81");
+    check("truncated 4 bytes", "a\xF0\x9F\x86");
+    check("truncated before text", "\xE3\x81" "abc");
+    check("gaiji after broken lead", "\xE3\xF0\x9F\x86\x9B" "a");
+    check("gaiji split by lead", "\xE4\xBB" "\xE4\xBB\xBF" "b");
+
+    // Output size limits: the 4 bytes per UTF-16 unit of ts::Charset::encoded(), and caller buffers
+    // (36 bytes for 6 characters, so the encoding stops at 24 bytes)
+    check("designations past 4 bytes per unit", "\U00002116\U00002192\U00002460\U00003000\U00002460\U00006F22");
+    checkTruncation("truncated designations", "\U00002116\U00002192\U00002460\U00003000\U00002460\U00006F22");
+    checkTruncation("truncated ASCII", "Hello, World!");
+    checkTruncation("truncated mixed", "NHK\U000030CB\U000030E5\U000030FC\U000030B9 7\U00006642\U00003000\U0000FF71a\U00006F22");
+    checkTruncation("truncated gaiji", "\U0001F19E\U0001F1A5\U000032FF\U00004EFF a");
+    checkTruncation("truncated surrogates", surrogates);
+
+    // Random strings from the sets above, valid and malformed
+    std::vector<char32_t> pool;
+    for (char32_t c = 0x20; c < 0x7F; c++) {
+        pool.push_back(c);
+    }
+    for (char32_t c = 0x3000; c < 0x3100; c++) {
+        pool.push_back(c);
+    }
+    for (char32_t c = 0x4E00; c < 0x5000; c++) {
+        pool.push_back(c);
+    }
+    for (char32_t c = 0xFF00; c < 0xFFF0; c++) {
+        pool.push_back(c);
+    }
+    for (char32_t c : { 0x00, 0x5C, 0x7E, 0xA5, 0x203E, 0x2460, 0x20158, 0x1F100, 0x1F200 }) {
+        pool.push_back(c);
+    }
+    std::vector<char32_t> gaijiCodePoints;
+    for (const auto& gaiji : gaijiTable) {
+        std::u16string codePoint = ts::UString::FromUTF8(gaiji.find, std::string_view(gaiji.find).size());
+        gaijiCodePoints.push_back(codePoint.size() == 2 ? 0x10000 + ((codePoint[0] & 0x3FF) << 10 | (codePoint[1] & 0x3FF)) : codePoint[0]);
+        pool.push_back(gaijiCodePoints.back());
+    }
+
+    std::mt19937 random(20261018);
+    for (int i = 0; i < 200000; i++) {
+        const bool malformed = i % 2 != 0;
+        const size_t length = random() % 40;
+
+        std::string input;
+        for (size_t j = 0; j < length; j++) {
+            if (!malformed || random() % 4 != 0) {
+                appendUtf8(input, pool[random() % pool.size()]);
+                continue;
+            }
+
+            switch (random() % 4) {
+            case 0:
+                input += static_cast<char>(random() % 0x100);
+                break;
+            case 1:
+                appendUtf8(input, 0xD800 + random() % 0x800);
+                break;
+            case 2:
+            {
+                // The first bytes of a gaiji
+                std::string gaiji;
+                appendUtf8(gaiji, gaijiCodePoints[random() % gaijiCodePoints.size()]);
+                input += gaiji.substr(0, 1 + random() % (gaiji.size() - 1));
+                break;
+            }
+            default:
+                appendUtf8(input, gaijiCodePoints[random() % gaijiCodePoints.size()]);
+                break;
+            }
+        }
+
+        check(malformed ? "random malformed" : "random", input);
+        if (i % 1000 == 0) {
+            checkTruncation(malformed ? "random malformed truncated" : "random truncated", input);
+        }
+    }
+
+    if (failures) {
+        std::printf("aribEncoderTest: %d failures\n", failures);
+        return 1;
+    }
+
+    std::printf("aribEncoderTest: passed\n");
+    return 0;
+}
@@ -0,0 +1,109 @@
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <utility>
+#include <vector>
+#include "b24Color.h"
+
+namespace {
+
+    int failures = 0;
+
+    // Exact search by 64-bit squared distance; the first of equally close entries wins
+    std::pair<uint8_t, uint8_t> bruteForceClosestColor(const ColorRGBA& color)
+    {
+        std::pair<uint8_t, uint8_t> closest{ 0, 0 };
+        int64_t closestDistance = INT64_MAX;
+        for (int palette = 0; palette < 8; palette++) {
+            for (int index = 0; index < 16; index++) {
+                const ColorRGBA& entry = getB24Color(palette, index);
+                int64_t r = int64_t{ color.r } - entry.r;
+                int64_t g = int64_t{ color.g } - entry.g;
+                int64_t b = int64_t{ color.b } - entry.b;
+                int64_t a = int64_t{ color.a } - entry.a;
+                int64_t distance = r * r + g * g + b * b + a * a;
+                if (distance < closestDistance) {
+                    closestDistance = distance;
+                    closest = { static_cast<uint8_t>(palette), static_cast<uint8_t>(index) };
+                }
+            }
+        }
+        return closest;
+    }
+
+    void check(const ColorRGBA& color)
+    {
+        auto expected = bruteForceClosestColor(color);
+        auto actual = findClosestColor(color);
+        if (actual != expected) {
+            if (failures < 20) {
+                std::printf("RGBA(%d, %d, %d, %d): got %d/%d, expected %d/%d\n", color.r, color.g, color.b, color.a,
+                    actual.first, actual.second, expected.first, expected.second);
+            }
+            failures++;
+        }
+    }
+
+    // Slot of the resolved color memo in b24Color.cpp
+    uint32_t cacheSlot(const ColorRGBA& color)
+    {
+        uint32_t key = static_cast<uint32_t>(color.r) << 24 | static_cast<uint32_t>(color.g) << 16 |
+            static_cast<uint32_t>(color.b) << 8 | color.a;
+        return (key * 0x9E3779B1u) >> 26;
+    }
+
+}
+
+int main()
+{
+    // Every CLUT entry, including the duplicates, which must resolve to their first occurrence
+    for (int palette = 0; palette < 8; palette++) {
+        for (int index = 0; index < 16; index++) {
+            check(getB24Color(palette, index));
+        }
+    }
+
+    // Colors far from the CLUT, where the old unsigned differences wrapped around
+    const uint8_t levels[] = { 0, 1, 42, 43, 84, 85, 86, 127, 128, 129, 169, 170, 171, 212, 213, 254, 255 };
+    for (uint8_t r : levels) {
+        for (uint8_t g : levels) {
+            for (uint8_t b : levels) {
+                for (uint8_t a : levels) {
+                    check(ColorRGBA(r, g, b, a));
+                }
+            }
+        }
+    }
+
+    std::mt19937 random(20261018);
+    std::uniform_int_distribution<int> component(0, 255);
+    auto randomColor = [&] {
+        return ColorRGBA(component(random), component(random), component(random), component(random));
+    };
+
+    for (int i = 0; i < 200000; i++) {
+        check(randomColor());
+    }
+
+    // Colors sharing a memo slot, looked up in turns so that each evicts the other
+    for (int i = 0; i < 1000; i++) {
+        ColorRGBA first = randomColor();
+        ColorRGBA second = randomColor();
+        while (cacheSlot(second) != cacheSlot(first) ||
+            (second.r == first.r && second.g == first.g && second.b == first.b && second.a == first.a)) {
+            second = randomColor();
+        }
+        for (int round = 0; round < 3; round++) {
+            check(first);
+            check(second);
+        }
+    }
+
+    if (failures) {
+        std::printf("b24ColorTest: %d failures\n", failures);
+        return 1;
+    }
+
+    std::printf("b24ColorTest: passed\n");
+    return 0;
+}
@@ -0,0 +1,803 @@
+#include <tsduck.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include "aribUtil.h"
+#include "contentCopyControlDescriptor.h"
+#include "crc32.h"
+#include "descriptorConverter.h"
+#include "mhAudioComponentDescriptor.h"
+#include "mhContentDescriptor.h"
+#include "mhEit.h"
+#include "mhExtendedEventDescriptor.h"
+#include "mhLinkageDescriptor.h"
+#include "mhLogoTransmissionDescriptor.h"
+#include "mhParentalRatingDescriptor.h"
+#include "mhSdt.h"
+#include "mhSeriesDescriptor.h"
+#include "mhServiceDescriptor.h"
+#include "mhShortEventDescriptor.h"
+#include "siConverter.h"
+#include "timeUtil.h"
+#include "videoComponentDescriptor.h"
+
+// Serializes MH-EIT and MH-SDT fixtures with SiConverter and with the tsduck tables it replaced,
+// and compares the sections byte for byte.
+// The reference keeps the ARIB text bytes as they are: each byte goes through tsduck as one character
+// of RawCharset, so that only the layout of the tables and descriptors is compared.
+
+namespace {
+
+    int failures = 0;
+
+    class RawCharset : public ts::Charset {
+    public:
+        RawCharset() : ts::Charset({ u"DANTTO4K-TEST-RAW" }) {}
+
+        bool decode(ts::UString& str, const uint8_t* data, size_t size) const override
+        {
+            str.clear();
+            for (size_t i = 0; i < size; i++) {
+                str.push_back(data[i]);
+            }
+            return true;
+        }
+
+        bool canEncode(const ts::UString& str, size_t start, size_t count) const override
+        {
+            return true;
+        }
+
+        size_t encode(uint8_t*& buffer, size_t& size, const ts::UString& str, size_t start, size_t count) const override
+        {
+            start = std::min(start, str.size());
+            count = std::min({ count, str.size() - start, size });
+            for (size_t i = 0; i < count; i++) {
+                *buffer++ = static_cast<uint8_t>(str[start + i]);
+            }
+            size -= count;
+            return count;
+        }
+    };
+
+    const RawCharset rawCharset;
+
+    ts::UString rawString(const ts::ByteBlock& bytes)
+    {
+        ts::UString str;
+        for (const uint8_t byte : bytes) {
+            str.push_back(byte);
+        }
+        return str;
+    }
+
+    ts::UString aribString(std::string_view text)
+    {
+        return rawString(aribEncode(text));
+    }
+
+    // Fixture building
+
+    void put8(std::vector<uint8_t>& out, uint32_t value)
+    {
+        out.push_back(static_cast<uint8_t>(value));
+    }
+
+    void put16(std::vector<uint8_t>& out, uint32_t value)
+    {
+        put8(out, value >> 8);
+        put8(out, value);
+    }
+
+    void put24(std::vector<uint8_t>& out, uint32_t value)
+    {
+        put8(out, value >> 16);
+        put16(out, value);
+    }
+
+    void put40(std::vector<uint8_t>& out, uint64_t value)
+    {
+        put8(out, static_cast<uint32_t>(value >> 32));
+        put16(out, static_cast<uint32_t>(value >> 16));
+        put16(out, static_cast<uint32_t>(value));
+    }
+
+    void putBytes(std::vector<uint8_t>& out, std::string_view bytes)
+    {
+        out.insert(out.end(), bytes.begin(), bytes.end());
+    }
+
+    void putBytes(std::vector<uint8_t>& out, const std::vector<uint8_t>& bytes)
+    {
+        out.insert(out.end(), bytes.begin(), bytes.end());
+    }
+
+    std::vector<uint8_t> descriptor(uint16_t tag, const std::vector<uint8_t>& payload, bool is16BitLength = false)
+    {
+        std::vector<uint8_t> out;
+        put16(out, tag);
+        if (is16BitLength) {
+            put16(out, static_cast<uint32_t>(payload.size()));
+        }
+        else {
+            put8(out, static_cast<uint32_t>(payload.size()));
+        }
+        putBytes(out, payload);
+        return out;
+    }
+
+    // Fills in section_length and appends CRC_32
+    std::vector<uint8_t> finishSection(std::vector<uint8_t> section)
+    {
+        const size_t sectionLength = section.size() - 3 + 4;
+        section[1] = static_cast<uint8_t>(0xF0 | sectionLength >> 8);
+        section[2] = static_cast<uint8_t>(sectionLength);
+
+        uint32_t crc = MmtTlv::Common::crc32Mpeg2(section.data(), section.size());
+        put16(section, crc >> 16);
+        put16(section, crc);
+        return section;
+    }
+
+    std::vector<uint8_t> shortEvent(std::string_view name, std::string_view text)
+    {
+        std::vector<uint8_t> payload;
+        putBytes(payload, "jpn");
+        put8(payload, static_cast<uint32_t>(name.size()));
+        putBytes(payload, name);
+        put16(payload, static_cast<uint32_t>(text.size()));
+        putBytes(payload, text);
+        return descriptor(MmtTlv::MhShortEventDescriptor::kDescriptorTag, payload, true);
+    }
+
+    std::vector<uint8_t> extendedEvent(const std::vector<std::pair<std::string_view, std::string_view>>& items, std::string_view text)
+    {
+        std::vector<uint8_t> itemBytes;
+        for (const auto& [description, item] : items) {
+            put8(itemBytes, static_cast<uint32_t>(description.size()));
+            putBytes(itemBytes, description);
+            put16(itemBytes, static_cast<uint32_t>(item.size()));
+            putBytes(itemBytes, item);
+        }
+
+        std::vector<uint8_t> payload;
+        put8(payload, 0x01); // descriptor_number 0, last_descriptor_number 1
+        putBytes(payload, "jpn");
+        put16(payload, static_cast<uint32_t>(itemBytes.size()));
+        putBytes(payload, itemBytes);
+        put16(payload, static_cast<uint32_t>(text.size()));
+        putBytes(payload, text);
+        return descriptor(MmtTlv::MhExtendedEventDescriptor::kDescriptorTag, payload, true);
+    }
+
+    std::vector<uint8_t> audioComponent(bool multiLingual, std::string_view text)
+    {
+        std::vector<uint8_t> payload;
+        put8(payload, 0xF2); // stream_content: audio
+        put8(payload, multiLingual ? 0x02 : 0x03); // dual mono or stereo
+        put16(payload, multiLingual ? 0x0011 : 0x0010); // component_tag
+        put8(payload, 0x11); // stream_type: LATM/LOAS
+        put8(payload, multiLingual ? 0x01 : 0xFF); // simulcast_group_tag
+        put8(payload, (multiLingual ? 0x80 : 0x00) | 0x40 | 0x30 | 0b111 << 1); // main component, 48 kHz
+        putBytes(payload, "jpn");
+        if (multiLingual) {
+            putBytes(payload, "eng");
+        }
+        putBytes(payload, text);
+        return descriptor(MmtTlv::MhAudioComponentDescriptor::kDescriptorTag, payload);
+    }
+
+    std::vector<uint8_t> videoComponent(std::string_view text)
+    {
+        std::vector<uint8_t> payload;
+        put8(payload, 6 << 4 | 3); // 2160p, 16:9
+        put8(payload, 1 << 7 | 0x08); // progressive, 59.94 Hz
+        put16(payload, 0x0000); // component_tag
+        put8(payload, 3 << 4); // video_transfer_characteristics
+        putBytes(payload, "jpn");
+        putBytes(payload, text);
+        return descriptor(MmtTlv::VideoComponentDescriptor::kDescriptorTag, payload);
+    }
+
+    std::vector<uint8_t> content()
+    {
+        std::vector<uint8_t> payload;
+        put16(payload, 0x0000); // news
+        put16(payload, 0xE012);
+        return descriptor(MmtTlv::MhContentDescriptor::kDescriptorTag, payload);
+    }
+
+    std::vector<uint8_t> parentalRating()
+    {
+        std::vector<uint8_t> payload;
+        putBytes(payload, "JPN");
+        put8(payload, 0x04);
+        return descriptor(MmtTlv::MhParentalRatingDescriptor::kDescriptorTag, payload);
+    }
+
+    std::vector<uint8_t> series(bool expireDateValid, std::string_view name)
+    {
+        std::vector<uint8_t> payload;
+        put16(payload, 0x1234); // series_id
+        put8(payload, 0x2 << 4 | 0x1 << 1 | (expireDateValid ? 1 : 0));
+        put16(payload, expireDateValid ? 61400 : 0xFFFF); // expire_date (MJD)
+        put24(payload, 5 << 12 | 12); // episode 5 of 12
+        putBytes(payload, name);
+        return descriptor(MmtTlv::MhSeriesDescriptor::kDescriptorTag, payload);
+    }
+
+    std::vector<uint8_t> contentCopyControl()
+    {
+        std::vector<uint8_t> payload;
+        put8(payload, 0b10 << 6 | 0x20 | 0x0F); // maximum_bitrate_flag, no components
+        put8(payload, 0x64);
+        return descriptor(MmtTlv::ContentCopyControlDescriptor::kDescriptorTag, payload);
+    }
+
+    std::vector<uint8_t> linkage()
+    {
+        std::vector<uint8_t> payload;
+        put16(payload, 0x000B); // tlv_stream_id
+        put16(payload, 0x000B); // original_network_id
+        put16(payload, 0x0065); // service_id
+        put8(payload, 0x0E);
+        return descriptor(MmtTlv::MhLinkageDescriptor::kDescriptorTag, payload);
+    }
+
+    std::vector<uint8_t> service(std::string_view providerName, std::string_view serviceName)
+    {
+        std::vector<uint8_t> payload;
+        put8(payload, 0x01);
+        put8(payload, static_cast<uint32_t>(providerName.size()));
+        putBytes(payload, providerName);
+        put8(payload, static_cast<uint32_t>(serviceName.size()));
+        putBytes(payload, serviceName);
+        return descriptor(MmtTlv::MhServiceDescriptor::kDescriptorTag, payload);
+    }
+
+    std::vector<uint8_t> logoTransmission(uint8_t type)
+    {
+        std::vector<uint8_t> payload;
+        put8(payload, type);
+        if (type == 0x01) {
+            put16(payload, 0xFE00 | 0x0012); // logo_id
+            put16(payload, 0xF000 | 0x0003); // logo_version
+            put16(payload, 0x0021); // download_data_id
+            put24(payload, 0x050001); // logo_type, start_section_number, num_of_sections
+        }
+        else if (type == 0x02) {
+            put16(payload, 0xFE00 | 0x0012);
+        }
+        else {
+            putBytes(payload, "ABC");
+        }
+        return descriptor(MmtTlv::MhLogoTransmissionDescriptor::kDescriptorTag, payload);
+    }
+
+    struct EventFixture {
+        uint16_t eventId;
+        uint64_t startTime; // MJD and BCD time
+        uint32_t duration; // BCD
+        uint8_t runningStatus;
+        bool freeCaMode;
+        std::vector<std::vector<uint8_t>> descriptors;
+    };
+
+    std::vector<uint8_t> mhEitSection(uint8_t tableId, uint8_t lastTableId, const std::vector<EventFixture>& events)
+    {
+        std::vector<uint8_t> section;
+        put8(section, tableId);
+        put16(section, 0); // section_length (filled in)
+        put16(section, 0x0065); // service_id
+        put8(section, 0xC0 | 7 << 1 | 1); // version_number 7, current_next_indicator
+        put8(section, tableId == MmtTlv::MmtTableId::MhEitPf ? 0x00 : 0x18); // section_number
+        put8(section, tableId == MmtTlv::MmtTableId::MhEitPf ? 0x01 : 0xF8); // last_section_number
+        put16(section, 0x000B); // tlv_stream_id
+        put16(section, 0x000B); // original_network_id
+        put8(section, tableId == MmtTlv::MmtTableId::MhEitPf ? 0x01 : 0x18); // segment_last_section_number
+        put8(section, lastTableId);
+
+        for (const auto& event : events) {
+            std::vector<uint8_t> loop;
+            for (const auto& descriptor : event.descriptors) {
+                putBytes(loop, descriptor);
+            }
+
+            put16(section, event.eventId);
+            put40(section, event.startTime);
+            put24(section, event.duration);
+            put16(section, event.runningStatus << 13 | (event.freeCaMode ? 1 : 0) << 12 | static_cast<uint32_t>(loop.size()));
+            putBytes(section, loop);
+        }
+
+        return finishSection(section);
+    }
+
+    struct ServiceFixture {
+        uint16_t serviceId;
+        bool eitScheduleFlag;
+        uint8_t runningStatus;
+        bool freeCaMode;
+        std::vector<std::vector<uint8_t>> descriptors;
+    };
+
+    std::vector<uint8_t> mhSdtSection(const std::vector<ServiceFixture>& services)
+    {
+        std::vector<uint8_t> section;
+        put8(section, MmtTlv::MmtTableId::MhSdtActual);
+        put16(section, 0); // section_length (filled in)
+        put16(section, 0x000B); // tlv_stream_id
+        put8(section, 0xC0 | 3 << 1 | 1); // version_number 3, current_next_indicator
+        put8(section, 0x00); // section_number
+        put8(section, 0x00); // last_section_number
+        put16(section, 0x000B); // original_network_id
+        put8(section, 0xFF); // reserved_future_use
+
+        for (const auto& service : services) {
+            std::vector<uint8_t> loop;
+            for (const auto& descriptor : service.descriptors) {
+                putBytes(loop, descriptor);
+            }
+
+            put16(section, service.serviceId);
+            put8(section, 0xE0 | (service.eitScheduleFlag ? 0x02 : 0x00) | 0x01);
+            put16(section, service.runningStatus << 13 | (service.freeCaMode ? 1 : 0) << 12 | static_cast<uint32_t>(loop.size()));
+            putBytes(section, loop);
+        }
+
+        return finishSection(section);
+    }
+
+    // Reference serialization, as the remuxer did it with tsduck
+
+    int convertRunningStatus(int runningStatus)
+    {
+        static const int statuses[] = { 0, 1, 2, 5, 4 };
+        return runningStatus < 5 ? statuses[runningStatus] : 0;
+    }
+
+    ts::ByteBlock shortEventReference(const MmtTlv::MhShortEventDescriptor& mmtDescriptor)
+    {
+        const ts::ByteBlock eventName = aribEncode(mmtDescriptor.eventName);
+        const ts::ByteBlock text = aribEncode(mmtDescriptor.text);
+
+        ts::ByteBlock tsDescriptor;
+        tsDescriptor.appendUInt8(0x4D);
+        tsDescriptor.appendUInt8(static_cast<uint8_t>(3 + 1 + eventName.size() + 1 + text.size()));
+        tsDescriptor.append(mmtDescriptor.language, 3);
+        tsDescriptor.appendUInt8(static_cast<uint8_t>(eventName.size()));
+        tsDescriptor.append(eventName);
+        tsDescriptor.appendUInt8(static_cast<uint8_t>(text.size()));
+        tsDescriptor.append(text);
+        return tsDescriptor;
+    }
+
+    ts::ByteBlock extendedEventReference(const MmtTlv::MhExtendedEventDescriptor& mmtDescriptor)
+    {
+        ts::ByteBlock items;
+        for (const auto& entry : mmtDescriptor.entries) {
+            const ts::ByteBlock itemDescription = aribEncode(entry.itemDescriptionChar);
+            const ts::ByteBlock item = aribEncode(entry.itemChar);
+            items.appendUInt8(static_cast<uint8_t>(itemDescription.size()));
+            items.append(itemDescription);
+            items.appendUInt8(static_cast<uint8_t>(item.size()));
+            items.append(item);
+        }
+        const ts::ByteBlock text = aribEncode(mmtDescriptor.textChar);
+
+        ts::ByteBlock tsDescriptor;
+        tsDescriptor.appendUInt8(0x4E);
+        tsDescriptor.appendUInt8(static_cast<uint8_t>(1 + 3 + 1 + items.size() + 1 + text.size()));
+        tsDescriptor.appendUInt8((mmtDescriptor.descriptorNumber & 0x0F) << 4 | (mmtDescriptor.lastDescriptorNumber & 0x0F));
+        tsDescriptor.append(mmtDescriptor.language, 3);
+        tsDescriptor.appendUInt8(static_cast<uint8_t>(items.size()));
+        tsDescriptor.append(items);
+        tsDescriptor.appendUInt8(static_cast<uint8_t>(text.size()));
+        tsDescriptor.append(text);
+        return tsDescriptor;
+    }
+
+    ts::ByteBlock eitReference(ts::DuckContext& duck, const MmtTlv::MhEit& mhEit)
+    {
+        ts::EIT tsEit(true, mhEit.isPf(), 0, mhEit.versionNumber, true, mhEit.serviceId, mhEit.tlvStreamId, mhEit.originalNetworkId);
+        for (const auto& mhEvent : mhEit.events) {
+            ts::EIT::Event tsEvent(&tsEit);
+
+            struct tm startTime = EITConvertStartTime(mhEvent.startTime);
+            tsEvent.start_time = ts::Time(startTime.tm_year + 1900, startTime.tm_mon + 1, startTime.tm_mday,
+                startTime.tm_hour, startTime.tm_min, startTime.tm_sec);
+            tsEvent.duration = std::chrono::seconds(EITConvertDuration(mhEvent.duration));
+            tsEvent.running_status = convertRunningStatus(mhEvent.runningStatus);
+            tsEvent.CA_controlled = mhEvent.freeCaMode;
+            tsEvent.event_id = mhEvent.eventId;
+
+            mhEvent.descriptors.visit(MmtTlv::Overloaded{
+                [&](const MmtTlv::MhShortEventDescriptor& mmtDescriptor) {
+                    const ts::ByteBlock tsDescriptor = shortEventReference(mmtDescriptor);
+                    tsEvent.descs.add(tsDescriptor.data(), tsDescriptor.size());
+                },
+                [&](const MmtTlv::MhExtendedEventDescriptor& mmtDescriptor) {
+                    const ts::ByteBlock tsDescriptor = extendedEventReference(mmtDescriptor);
+                    tsEvent.descs.add(tsDescriptor.data(), tsDescriptor.size());
+                },
+                [&](const MmtTlv::MhAudioComponentDescriptor& mmtDescriptor) {
+                    ts::AudioComponentDescriptor tsDescriptor;
+                    tsDescriptor.stream_content = 2;
+                    tsDescriptor.component_type = convertAudioComponentType(mmtDescriptor.componentType);
+                    tsDescriptor.component_tag = static_cast<uint8_t>(mmtDescriptor.componentTag);
+                    tsDescriptor.stream_type = 0x0F;
+                    tsDescriptor.simulcast_group_tag = mmtDescriptor.simulcastGroupTag;
+                    if (mmtDescriptor.esMultiLingualFlag) {
+                        tsDescriptor.ISO_639_language_code_2 = ts::UString::FromUTF8(mmtDescriptor.language2);
+                    }
+                    tsDescriptor.main_component = mmtDescriptor.mainComponentFlag;
+                    tsDescriptor.quality_indicator = mmtDescriptor.qualityIndicator;
+                    tsDescriptor.sampling_rate = convertAudioSamplingRate(mmtDescriptor.samplingRate);
+                    tsDescriptor.ISO_639_language_code = ts::UString::FromUTF8(mmtDescriptor.language1);
+                    tsDescriptor.text = aribString(mmtDescriptor.text);
+                    tsEvent.descs.add(duck, tsDescriptor);
+                },
+                [&](const MmtTlv::VideoComponentDescriptor& mmtDescriptor) {
+                    ts::ComponentDescriptor tsDescriptor;
+                    tsDescriptor.stream_content = 1;
+                    tsDescriptor.component_type = convertVideoComponentType(mmtDescriptor.videoResolution, mmtDescriptor.videoAspectRatio);
+                    tsDescriptor.language_code = ts::UString::FromUTF8(mmtDescriptor.language);
+                    tsDescriptor.text = aribString(mmtDescriptor.text);
+                    tsEvent.descs.add(duck, tsDescriptor);
+                },
+                [&](const MmtTlv::MhContentDescriptor& mmtDescriptor) {
+                    ts::ContentDescriptor tsDescriptor;
+                    for (const auto& item : mmtDescriptor.entries) {
+                        ts::ContentDescriptor::Entry entry;
+                        entry.content_nibble_level_1 = item.contentNibbleLevel1;
+                        entry.content_nibble_level_2 = item.contentNibbleLevel2;
+                        entry.user_nibble_1 = item.userNibble1;
+                        entry.user_nibble_2 = item.userNibble2;
+                        tsDescriptor.entries.push_back(entry);
+                    }
+                    tsEvent.descs.add(duck, tsDescriptor);
+                },
+                [&](const MmtTlv::MhLinkageDescriptor& mmtDescriptor) {
+                    ts::LinkageDescriptor tsDescriptor(mmtDescriptor.tlvStreamId, mmtDescriptor.originalNetworkId,
+                        mmtDescriptor.serviceId, mmtDescriptor.linkageType);
+                    tsEvent.descs.add(duck, tsDescriptor);
+                },
+                [&](const MmtTlv::MhParentalRatingDescriptor& mmtDescriptor) {
+                    ts::ParentalRatingDescriptor tsDescriptor;
+                    for (const auto& entry : mmtDescriptor.entries) {
+                        tsDescriptor.entries.push_back(ts::ParentalRatingDescriptor::Entry(ts::UString::FromUTF8(entry.countryCode), entry.rating));
+                    }
+                    tsEvent.descs.add(duck, tsDescriptor);
+                },
+                [&](const MmtTlv::MhSeriesDescriptor& mmtDescriptor) {
+                    ts::SeriesDescriptor tsDescriptor;
+                    tsDescriptor.series_id = mmtDescriptor.seriesId;
+                    tsDescriptor.repeat_label = mmtDescriptor.repeatLabel;
+                    tsDescriptor.program_pattern = mmtDescriptor.programPattern;
+                    if (mmtDescriptor.expireDateValidFlag) {
+                        struct tm tm;
+                        EITDecodeMjd(mmtDescriptor.expireDate, &tm.tm_year, &tm.tm_mon, &tm.tm_mday);
+                        tsDescriptor.expire_date = ts::Time(tm.tm_year, tm.tm_mon, tm.tm_mday, 0, 0);
+                    }
+                    tsDescriptor.episode_number = mmtDescriptor.episodeNumber;
+                    tsDescriptor.last_episode_number = mmtDescriptor.lastEpisodeNumber;
+                    tsDescriptor.series_name = aribString(mmtDescriptor.seriesNameChar);
+                    tsEvent.descs.add(duck, tsDescriptor);
+                },
+                [&](const MmtTlv::ContentCopyControlDescriptor& mmtDescriptor) {
+                    ts::DigitalCopyControlDescriptor tsDescriptor;
+                    tsDescriptor.digital_recording_control_data = mmtDescriptor.digitalRecordingControlData;
+                    if (mmtDescriptor.maximumBitrateFlag) {
+                        tsDescriptor.maximum_bitrate = mmtDescriptor.maximumBitrate;
+                    }
+                    tsEvent.descs.add(duck, tsDescriptor);
+                },
+            });
+
+            tsEit.events[tsEvent.event_id] = tsEvent;
+        }
+
+        tsEit.last_table_id = mhEit.isPf() ? 0x4E : mhEit.lastTableId - 0x8C + 0x50;
+
+        ts::BinaryTable table;
+        tsEit.serialize(duck, table);
+
+        // tsduck spreads the schedule over 3-hour segments, the events of the fixtures share one
+        ts::SectionPtr section;
+        for (size_t i = 0; i < table.sectionCount() && !section; i++) {
+            if (table.sectionAt(i)->payloadSize() > 6 || mhEit.events.empty()) {
+                section = table.sectionAt(i);
+            }
+        }
+        if (!section) {
+            return {};
+        }
+
+        section->setTableId(SiConverter::convertEitTableId(mhEit));
+        section->setSectionNumber(mhEit.sectionNumber);
+        section->setLastSectionNumber(mhEit.lastSectionNumber);
+        section->setUInt8(4, mhEit.segmentLastSectionNumber);
+        section->setUInt8(5, mhEit.isPf() ? 0x4E : mhEit.lastTableId - 0x8C + 0x50);
+        return ts::ByteBlock(section->content(), section->size());
+    }
+
+    ts::ByteBlock sdtReference(ts::DuckContext& duck, const MmtTlv::MhSdt& mhSdt)
+    {
+        ts::SDT tsSdt(true, mhSdt.versionNumber, mhSdt.currentNextIndicator, mhSdt.tlvStreamId, mhSdt.originalNetworkId);
+        for (const auto& service : mhSdt.services) {
+            ts::SDT::ServiceEntry tsService(&tsSdt);
+            tsService.EITs_present = service.eitScheduleFlag;
+            tsService.EITpf_present = service.eitPresentFollowingFlag;
+            tsService.running_status = convertRunningStatus(service.runningStatus);
+            tsService.CA_controlled = service.freeCaMode;
+
+            service.descriptors.visit(MmtTlv::Overloaded{
+                [&](const MmtTlv::MhServiceDescriptor& mmtDescriptor) {
+                    const ts::ByteBlock serviceName(ts::ARIBCharset::B24.encoded(
+                        ts::UString::FromUTF8(mmtDescriptor.serviceName.data(), mmtDescriptor.serviceName.size())));
+                    ts::ServiceDescriptor tsDescriptor(1, aribString(mmtDescriptor.serviceProviderName), rawString(serviceName));
+                    tsService.descs.add(duck, tsDescriptor);
+                },
+                [&](const MmtTlv::MhLogoTransmissionDescriptor& mmtDescriptor) {
+                    ts::LogoTransmissionDescriptor tsDescriptor;
+                    tsDescriptor.logo_transmission_type = mmtDescriptor.logoTransmissionType;
+                    if (mmtDescriptor.logoTransmissionType == 0x01) {
+                        tsDescriptor.logo_id = mmtDescriptor.logoId;
+                        tsDescriptor.logo_version = mmtDescriptor.logoVersion;
+                        tsDescriptor.download_data_id = mmtDescriptor.downloadDataId;
+                    }
+                    else if (mmtDescriptor.logoTransmissionType == 0x02) {
+                        tsDescriptor.logo_id = mmtDescriptor.logoId;
+                    }
+                    else if (mmtDescriptor.logoTransmissionType == 0x03) {
+                        tsDescriptor.logo_char = aribString(mmtDescriptor.logoChar);
+                    }
+                    tsService.descs.add(duck, tsDescriptor);
+                },
+            });
+
+            tsSdt.services[service.serviceId] = tsService;
+        }
+
+        ts::BinaryTable table;
+        tsSdt.serialize(duck, table);
+        if (table.sectionCount() == 0) {
+            return {};
+        }
+
+        const ts::SectionPtr& section = table.sectionAt(0);
+        section->setSectionNumber(mhSdt.sectionNumber);
+        section->setLastSectionNumber(mhSdt.lastSectionNumber);
+        return ts::ByteBlock(section->content(), section->size());
+    }
+
+    // Section carried by the TS packets of SiConverter
+    ts::ByteBlock depacketize(const std::vector<uint8_t>& packets)
+    {
+        ts::ByteBlock payload;
+        for (size_t offset = 0; offset + 188 <= packets.size(); offset += 188) {
+            const uint8_t* packet = packets.data() + offset;
+            size_t start = 4;
+            if (packet[1] & 0x40) {
+                start += 1 + packet[4]; // pointer_field
+            }
+            payload.append(packet + start, 188 - start);
+        }
+
+        if (payload.size() < 3) {
+            return {};
+        }
+        payload.resize(std::min(payload.size(), size_t{ 3 } + ((payload[1] & 0x0F) << 8 | payload[2])));
+        return payload;
+    }
+
+    void compare(const char* name, const ts::ByteBlock& actual, const ts::ByteBlock& expected)
+    {
+        if (actual == expected && !expected.empty()) {
+            return;
+        }
+
+        std::printf("%s: %zu bytes, expected %zu bytes\n", name, actual.size(), expected.size());
+        for (size_t i = 0; i < std::max(actual.size(), expected.size()); i++) {
+            const int a = i < actual.size() ? actual[i] : -1;
+            const int e = i < expected.size() ? expected[i] : -1;
+            if (a != e) {
+                std::printf("  first difference at byte %zu: %02X, expected %02X\n", i, a & 0xFF, e & 0xFF);
+                break;
+            }
+        }
+        failures++;
+    }
+
+    template <typename Table>
+    bool unpack(Table& table, const std::vector<uint8_t>& section)
+    {
+        MmtTlv::Common::ReadStream stream(section);
+        return table.unpack(stream);
+    }
+
+    void testEit(const char* name, const std::vector<uint8_t>& section)
+    {
+        MmtTlv::MhEit mhEit;
+        if (!unpack(mhEit, section)) {
+            std::printf("%s: fixture not unpacked\n", name);
+            failures++;
+            return;
+        }
+
+        ts::DuckContext duck;
+        duck.setDefaultCharsetOut(&rawCharset);
+        SiConverter converter;
+        compare(name, depacketize(converter.convert(mhEit)), eitReference(duck, mhEit));
+    }
+
+    void testSdt(const char* name, const std::vector<uint8_t>& section)
+    {
+        MmtTlv::MhSdt mhSdt;
+        if (!unpack(mhSdt, section)) {
+            std::printf("%s: fixture not unpacked\n", name);
+            failures++;
+            return;
+        }
+
+        ts::DuckContext duck;
+        duck.setDefaultCharsetOut(&rawCharset);
+        SiConverter converter;
+        compare(name, depacketize(converter.convert(mhSdt)), sdtReference(duck, mhSdt));
+    }
+
+    // Checks a fixture whose converted section would exceed 4096 bytes: the section keeps the entries
+    // before the first one that does not fit, and the rest are counted as dropped.
+    template <typename Table, typename Fixture, typename Section, typename Reference>
+    void testOverflow(const char* name, const std::vector<Fixture>& entries, Section section, Reference reference,
+        uint64_t SiConversionStatistics::* droppedCount)
+    {
+        const std::vector<uint8_t> fullSection = section(entries);
+        Table table;
+        if (!unpack(table, fullSection)) {
+            std::printf("%s: fixture not unpacked\n", name);
+            failures++;
+            return;
+        }
+
+        SiConverter converter;
+        const uint64_t droppedBefore = SiConverter::getStatistics().*droppedCount;
+        const ts::ByteBlock actual = depacketize(converter.convert(table));
+        const uint64_t dropped = SiConverter::getStatistics().*droppedCount - droppedBefore;
+        if (dropped == 0 || dropped >= entries.size() || actual.size() > 4096) {
+            std::printf("%s: %zu bytes, %llu of %zu entries dropped\n", name, actual.size(),
+                static_cast<unsigned long long>(dropped), entries.size());
+            failures++;
+            return;
+        }
+
+        const size_t kept = entries.size() - static_cast<size_t>(dropped);
+        const std::vector<uint8_t> keptSection = section(std::vector<Fixture>(entries.begin(), entries.begin() + kept));
+        Table keptTable;
+        if (!unpack(keptTable, keptSection)) {
+            std::printf("%s: kept fixture not unpacked\n", name);
+            failures++;
+            return;
+        }
+
+        ts::DuckContext duck;
+        duck.setDefaultCharsetOut(&rawCharset);
+        compare(name, actual, reference(duck, keptTable));
+
+        // One more entry would not have fitted
+        const std::vector<uint8_t> nextSection = section(std::vector<Fixture>(entries.begin(), entries.begin() + kept + 1));
+        Table nextTable;
+        if (!unpack(nextTable, nextSection)) {
+            std::printf("%s: next fixture not unpacked\n", name);
+            failures++;
+            return;
+        }
+
+        const uint64_t nextDroppedBefore = SiConverter::getStatistics().*droppedCount;
+        converter.convert(nextTable);
+        if (SiConverter::getStatistics().*droppedCount - nextDroppedBefore != 1) {
+            std::printf("%s: %zu entries kept, but %zu entries fit\n", name, kept, kept + 1);
+            failures++;
+        }
+    }
+
+    // 2026-10-18 (MJD 61331) at the given BCD time
+    constexpr uint64_t startTime(uint32_t bcdTime)
+    {
+        return uint64_t{ 61331 } << 24 | bcdTime;
+    }
+
+    constexpr uint32_t toBcd(uint32_t value)
+    {
+        return value / 10 << 4 | value % 10;
+    }
+
+    // Gaiji between alphanumerics take more bytes in ARIB STD-B24 than in UTF-8, so that an MMT
+    // section within its 4096 bytes converts to a larger TS section
+    std::string growingText(size_t count)
+    {
+        std::string text;
+        for (size_t i = 0; i < count; i++) {
+            text += "\u2460" "a";
+        }
+        return text;
+    }
+
+}
+
+int main()
+{
+    testEit("MH-EIT schedule", mhEitSection(MmtTlv::MmtTableId::MhEitS_1, MmtTlv::MmtTableId::MhEitS_2, {
+        { 0x1001, startTime(0x120000), 0x003000, 4, false, {
+            shortEvent("ニュース", "国内外のニュースをお伝えします。"),
+            extendedEvent({ { "出演者", "山田太郎\r\n佐藤花子" }, { "番組内容", "今日の天気と交通情報" } }, "ABC 123"),
+            audioComponent(true, "日本語\r\n英語"),
+            videoComponent("映像"),
+            content(),
+            parentalRating(),
+            series(true, "シリーズ"),
+            contentCopyControl(),
+            linkage(),
+            descriptor(0x8011, { 0x00, 0x10 }), // MH-stream identification, not converted
+        } },
+        { 0x1002, startTime(0x123000), 0x001500, 1, true, {
+            shortEvent("天気予報", ""),
+        } },
+        { 0x1003, startTime(0x124500), 0x011500, 3, false, {} },
+    }));
+
+    testEit("MH-EIT present/following", mhEitSection(MmtTlv::MmtTableId::MhEitPf, MmtTlv::MmtTableId::MhEitPf, {
+        { 0x2001, startTime(0x190000), 0x005400, 4, false, {
+            shortEvent("映画", "4K UHD"),
+            audioComponent(false, ""),
+            videoComponent(""),
+            series(false, ""),
+        } },
+    }));
+
+    testSdt("MH-SDT", mhSdtSection({
+        { 0x0065, true, 4, false, {
+            service("ＮＨＫ", "ＮＨＫ ＢＳプレミアム４Ｋ"),
+            logoTransmission(0x01),
+        } },
+        { 0x0066, false, 1, true, {
+            service("", "Test"),
+            logoTransmission(0x02),
+            logoTransmission(0x03),
+        } },
+    }));
+
+    // 19 events of 210 bytes fill the MH-EIT; the converted events take 259 bytes each
+    std::vector<EventFixture> events;
+    for (uint32_t i = 0; i < 19; i++) {
+        events.push_back({ static_cast<uint16_t>(0x3001 + i), startTime(0x120000 | toBcd(i) << 8), 0x000100, 4, false, {
+            shortEvent("", growingText(47)),
+        } });
+    }
+    testOverflow<MmtTlv::MhEit>("MH-EIT overflow", events, [](const std::vector<EventFixture>& entries) {
+        return mhEitSection(MmtTlv::MmtTableId::MhEitS_1, MmtTlv::MmtTableId::MhEitS_1, entries);
+    }, eitReference, &SiConversionStatistics::droppedEventCount);
+
+    // 20 services of 199 bytes fill the MH-SDT; the converted services take 250 bytes each
+    std::vector<ServiceFixture> services;
+    for (uint16_t i = 0; i < 20; i++) {
+        services.push_back({ static_cast<uint16_t>(0x0100 + i), true, 4, false, {
+            service(growingText(47), ""),
+        } });
+    }
+    testOverflow<MmtTlv::MhSdt>("MH-SDT overflow", services, mhSdtSection, sdtReference,
+        &SiConversionStatistics::droppedServiceCount);
+
+    if (failures) {
+        std::printf("siConverterTest: %d failures\n", failures);
+        return 1;
+    }
+
+    std::printf("siConverterTest: passed\n");
+    return 0;
+}